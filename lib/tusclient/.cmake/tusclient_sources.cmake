@@ -1,19 +1,42 @@
 set(TUSCLIENT_HEADERS
+    include/tusclient/PartialUpload.h
     include/tusclient/TusClient.h
     include/tusclient/TusStatus.h
+    include/tusclient/UploadManager.h
+    include/tusclient/UploadPriority.h
     include/tusclient/cache/CacheRepository.h
     include/tusclient/cache/ICacheManager.h
     include/tusclient/cache/TUSFile.h
+    include/tusclient/chunk/AdaptiveChunkSizer.h
+    include/tusclient/chunk/ChunkBodySource.h
+    include/tusclient/chunk/ChunkScheduler.h
+    include/tusclient/chunk/ChunkWindow.h
     include/tusclient/chunk/FileChunker.h
     include/tusclient/chunk/IFileChunker.h
+    include/tusclient/chunk/IoUringFileChunker.h
+    include/tusclient/chunk/MappedFileChunker.h
+    include/tusclient/chunk/MemoryChunker.h
+    include/tusclient/chunk/SourceFileChunker.h
+    include/tusclient/chunk/StreamChunker.h
     include/tusclient/chunk/TUSChunk.h
+    include/tusclient/chunk/utility/BufferPool.h
     include/tusclient/chunk/utility/ChunkUtility.h
+    include/tusclient/chunk/utility/IoUringReader.h
+    include/tusclient/chunk/utility/MappedFile.h
+    include/tusclient/chunk/utility/SourceFile.h
     include/tusclient/config.h
     include/tusclient/exceptions/TUSException.h
+    include/tusclient/http/CurlHandlePool.h
+    include/tusclient/http/HeaderList.h
     include/tusclient/http/HttpClient.h
     include/tusclient/http/IHttpClient.h
+    include/tusclient/http/Progress.h
+    include/tusclient/http/RateLimiter.h
     include/tusclient/http/Request.h
+    include/tusclient/http/RequestBody.h
     include/tusclient/http/RequestTask.h
+    include/tusclient/http/Response.h
+    include/tusclient/http/TransportContext.h
     include/tusclient/libtusclient.h
     include/tusclient/logging/GLoggingService.h
     include/tusclient/logging/ILogger.h
@@ -23,28 +46,75 @@ set(TUSCLIENT_HEADERS
 )
 
 set(TUSCLIENT_SOURCES
+    src/tusclient/PartialUpload.cpp
     src/tusclient/TusClient.cpp
+    src/tusclient/UploadManager.cpp
     src/tusclient/cache/CacheRepository.cpp
     src/tusclient/cache/TUSFile.cpp
+    src/tusclient/chunk/AdaptiveChunkSizer.cpp
+    src/tusclient/chunk/ChunkBodySource.cpp
+    src/tusclient/chunk/ChunkScheduler.cpp
+    src/tusclient/chunk/ChunkWindow.cpp
     src/tusclient/chunk/FileChunker.cpp
+    src/tusclient/chunk/IoUringFileChunker.cpp
+    src/tusclient/chunk/MappedFileChunker.cpp
+    src/tusclient/chunk/MemoryChunker.cpp
+    src/tusclient/chunk/SourceFileChunker.cpp
+    src/tusclient/chunk/StreamChunker.cpp
     src/tusclient/chunk/TUSChunk.cpp
+    src/tusclient/chunk/utility/BufferPool.cpp
     src/tusclient/chunk/utility/ChunkUtility.cpp
+    src/tusclient/chunk/utility/IoUringReader.cpp
+    src/tusclient/chunk/utility/MappedFile.cpp
+    src/tusclient/chunk/utility/SourceFile.cpp
+    src/tusclient/http/CurlHandlePool.cpp
+    src/tusclient/http/HeaderList.cpp
     src/tusclient/http/HttpClient.cpp
+    src/tusclient/http/Progress.cpp
+    src/tusclient/http/RateLimiter.cpp
     src/tusclient/http/Request.cpp
+    src/tusclient/http/RequestBody.cpp
     src/tusclient/http/RequestTask.cpp
+    src/tusclient/http/Response.cpp
+    src/tusclient/http/TransportContext.cpp
     src/tusclient/libtusclient.cpp
     src/tusclient/logging/GLoggingService.cpp
     src/tusclient/verifiers/Md5Verifier.cpp
 )
 
 set(TUSCLIENT_TEST_SOURCES
+    AdaptiveChunkSizerTest.cpp
+    BufferPoolTest.cpp
+    ChunkSchedulerTest.cpp
+    ChunkSourceTest.cpp
+    ChunkWindowTest.cpp
     FileChunkerTest.cpp
+    IoUringFileChunkerTest.cpp
+    LargeUploadTest.cpp
+    MappedFileChunkerTest.cpp
+    MemoryChunkerTest.cpp
+    PartialUploadTest.cpp
+    SourceFileChunkerTest.cpp
+    StreamChunkerTest.cpp
     TusClientTest.cpp
+    UploadManagerTest.cpp
+    http/CurlHandlePoolTest.cpp
     http/HttpClientTest.cpp
+    http/ProgressTest.cpp
+    http/RateLimiterTest.cpp
+    http/RequestBodyTest.cpp
+    http/RequestTest.cpp
+    http/ResponseTest.cpp
+    http/TransportContextTest.cpp
     main.cpp
     repository/CacheRepositoryTest.cpp
     verifiers/FileVerifiersTest.cpp
 )
 
+set(TUSCLIENT_BENCHMARK_SOURCES
+    ChunkSourceBenchmark.cpp
+    ResponseBenchmark.cpp
+)
+
 set(TUSCLIENT_RESOURCES
 )
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "chunk/FileChunker.h"
+#include "chunk/IFileChunker.h"
+#include "chunk/IoUringFileChunker.h"
+#include "chunk/MappedFileChunker.h"
+#include "chunk/SourceFileChunker.h"
+#include "chunk/TUSChunk.h"
+
+/**
+ * @brief Compare the chunk sources read by TusClient, every byte of a file is read as it would be sent
+ */
+namespace TUS::Benchmark {
+    using TUS::Chunk::FileChunker;
+    using TUS::Chunk::IFileChunker;
+    using TUS::Chunk::IoUringFileChunker;
+    using TUS::Chunk::MappedFileChunker;
+    using TUS::Chunk::SourceFileChunker;
+    using TUS::Chunk::TUSChunk;
+
+    constexpr size_t CHUNK_FILE_SIZE = 64 * 1024 * 1024;
+
+    const std::filesystem::path &chunkSourceFile() {
+        static const std::filesystem::path filePath = [] {
+            auto filePath = std::filesystem::temp_directory_path() / "tusclient_chunk_source_benchmark.bin";
+            std::vector<char> content(CHUNK_FILE_SIZE);
+            std::iota(content.begin(), content.end(), 0);
+            std::ofstream file(filePath, std::ios::binary);
+            file.write(content.data(), static_cast<std::streamsize>(content.size()));
+            return filePath;
+        }();
+        return filePath;
+    }
+
+    /**
+     * @brief Read every chunk as the window does, one at a time in buffers recycled by the pool, and touch its bytes
+     */
+    void readAllChunks(benchmark::State &state, IFileChunker<TUSChunk> &chunker) {
+        for (auto _: state) {
+            const int chunkCount = chunker.chunkFile();
+            uint64_t sum = 0;
+            for (int i = 0; i < chunkCount; ++i) {
+                const TUSChunk chunk = chunker.getChunk(i);
+                const uint8_t *bytes = chunk.getBytes();
+                for (size_t j = 0; j < chunk.getChunkSize(); j += 64) {
+                    sum += bytes[j];
+                }
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        chunker.removeChunkFiles();
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * CHUNK_FILE_SIZE);
+    }
+
+    void BM_TemporaryFilesChunkSource(benchmark::State &state) {
+        FileChunker chunker("benchmark", "chunk-source", chunkSourceFile(), static_cast<int>(state.range(0)));
+        readAllChunks(state, chunker);
+    }
+
+    void BM_SourceFileChunkSource(benchmark::State &state) {
+        SourceFileChunker chunker(chunkSourceFile(), static_cast<int>(state.range(0)));
+        readAllChunks(state, chunker);
+    }
+
+    void BM_MemoryMappedChunkSource(benchmark::State &state) {
+        MappedFileChunker chunker(chunkSourceFile(), static_cast<int>(state.range(0)));
+        readAllChunks(state, chunker);
+    }
+
+    void BM_IoUringChunkSource(benchmark::State &state) {
+        IoUringFileChunker chunker(chunkSourceFile(), static_cast<int>(state.range(0)));
+        readAllChunks(state, chunker);
+    }
+
+    void BM_IoUringDirectChunkSource(benchmark::State &state) {
+        IoUringFileChunker chunker(chunkSourceFile(), static_cast<int>(state.range(0)), true);
+        readAllChunks(state, chunker);
+    }
+
+    /**
+     * @brief Take every chunk of a loaded file from getChunks(), the chunks are handles and their bytes are not copied
+     */
+    void BM_LoadedChunks(benchmark::State &state) {
+        FileChunker chunker("benchmark", "loaded-chunks", chunkSourceFile(), static_cast<int>(state.range(0)));
+        chunker.chunkFile();
+        chunker.loadChunks();
+        for (auto _: state) {
+            for (int i = 0; i < chunker.getChunkNumber(); ++i) {
+                benchmark::DoNotOptimize(chunker.getChunks()[i].getBytes());
+            }
+        }
+        chunker.removeChunkFiles();
+    }
+
+    // wall time, io_uring reads on its own thread
+    BENCHMARK(BM_TemporaryFilesChunkSource)->Arg(1024 * 1024)->Arg(8 * 1024 * 1024)->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK(BM_SourceFileChunkSource)->Arg(1024 * 1024)->Arg(8 * 1024 * 1024)->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK(BM_MemoryMappedChunkSource)->Arg(1024 * 1024)->Arg(8 * 1024 * 1024)->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK(BM_IoUringChunkSource)->Arg(1024 * 1024)->Arg(8 * 1024 * 1024)->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK(BM_IoUringDirectChunkSource)->Arg(1024 * 1024)->Arg(8 * 1024 * 1024)->Unit(benchmark::kMillisecond)
+            ->UseRealTime();
+    BENCHMARK(BM_LoadedChunks)->Arg(1024 * 1024)->Unit(benchmark::kMicrosecond);
+} // namespace TUS::Benchmark
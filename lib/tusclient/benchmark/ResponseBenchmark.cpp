@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "http/Response.h"
+
+/**
+ * @brief Compare the Response header parser with the header parsing it replaced in TusClient
+ */
+namespace TUS::Benchmark {
+    using TUS::Http::Response;
+
+    const std::string PATCH_HEADERS =
+            "HTTP/1.1 204 No Content\r\n"
+            "Cache-Control: no-store\r\n"
+            "Tus-Resumable: 1.0.0\r\n"
+            "Upload-Offset: 5368709120\r\n"
+            "X-Content-Type-Options: nosniff\r\n"
+            "Date: Tue, 01 Oct 2024 10:00:00 GMT\r\n"
+            "\r\n";
+
+    const std::string OPTIONS_HEADERS =
+            "HTTP/1.1 204 No Content\r\n"
+            "Tus-Extension: creation,creation-with-upload,termination,concatenation,creation-defer-length\r\n"
+            "Tus-Max-Size: 107374182400\r\n"
+            "Tus-Resumable: 1.0.0\r\n"
+            "Tus-Version: 1.0.0\r\n"
+            "Date: Tue, 01 Oct 2024 10:00:00 GMT\r\n"
+            "\r\n";
+
+    /**
+     * @brief The header lookup used by TusClient before Response, kept as the baseline
+     */
+    std::string legacyExtractHeaderValue(const std::string &header, const std::string &key) {
+        const auto toLower = [](const std::string &s) {
+            std::string result = s;
+            std::ranges::transform(result, result.begin(),
+                                   [](unsigned char c) { return std::tolower(c); });
+            return result;
+        };
+
+        std::string keyLower = toLower(key);
+        size_t pos = 0;
+
+        while (pos < header.size()) {
+            size_t lineEnd = header.find("\r\n", pos);
+            if (lineEnd == std::string::npos)
+                lineEnd = header.size();
+
+            if (const size_t colonPos = header.find(':', pos); colonPos != std::string::npos && colonPos < lineEnd) {
+                std::string lineKey = header.substr(pos, colonPos - pos);
+                std::string lineValue = header.substr(colonPos + 1, lineEnd - colonPos - 1);
+
+                auto trim = [](std::string &str) {
+                    const char *whitespace = " \t";
+                    size_t start = str.find_first_not_of(whitespace);
+                    size_t end = str.find_last_not_of(whitespace);
+                    if (start == std::string::npos) {
+                        str.clear();
+                        return;
+                    }
+                    str = str.substr(start, end - start + 1);
+                };
+
+                trim(lineKey);
+                trim(lineValue);
+
+                if (toLower(lineKey) == keyLower)
+                    return lineValue;
+            }
+
+            pos = lineEnd + 2;
+        }
+
+        return "";
+    }
+
+    /**
+     * @brief The status code extraction of HttpClient before Response, kept as the baseline
+     */
+    int legacyGetHttpReturnCode(const std::string &header) {
+        size_t pos = header.find("HTTP/1.1 ");
+        if (pos != std::string::npos) {
+            std::istringstream iss(header.substr(pos + 9));
+            int status_code;
+            iss >> status_code;
+            return status_code;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Split the headers in the lines curl passes to the header callback
+     */
+    std::vector<std::string_view> splitLines(std::string_view headers) {
+        std::vector<std::string_view> lines;
+        while (!headers.empty()) {
+            const size_t lineEnd = headers.find('\n');
+            lines.push_back(headers.substr(0, lineEnd + 1));
+            headers.remove_prefix(lineEnd + 1);
+        }
+        return lines;
+    }
+
+    void BM_LegacyPatchResponse(benchmark::State &state) {
+        for (auto _: state) {
+            const int statusCode = legacyGetHttpReturnCode(PATCH_HEADERS);
+            const int64_t offset = std::stoll(legacyExtractHeaderValue(PATCH_HEADERS, "Upload-Offset"));
+            benchmark::DoNotOptimize(statusCode);
+            benchmark::DoNotOptimize(offset);
+        }
+    }
+
+    void BM_ResponsePatchResponse(benchmark::State &state) {
+        const std::vector<std::string_view> lines = splitLines(PATCH_HEADERS);
+        for (auto _: state) {
+            Response response;
+            for (const std::string_view line: lines) {
+                response.parseHeaderLine(line);
+            }
+            benchmark::DoNotOptimize(response.getStatusCode());
+            benchmark::DoNotOptimize(response.getUploadOffset());
+        }
+    }
+
+    void BM_LegacyOptionsResponse(benchmark::State &state) {
+        for (auto _: state) {
+            benchmark::DoNotOptimize(legacyExtractHeaderValue(OPTIONS_HEADERS, "Tus-Resumable"));
+            benchmark::DoNotOptimize(legacyExtractHeaderValue(OPTIONS_HEADERS, "Tus-Version"));
+            benchmark::DoNotOptimize(legacyExtractHeaderValue(OPTIONS_HEADERS, "Tus-Extension"));
+            benchmark::DoNotOptimize(legacyExtractHeaderValue(OPTIONS_HEADERS, "Tus-Max-Size"));
+        }
+    }
+
+    void BM_ResponseOptionsResponse(benchmark::State &state) {
+        const std::vector<std::string_view> lines = splitLines(OPTIONS_HEADERS);
+        for (auto _: state) {
+            Response response;
+            for (const std::string_view line: lines) {
+                response.parseHeaderLine(line);
+            }
+            benchmark::DoNotOptimize(response.getTusResumable());
+            benchmark::DoNotOptimize(response.getTusVersion());
+            benchmark::DoNotOptimize(response.supportsExtension("creation-with-upload"));
+            benchmark::DoNotOptimize(response.getTusMaxSize());
+        }
+    }
+
+    BENCHMARK(BM_LegacyPatchResponse);
+    BENCHMARK(BM_ResponsePatchResponse);
+    BENCHMARK(BM_LegacyOptionsResponse);
+    BENCHMARK(BM_ResponseOptionsResponse);
+} // namespace TUS::Benchmark
+
+BENCHMARK_MAIN();
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#ifndef INCLUDE_PARTIALUPLOAD_H_
+#define INCLUDE_PARTIALUPLOAD_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "TusStatus.h"
+#include "libtusclient.h"
+
+using std::string;
+
+namespace TUS {
+    namespace Chunk {
+        template<typename T>
+        class IFileChunker;
+        class ChunkWindow;
+        class TUSChunk;
+    } // namespace Chunk
+
+    namespace Http {
+        class IHttpClient;
+        class Progress;
+        class RateLimiter;
+        class Response;
+    } // namespace Http
+
+    /**
+     * @brief A byte range of a file uploaded as a partial upload of the Concatenation extension
+     * (Upload-Concat: partial). The ranges of a file are uploaded in parallel, each one a step of a
+     * Chunk::ChunkScheduler, and joined by a final upload once they are all stored, see
+     * TusClient::setParallelUploads().
+     * The offsets of the requests are relative to the start of the range.
+     */
+    class EXPORT_LIBTUSCLIENT PartialUpload {
+    public:
+        /**
+         * @param httpClient The http client of the upload, it is shared by the partial uploads
+         * @param url The url of the tus endpoint
+         * @param tag The tag of the requests, the one of the client aborts them on pause() and cancel()
+         * @param chunker The chunker of the file, it must outlive the partial upload
+         * @param start The offset of the range in the file, at the start of a chunk
+         * @param length The length of the range
+         * @param memoryLimit The bytes of the chunks of the range kept in memory
+         */
+        PartialUpload(std::shared_ptr<Http::IHttpClient> httpClient, string url, string tag,
+                      const Chunk::IFileChunker<Chunk::TUSChunk> &chunker, uint64_t start, uint64_t length,
+                      size_t memoryLimit);
+
+        ~PartialUpload();
+
+        PartialUpload(const PartialUpload &) = delete;
+
+        PartialUpload &operator=(const PartialUpload &) = delete;
+
+        /**
+         * @brief Create the partial upload on the server.
+         * @throws TUSException if the server refuses it
+         */
+        void create();
+
+        /**
+         * @brief Continue a partial upload created before, its offset is asked to the server.
+         * @param location The url of the partial upload
+         * @return false if the server does not know it anymore, it must be created again
+         */
+        bool resume(const string &location);
+
+        /**
+         * @brief Send the next PATCH of the range, from the offset of the server. The requests of a range must be
+         * sent one after the other, but each one can be sent from a different thread.
+         * @param status The status of the upload, nothing is sent unless it is UPLOADING
+         * @return true while the range has bytes to send and the status is UPLOADING
+         * @throws TUSException if the request fails while the status is UPLOADING
+         */
+        bool uploadNextChunk(const std::atomic<TusStatus> &status);
+
+        /**
+         * @brief Send the rest of the range, it returns when the range is stored or the status is not UPLOADING.
+         * @param status The status of the upload, pause() and cancel() stop the range after its current request
+         * @return true if the whole range is stored
+         * @throws TUSException if a request fails while the status is UPLOADING
+         */
+        bool upload(const std::atomic<TusStatus> &status);
+
+        /**
+         * @brief Delete the partial upload from the server.
+         */
+        void cancel();
+
+        [[nodiscard]] uint64_t getStart() const;
+
+        [[nodiscard]] uint64_t getLength() const;
+
+        /**
+         * @brief Get the bytes of the range stored by the server.
+         */
+        [[nodiscard]] uint64_t getOffset() const;
+
+        /**
+         * @brief Get the bytes of the current request sent but not confirmed yet.
+         */
+        [[nodiscard]] uint64_t getBytesInFlight() const;
+
+        [[nodiscard]] double getUploadSpeed() const;
+
+        /**
+         * @brief Get the url of the partial upload, empty before create() or resume().
+         */
+        [[nodiscard]] string getLocation() const;
+
+        /**
+         * @brief Set the bucket the bytes of the range are taken from, the one of the client uploading the file
+         */
+        void setRateLimiter(std::shared_ptr<Http::RateLimiter> rateLimiter);
+
+    private:
+        void getUploadInfo();
+
+        void handleUploadConflict(const Http::Response &response);
+
+        static constexpr int MAX_CONFLICTS = 3;
+
+        std::shared_ptr<Http::IHttpClient> m_httpClient;
+        const string m_url;
+        const string m_tag;
+        const Chunk::IFileChunker<Chunk::TUSChunk> &m_chunker;
+        const uint64_t m_start;
+        const uint64_t m_length;
+        const size_t m_memoryLimit;
+
+        string m_location;
+        std::atomic<uint64_t> m_offset{0};
+        int m_conflicts = 0;
+        std::shared_ptr<Http::Progress> m_progress; /* updated by the http client while a request is sent */
+        std::shared_ptr<Http::RateLimiter> m_rateLimiter;
+        std::unique_ptr<Chunk::ChunkWindow> m_chunkWindow; /* the chunks of the range, open while it is uploaded */
+    };
+} // namespace TUS
+
+#endif // INCLUDE_PARTIALUPLOAD_H_
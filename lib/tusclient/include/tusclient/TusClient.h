@@ -9,11 +9,18 @@
 
 #include <atomic>
 #include <boost/uuid/uuid.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <vector>
 
 #include "TusStatus.h"
 #include "libtusclient.h"
@@ -32,6 +39,8 @@ using std::filesystem::path;
  * progress and status.
  */
 namespace TUS {
+    class PartialUpload;
+
     namespace Repository {
         template<typename T>
         class IRepository;
@@ -43,11 +52,22 @@ namespace TUS {
     namespace Chunk {
         template<typename T>
         class IFileChunker;
+        class AdaptiveChunkSizer;
+        class ChunkWindow;
         class TUSChunk;
+        enum class ChunkSourceType;
     } // namespace Chunk
 
     namespace Http {
+        class HeaderList;
         class IHttpClient;
+        class Progress;
+        class RateLimiter;
+        class Request;
+        struct RequestBody;
+        class Response;
+        class TransportContext;
+        enum class HttpMethod;
     } // namespace Http
 
     /*
@@ -98,8 +118,8 @@ namespace TUS {
      */
     class EXPORT_LIBTUSCLIENT TusClient : public ITusClient {
     private:
-        using OnSuccessCallback = std::function<void(std::string, std::string)>;
-        using OnErrorCallback = std::function<void(std::string, std::string)>;
+        using OnSuccessCallback = std::function<void(const Http::Response &)>;
+        using OnErrorCallback = std::function<void(const Http::Response &)>;
         string m_url;
         path m_filePath;
         std::atomic<TusStatus> m_status;
@@ -107,24 +127,81 @@ namespace TUS {
         int m_chunkNumber = 0;
         int m_uploadedChunks = 0;
         string m_tusLocation;
-        int m_uploadOffset = 0;
-        size_t m_uploadLength = 0;
+        uint64_t m_uploadOffset = 0;
+        uint64_t m_uploadLength = 0;
+        bool m_uploadLengthDeferred = false; /* the server does not know the length, it is sent with the last bytes */
         std::chrono::milliseconds m_requestTimeout = std::chrono::milliseconds(
             0); /*This timeout is the time waited between one requests, it is in ms,
                    and it can be changed by the user*/
 
-        std::atomic<float> m_progress{0};
-        std::unique_ptr<Http::IHttpClient> m_httpClient;
+        std::atomic<float> m_progress{0}; /* percentage confirmed by the server */
+        std::atomic<uint64_t> m_progressLength{0}; /* size of the upload, used to add the bytes in flight */
+        std::atomic<uint64_t> m_chunkOffset{0}; /* offset of the chunk being sent */
+        std::atomic<int64_t> m_uploadExpires{0}; /* Upload-Expires of the server in seconds since epoch, 0 if unknown */
+        std::shared_ptr<Http::Progress> m_transferProgress; /* updated by the http client while a chunk is sent */
+        std::shared_ptr<Http::RateLimiter> m_rateLimiter; /* the bucket of the client, under the one of its host */
+        std::shared_ptr<Http::IHttpClient> m_httpClient;
         std::shared_ptr<Cache::TUSFile> m_tusFile;
-        std::unique_ptr<Repository::IRepository<Cache::TUSFile> > m_cacheManager;
+        std::shared_ptr<Repository::IRepository<Cache::TUSFile> > m_cacheManager;
         std::unique_ptr<Chunk::IFileChunker<Chunk::TUSChunk> > m_fileChunker;
+        Chunk::ChunkSourceType m_chunkSourceType;
+        int m_requestedChunkSize = 0; /* chunk size passed to the constructor, 0 to choose it from the file size */
+        std::unique_ptr<Chunk::ChunkWindow> m_chunkWindow; /* chunks in memory, it reads from m_fileChunker */
+        size_t m_chunkMemoryLimit = 0;
+        std::unique_ptr<Chunk::AdaptiveChunkSizer> m_chunkSizer; /* sizes the requests, null for fixed chunks */
+        size_t m_parallelUploads = 1; /* partial uploads of a parallel upload, 1 uploads the file sequentially */
+        std::vector<std::unique_ptr<PartialUpload> > m_partials; /* the ranges of the parallel upload in progress */
+        mutable std::mutex m_partialsMutex; /* guards m_partials, the progress is read by other threads */
         std::unique_ptr<Logging::ILogger> m_logger;
-        int m_retry; // Number of retries for the upload
+        int m_retry = 0; // Number of retries for the upload
 
         std::string m_appName;
 
         void getUploadInfo();
 
+        /**
+         * @brief Check if the server lists the Creation With Upload extension, the answer is cached per url
+         */
+        [[nodiscard]] bool supportsCreationWithUpload() const;
+
+        /**
+         * @brief Check if the file is uploaded in parallel partial uploads: they are enabled, its length is known,
+         * it has more than one chunk and the server lists the Concatenation extension
+         */
+        [[nodiscard]] bool usesParallelUploads() const;
+
+        /**
+         * @brief Divide the file into ranges of whole chunks and create their partial uploads, the ranges saved in
+         * the cache by an interrupted upload of the file are resumed
+         */
+        void createPartials();
+
+        /**
+         * @brief Upload the ranges on a scheduler with a worker each, then join them with the final upload
+         */
+        bool uploadPartials();
+
+        /**
+         * @brief Get a range of the parallel upload in progress
+         * @throws std::out_of_range if there is no such range
+         */
+        [[nodiscard]] PartialUpload &getPartial(size_t index) const;
+
+        /**
+         * @brief Check if every range of the parallel upload in progress is stored by the server
+         */
+        [[nodiscard]] bool partialsStored() const;
+
+        /**
+         * @brief Create the final upload, the concatenation of the partial uploads
+         */
+        void concatenatePartials();
+
+        /**
+         * @brief Save the location and the offset of each partial upload in the cache
+         */
+        void savePartials();
+
         void createTusFile();
 
         boost::uuids::uuid m_uuid;
@@ -133,10 +210,73 @@ namespace TUS {
 
         bool uploadChunks();
 
-        void uploadChunk(int chunkNumber);
+        [[nodiscard]] bool hasPartials() const;
+
+        /**
+         * @brief Keep the Upload-Expires header of a response of the server, if it has one
+         */
+        void updateUploadExpires(const Http::Response &response);
+
+        /**
+         * @brief Send a PATCH starting at the offset of the server
+         */
+        void uploadChunk();
+
+        /**
+         * @brief Get the size of the request starting at an offset, the rest of the chunk or the size
+         * chosen by the adaptive chunk sizer. While the length of a stream is not known, a request ends
+         * with the chunk it starts in: the next bytes may not be produced yet.
+         */
+        [[nodiscard]] uint64_t getRequestSize(uint64_t offset);
+
+        /**
+         * @brief Check if the chunks are read from the file, the chunker of a memory region or of a stream is
+         * given to the client.
+         */
+        [[nodiscard]] bool readsFile() const;
+
+        /**
+         * @brief Get the size of the data to upload, ChunkWindow::UNKNOWN_SIZE for a stream.
+         */
+        [[nodiscard]] uint64_t getSourceSize() const;
+
+        /**
+         * @brief Create the body of a request from the chunks of the window, a part of a chunk is sent from
+         * its buffer, a body spanning several chunks is copied from them while it is sent
+         */
+        Http::RequestBody createChunkBody(uint64_t offset, uint64_t length);
+
+        /**
+         * @brief Keep the adaptive request size within the Tus-Max-Size of the server
+         */
+        void limitRequestSize();
 
         void initialize(int chunkSize);
 
+        /**
+         * @brief Update the record of the file with the one of the cache, if the file is in it
+         */
+        void loadCachedState();
+
+        /**
+         * @brief Create the file chunker of the selected chunk source
+         */
+        void createFileChunker();
+
+        /**
+         * @brief Divide the file into chunks and open the window the chunks are read through
+         * @return false if the file cannot be divided
+         */
+        bool prepareChunks();
+
+        /**
+         * @brief Create a request tagged with the identifier of this upload, so that pause() and
+         * cancel() abort only the requests of this client when the http client is shared
+         */
+        Http::Request createRequest(string url, string body, Http::HttpMethod method,
+                                    Http::HeaderList headers, OnSuccessCallback onSuccess,
+                                    OnErrorCallback onError = nullptr) const;
+
         /**
          * @brief Sanitize the url string
          * @return
@@ -149,6 +289,46 @@ namespace TUS {
 
         TusClient(string appName, string url, path filePath, Logging::LogLevel logLevel = Logging::LogLevel::_NONE_);
 
+        /**
+         * @brief Create a client that sends its requests through an existing http client.
+         * Many clients can share the same http client, their uploads are transferred concurrently
+         * when they run on different threads.
+         */
+        TusClient(string appName, string url, path filePath, std::shared_ptr<Http::IHttpClient> httpClient,
+                  int chunkSize = 0, Logging::LogLevel logLevel = Logging::LogLevel::_NONE_);
+
+        /**
+         * @brief Create a client with its own http client attached to a shared transport context.
+         * The clients attached to the same context share the DNS cache, the TLS sessions and the
+         * open connections.
+         */
+        TusClient(string appName, string url, path filePath, std::shared_ptr<Http::TransportContext> context,
+                  int chunkSize = 0, Logging::LogLevel logLevel = Logging::LogLevel::_NONE_);
+
+        /**
+         * @brief Create a client that uploads a stream of unknown length, e.g. a pipe, a socket or the output
+         * of a compressor, see Chunk::StreamChunker. The chunks are sent as they are read and the length is
+         * sent with the last one (Upload-Defer-Length), a stream shorter than a chunk is sent with its length.
+         * The stream is read once: the upload can be paused and resumed but not retried nor resumed by
+         * another process.
+         * @param name The name of the upload sent in its metadata, e.g. the name of the file produced
+         * @param reader Reads the next bytes of the stream, 0 at its end, see Chunk::StreamReader
+         * @param chunkSize The size of the chunks, 0 for Chunk::StreamChunker::DEFAULT_CHUNK_SIZE
+         */
+        TusClient(string appName, string url, string name, std::function<size_t(uint8_t *, size_t)> reader,
+                  int chunkSize = 0, Logging::LogLevel logLevel = Logging::LogLevel::_NONE_);
+
+        /**
+         * @brief Create a client that uploads a memory region of the caller, e.g. a payload produced by a
+         * service, see Chunk::MemoryChunker. The bytes are sent from the region without being copied nor
+         * written to a file, it must not change and must stay valid as long as the client.
+         * @param name The name of the upload sent in its metadata, e.g. the name of the file it would be written to
+         * @param data The bytes to upload
+         * @param chunkSize The size of the chunks, 0 to choose it from the size of the data
+         */
+        TusClient(string appName, string url, string name, std::span<const std::byte> data, int chunkSize = 0,
+                  Logging::LogLevel logLevel = Logging::LogLevel::_NONE_);
+
         ~TusClient() override;
 
         /**
@@ -156,6 +336,45 @@ namespace TUS {
          */
         bool upload() override;
 
+        /**
+         * @brief Create the upload on the server without sending the rest of the file, which is sent by
+         * uploadNextChunk(). upload() is start() followed by uploadNextChunk() until it returns false, a scheduler
+         * running many uploads on a pool of threads interleaves their chunks instead, see Chunk::ChunkScheduler.
+         * @return false if the upload cannot be created
+         */
+        bool start();
+
+        /**
+         * @brief Send the next PATCH of an upload created by start(), from the offset of the server. The requests of
+         * an upload must be sent one after the other, but each one can be sent from a different thread.
+         * The partial uploads of a parallel upload are sent one after the other, uploadNextPartialChunk() sends
+         * them concurrently.
+         * @return true while the upload has chunks to send, false once it is finished, paused, canceled or failed
+         */
+        bool uploadNextChunk();
+
+        /**
+         * @brief Get the number of partial uploads of the parallel upload created by start(), 0 if the file is
+         * uploaded sequentially.
+         */
+        [[nodiscard]] size_t getPartialUploads() const;
+
+        /**
+         * @brief Send the next PATCH of a partial upload of the parallel upload created by start(). The requests of
+         * a range must be sent one after the other, the ranges can be sent concurrently, e.g. each one as a step of
+         * a Chunk::ChunkScheduler. Once no range is sent anymore, finishPartials() joins them.
+         * @param index The range, below getPartialUploads()
+         * @return true while the range has bytes to send, false once it is stored, paused, canceled or failed
+         */
+        bool uploadNextPartialChunk(size_t index);
+
+        /**
+         * @brief Join the partial uploads with the final upload once every range is stored, the state of the ranges
+         * is saved in the cache otherwise, e.g. when the upload is paused. No range must be sent while it runs.
+         * @return false if a range or the final upload failed
+         */
+        bool finishPartials();
+
         /**
          * @brief Cancels the upload.
          */
@@ -166,6 +385,13 @@ namespace TUS {
          */
         bool resume() override;
 
+        /**
+         * @brief Ask the server the offset of a paused upload without sending the rest of the file, which is sent by
+         * uploadNextChunk(). resume() is prepareResume() followed by the upload of the chunks.
+         * @return false if the partial uploads cannot be resumed
+         */
+        bool prepareResume();
+
         /**
          * @brief Stops the upload.
          */
@@ -174,10 +400,81 @@ namespace TUS {
         /**
          * @brief Returns the progress of the upload.
          *
+         * The bytes of the chunk being sent are counted while they are transferred.
+         *
          * @return The progress of the upload as a percentage.
          */
         float progress() const override;
 
+        /**
+         * @brief Returns the bytes of the current chunk that have been sent but not confirmed by the server yet.
+         */
+        [[nodiscard]] uint64_t getBytesInFlight() const;
+
+        /**
+         * @brief Returns the upload speed in bytes per second, measured while the chunks are sent.
+         */
+        [[nodiscard]] double getUploadSpeed() const;
+
+        /**
+         * @brief Returns the time the server may drop the upload, from the Upload-Expires header of its last response.
+         * @return Empty if the server did not send it, e.g. it does not support the expiration extension
+         */
+        [[nodiscard]] std::optional<std::chrono::system_clock::time_point> getUploadExpires() const;
+
+        /**
+         * @brief Select where the chunks are read from, it must be called before upload().
+         * By default they are read from the file being uploaded, ChunkSourceType::_TEMPORARY_FILES
+         * copies the file in the temporary directory first, ChunkSourceType::_MEMORY_MAPPED sends views of the
+         * file mapped in memory, ChunkSourceType::_IO_URING batches the reads of all the uploads of the process.
+         * The source of a client uploading a memory region or a stream cannot be changed.
+         */
+        void setChunkSourceType(Chunk::ChunkSourceType type);
+
+        [[nodiscard]] Chunk::ChunkSourceType getChunkSourceType() const;
+
+        /**
+         * @brief Set how many bytes of chunks the client keeps in memory, the chunk being sent and
+         * the next ones read ahead. One chunk is kept even if it is larger, by default 64 MB.
+         * It applies from the next upload() or resume().
+         */
+        void setChunkMemoryLimit(size_t bytes);
+
+        [[nodiscard]] size_t getChunkMemoryLimit() const;
+
+        /**
+         * @brief Adapt the size of each PATCH to the bandwidth and the round trip time measured on the last ones,
+         * see Chunk::AdaptiveChunkSizer. The chunk size of the client is the size of the first request.
+         * @param targetDuration The duration of a request the size converges to, 0 sends chunks of a fixed size
+         * @param maxRequestSize The largest body accepted by the server or the proxies in front of it, 0 for
+         * no limit, the Tus-Max-Size of the server is respected in any case
+         */
+        void setAdaptiveChunkSize(std::chrono::milliseconds targetDuration, uint64_t maxRequestSize = 0);
+
+        /**
+         * @brief Returns the size of the next PATCH, the chunk size when the size is not adaptive.
+         */
+        [[nodiscard]] uint64_t getNextRequestSize() const;
+
+        /**
+         * @brief Upload the file as several partial uploads sent in parallel and joined by the server once they are
+         * stored, with the Concatenation extension. Each partial upload is a range of whole chunks sent by a worker
+         * of its own, or by the shared workers of an UploadManager: over HTTP/1.1 each one has its own connection,
+         * over HTTP/2 they are multiplexed unless HttpClient::setMaxConcurrentStreams() limits the streams of a
+         * connection. The chunk memory limit is shared by the ranges. A file of one chunk, a stream, or a server without the Concatenation extension is uploaded
+         * sequentially. It must be called before upload().
+         * @param count The number of partial uploads, 1 or less uploads the file sequentially
+         */
+        void setParallelUploads(size_t count);
+
+        [[nodiscard]] size_t getParallelUploads() const;
+
+        /**
+         * @brief Keep the resume state in a cache shared with other clients, e.g. the ones of an UploadManager,
+         * instead of the cache of the client. It must be called before upload().
+         */
+        void setCacheRepository(std::shared_ptr<Repository::IRepository<Cache::TUSFile> > repository);
+
         /**
          * @brief Returns the status of the upload.
          *
@@ -212,6 +509,21 @@ namespace TUS {
 
         std::chrono::milliseconds getRequestTimeout() const override;
 
+        /**
+         * @brief Limit the upload speed of this client, the requests running use the new limit for their next bytes.
+         * The limits of the host and of the process, Http::RateLimiter::forHost() and Http::RateLimiter::global(),
+         * apply too.
+         * @param bytesPerSecond The limit, 0 for none
+         */
+        void setMaxUploadSpeed(uint64_t bytesPerSecond);
+
+        [[nodiscard]] uint64_t getMaxUploadSpeed() const;
+
+        /**
+         * @brief Get the bucket the requests of the client take their bytes from, its parent is the one of the host
+         */
+        [[nodiscard]] const std::shared_ptr<Http::RateLimiter> &getRateLimiter() const;
+
         /**
          * @brief set the authorization token, verify that token is valid,
          * if not update the token and pass the updated once
@@ -227,22 +539,22 @@ namespace TUS {
         /**
          * @brief Handles the process that occurs after a successful file upload.
          * This function may include actions such as cleanup, reporting progress, or triggering post-upload workflows.
-         * @ param header Details regarding the successful upload, such as the response header.
+         * @ param response The response of the PATCH request.
          */
     private:
-        void handleSuccessfulUpload(const string &header);
+        void handleSuccessfulUpload(const Http::Response &response);
 
         /**
          * @brief Handles conflicts that occur during an upload process in the TUS library.
-         * @param header Details regarding the conflict to be resolved.
+         * @param response The response of the PATCH request.
          */
-        void handleUploadConflict(const string &header);
+        void handleUploadConflict(const Http::Response &response);
 
         /**
          * @brief Handle errors encountered during the upload process.
-         * @param header An integer representing the specific error encountered.
+         * @param response The response of the PATCH request.
          */
-       [[noreturn]] void handleUploadError(const string &header);
+       [[noreturn]] void handleUploadError(const Http::Response &response);
     };
 } // namespace TUS
 #endif // INCLUDE_TUSCLIENT_H_
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#ifndef INCLUDE_UPLOADMANAGER_H_
+#define INCLUDE_UPLOADMANAGER_H_
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "TusStatus.h"
+#include "UploadPriority.h"
+#include "libtusclient.h"
+#include "logging/ILogger.h"
+
+using std::string;
+using std::filesystem::path;
+
+namespace TUS {
+    class TusClient;
+
+    namespace Cache {
+        class CacheRepository;
+    } // namespace Cache
+
+    namespace Chunk {
+        class ChunkScheduler;
+    } // namespace Chunk
+
+    namespace Http {
+        class HttpClient;
+    } // namespace Http
+
+    /**
+     * @brief Runs many uploads on a bounded pool of worker threads.
+     *
+     * The uploads are queued and started in order, each one by a TusClient. The clients share an http client,
+     * so the DNS cache, the TLS sessions and the connections are reused, and a cache of the application, so the
+     * resume state of every upload is kept in one place. Their chunks are sent by the workers of a
+     * Chunk::ChunkScheduler: a worker sends the next chunk of any running upload, the uploads do not own a thread.
+     * The ranges of a parallel upload, see TusClient::setParallelUploads(), are sent by the workers like uploads of
+     * their own.
+     * The number of uploads running at once is limited globally and per host, the number of queued ones too.
+     *
+     * The queued uploads start by priority, then by deadline: the closest of the one given to add() and of the
+     * Upload-Expires of the server, then in order. An upload that cannot start because the lower priority ones
+     * hold the slots preempts one of them: it is paused after its current chunk, queued again, and resumed from
+     * the offset of the server once it starts again.
+     */
+    class EXPORT_LIBTUSCLIENT UploadManager {
+    public:
+        using JobId = uint64_t;
+
+        using Deadline = std::optional<std::chrono::system_clock::time_point>;
+
+        /**
+         * @brief The time the uploads of a priority class waited in the queue before they started.
+         */
+        struct QueueingDelay {
+            size_t uploads = 0; /* the uploads started, an upload preempted is counted again once it restarts */
+            std::chrono::milliseconds average{0};
+            std::chrono::milliseconds max{0};
+        };
+
+        static constexpr size_t DEFAULT_MAX_CONCURRENT_UPLOADS = 4;
+
+        static constexpr size_t DEFAULT_MAX_QUEUED_UPLOADS = 1024;
+
+        /**
+         * @param appName The name of the application, the uploads are cached under it
+         * @param maxConcurrentUploads The number of uploads running at once, and the number of workers
+         * @param logLevel The log level of the clients
+         * @throws std::invalid_argument if maxConcurrentUploads is 0
+         */
+        explicit UploadManager(string appName, size_t maxConcurrentUploads = DEFAULT_MAX_CONCURRENT_UPLOADS,
+                               Logging::LogLevel logLevel = Logging::LogLevel::_NONE_);
+
+        /**
+         * @brief The queued uploads are canceled and the running ones paused, they can be resumed from the cache.
+         */
+        ~UploadManager();
+
+        UploadManager(const UploadManager &) = delete;
+
+        UploadManager &operator=(const UploadManager &) = delete;
+
+        /**
+         * @brief Queue the upload of a file.
+         * @param url The url of the tus endpoint
+         * @param filePath The file to upload
+         * @param chunkSize The size of the chunks, 0 to choose it from the size of the file
+         * @param priority The priority class of the upload
+         * @param deadline The time the upload should be finished by, uploads of the same class with a close
+         * deadline start first
+         * @return The identifier of the upload
+         * @throws TUSException if the queue is full
+         */
+        JobId add(string url, path filePath, int chunkSize = 0, UploadPriority priority = UploadPriority::NORMAL,
+                  Deadline deadline = std::nullopt);
+
+        /**
+         * @brief Cancel an upload, it is removed from the queue or canceled while it runs.
+         * @return false if the upload already ended
+         * @throws std::out_of_range if the upload is unknown
+         */
+        bool cancel(JobId id);
+
+        /**
+         * @brief Block until every upload queued has ended.
+         */
+        void wait();
+
+        /**
+         * @brief Get the status of an upload, READY while it is queued and PAUSED while it is preempted.
+         * @throws std::out_of_range if the upload is unknown
+         */
+        [[nodiscard]] TusStatus status(JobId id) const;
+
+        /**
+         * @brief Get the progress of an upload as a percentage.
+         * @throws std::out_of_range if the upload is unknown
+         */
+        [[nodiscard]] float progress(JobId id) const;
+
+        /**
+         * @brief Get the progress of all the uploads as a percentage of their bytes, the canceled ones excluded.
+         */
+        [[nodiscard]] float progress() const;
+
+        /**
+         * @brief Get the upload speed of the running uploads in bytes per second.
+         */
+        [[nodiscard]] double getUploadSpeed() const;
+
+        [[nodiscard]] size_t getQueuedUploads() const;
+
+        [[nodiscard]] size_t getRunningUploads() const;
+
+        /**
+         * @brief Get the time the uploads of a priority class waited before they started.
+         */
+        [[nodiscard]] QueueingDelay getQueueingDelay(UploadPriority priority) const;
+
+        /**
+         * @brief Get the number of uploads paused to let a higher priority one start.
+         */
+        [[nodiscard]] uint64_t getPreemptions() const;
+
+        /**
+         * @brief Set the number of uploads running at once. With more than the workers, the chunks of the uploads
+         * take turns on them; with fewer, the running uploads finish before new ones start.
+         * @throws std::invalid_argument if count is 0, no upload would start and wait() would not return
+         */
+        void setMaxConcurrentUploads(size_t count);
+
+        [[nodiscard]] size_t getMaxConcurrentUploads() const;
+
+        /**
+         * @brief Set the number of uploads running at once to the same host, 0 for no limit.
+         */
+        void setMaxUploadsPerHost(size_t count);
+
+        [[nodiscard]] size_t getMaxUploadsPerHost() const;
+
+        /**
+         * @brief Set the number of uploads waiting in the queue, add() refuses the next ones.
+         */
+        void setMaxQueuedUploads(size_t count);
+
+        [[nodiscard]] size_t getMaxQueuedUploads() const;
+
+        /**
+         * @brief Set the number of partial uploads of each file, see TusClient::setParallelUploads(). It applies to
+         * the uploads started next, their ranges are sent by the workers like uploads of their own.
+         */
+        void setParallelUploads(size_t count);
+
+        [[nodiscard]] size_t getParallelUploads() const;
+
+        /**
+         * @brief Set the authorization token of the requests of every upload.
+         */
+        void setBearerToken(const std::string &token) const;
+
+    private:
+        struct Job {
+            const JobId id;
+            const string url;
+            const path filePath;
+            const int chunkSize;
+            const string host;
+            const uint64_t size;
+            const UploadPriority priority;
+            const Deadline deadline;
+            TusStatus status = TusStatus::READY; /* the status of the client once it ended */
+            float progress = 0; /* the progress of the client once it ended */
+            std::shared_ptr<TusClient> client; /* set while the upload runs, and while it is preempted */
+            std::chrono::steady_clock::time_point queuedAt;
+            bool preempted = false; /* it pauses after its current chunk */
+            bool paused = false; /* preempted and queued again, it is resumed once it starts */
+            size_t partialSteps = 0; /* ranges of a parallel upload still sent, the last one to stop ends it */
+        };
+
+        struct DelayStats {
+            size_t uploads = 0;
+            std::chrono::steady_clock::duration total{0};
+            std::chrono::steady_clock::duration max{0};
+        };
+
+        /**
+         * @brief Get the host and the port of a url, the uploads to a host are limited together.
+         */
+        static string getHost(const string &url);
+
+        /**
+         * @brief Get the closest of the deadline of an upload and of the Upload-Expires of the server
+         */
+        static Deadline getDeadline(const Job &job);
+
+        /**
+         * @brief Check if an upload starts before another one: higher priority, closer deadline, then queued first
+         */
+        static bool startsBefore(const Job &job, const Job &other);
+
+        /**
+         * @brief Check if the host of an upload is below its limit, the mutex must be held
+         */
+        [[nodiscard]] bool hostHasSlot(const Job &job) const;
+
+        /**
+         * @brief Take the first queued upload whose host is below its limit, the mutex must be held
+         * @return null if none can start
+         */
+        std::shared_ptr<Job> takeNext();
+
+        /**
+         * @brief Start the queued uploads within the limits, the mutex must be held
+         */
+        void admit();
+
+        /**
+         * @brief Mark the running uploads that leave their slot to a higher priority one, the mutex must be held
+         */
+        void preempt();
+
+        /**
+         * @brief Pause a preempted upload at its chunk boundary and queue it again
+         */
+        void requeue(const std::shared_ptr<Job> &job);
+
+        /**
+         * @brief Send the next chunk of an upload, its first step creates it on the server
+         * @return false once it ended
+         */
+        bool step(const std::shared_ptr<Job> &job);
+
+        /**
+         * @brief Send the next chunk of a range of a parallel upload, the last range to stop joins the ranges, or
+         * pauses the upload if it is preempted or the manager is stopping
+         * @return false once the range stopped
+         */
+        bool stepPartial(const std::shared_ptr<Job> &job, const std::shared_ptr<TusClient> &client, size_t index);
+
+        /**
+         * @brief Create the client of an upload and its upload on the server
+         * @return null if the upload is canceled or cannot start
+         */
+        std::shared_ptr<TusClient> start(const std::shared_ptr<Job> &job);
+
+        /**
+         * @brief Keep the result of an ended upload and start the next ones
+         */
+        void finish(const std::shared_ptr<Job> &job);
+
+        [[nodiscard]] const std::shared_ptr<Job> &getJob(JobId id) const;
+
+        const string m_appName;
+        const Logging::LogLevel m_logLevel;
+        std::unique_ptr<Logging::ILogger> m_logger;
+        std::shared_ptr<Http::HttpClient> m_httpClient;
+        std::shared_ptr<Cache::CacheRepository> m_cache;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::map<JobId, std::shared_ptr<Job> > m_jobs;
+        std::deque<std::shared_ptr<Job> > m_queue;
+        std::map<string, size_t, std::less<> > m_runningPerHost;
+        std::map<JobId, std::shared_ptr<Job> > m_runningJobs;
+        std::array<DelayStats, UPLOAD_PRIORITY_COUNT> m_delays;
+        size_t m_preempting = 0; /* running uploads preempted, not paused yet */
+        uint64_t m_preemptions = 0;
+        JobId m_nextId = 1;
+        size_t m_running = 0;
+        size_t m_maxConcurrentUploads;
+        size_t m_maxUploadsPerHost = 0;
+        size_t m_maxQueuedUploads = DEFAULT_MAX_QUEUED_UPLOADS;
+        size_t m_parallelUploads = 1;
+        bool m_stopping = false;
+        std::unique_ptr<Chunk::ChunkScheduler> m_scheduler;
+    };
+} // namespace TUS
+
+#endif // INCLUDE_UPLOADMANAGER_H_
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#ifndef INCLUDE_UPLOADPRIORITY_H_
+#define INCLUDE_UPLOADPRIORITY_H_
+
+#include <cstddef>
+
+#include "libtusclient.h"
+
+namespace TUS {
+    /**
+     * @brief The priority class of an upload of the UploadManager, a higher one preempts the lower ones.
+     */
+    enum class EXPORT_LIBTUSCLIENT UploadPriority {
+        BULK, /* backfills and synchronizations, they run when nothing else waits */
+        NORMAL,
+        INTERACTIVE /* uploads a user waits for */
+    };
+
+    constexpr size_t UPLOAD_PRIORITY_COUNT = 3;
+}
+#endif // INCLUDE_UPLOADPRIORITY_H_
@@ -6,6 +6,8 @@
 #ifndef INCLUDE_CACHE_CACHEREPOSITORY_H_
 #define INCLUDE_CACHE_CACHEREPOSITORY_H_
 
+#include <mutex>
+
 #include "libtusclient.h"
 #include "repository/IRepository.h"
 #include "cache/TUSFile.h"
@@ -14,7 +16,8 @@
 namespace TUS::Cache {
     /**
      * @brief The CacheRepository class is a repository for TUSFile objects.
-     * The repository stores TUSFile objects in a cache file.
+     * The repository stores TUSFile objects in a cache file, one per uploaded file.
+     * It can be shared by the clients of an application running on different threads.
      */
 
     class EXPORT_LIBTUSCLIENT CacheRepository : public Repository::IRepository<TUSFile> {
@@ -23,6 +26,9 @@ namespace TUS::Cache {
         static std::shared_ptr<CacheRepository> create(std::string appName, bool clearCache = false);
         ~CacheRepository() override;
 
+        /**
+         * @brief Add a copy of the record, it replaces the record of the same file.
+         */
         void add(std::shared_ptr<TUSFile>) override;
 
         void remove(std::shared_ptr<TUSFile>) override;
@@ -39,6 +45,8 @@ namespace TUS::Cache {
 
     private:
         std::vector<std::shared_ptr<TUSFile> > m_cache;
+        mutable std::mutex m_mutex; /* guards m_cache and the cache file */
+        bool m_modified = false; /* an unchanged repository does not overwrite the file saved by another one */
         const std::string m_appName;
         const std::filesystem::path m_path;
     };
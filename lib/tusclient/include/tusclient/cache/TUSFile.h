@@ -9,6 +9,7 @@
 
 #include <string>
 #include <filesystem>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include <boost/uuid/uuid.hpp>
 
@@ -25,6 +26,16 @@ namespace TUS::Cache {
      */
     class EXPORT_LIBTUSCLIENT TUSFile {
     public:
+        /**
+         * @brief The state of a partial upload of a parallel upload, a byte range of the file.
+         */
+        struct PartialState {
+            int64_t start = 0;
+            int64_t length = 0;
+            int64_t uploadOffset = 0; /* the bytes of the range stored by the server */
+            std::string tusIdentifier; /* the url of the partial upload */
+        };
+
         /**
          * @brief Construct a new TUSFile object.
          * @param filePath The path of the file to be uploaded.
@@ -52,7 +63,7 @@ namespace TUS::Cache {
 
         [[nodiscard]] int64_t getUploadOffset() const;
 
-        [[nodiscard]] int getResumeFrom() const;
+        [[nodiscard]] int64_t getResumeFrom() const;
 
         [[nodiscard]] std::string getTusIdentifier() const;
 
@@ -66,10 +77,17 @@ namespace TUS::Cache {
 
         void setTusIdentifier(std::string tusIdentifier);
 
-        void setResumeFrom(int resumeFrom);
+        void setResumeFrom(int64_t resumeFrom);
 
         void setChunkNumber(int chunkNumber);
 
+        /**
+         * @brief Get the partial uploads of a parallel upload, empty for a sequential one.
+         */
+        [[nodiscard]] std::vector<PartialState> getPartials() const;
+
+        void setPartials(std::vector<PartialState> partials);
+
         [[nodiscard]] bool select(const std::string &filePath, const std::string &appName, const std::string &uploadUrl) const;
 
     private:
@@ -78,11 +96,12 @@ namespace TUS::Cache {
         const std::string m_uploadUrl;
         const std::string m_appName;
         int64_t m_uploadOffset; /* the offset of the file that has been uploaded */
-        int m_resumeFrom{}; /* the offset from which the upload should resume */
+        int64_t m_resumeFrom{}; /* the offset from which the upload should resume */
         const int64_t m_fileSize;
         std::string m_tusIdentifier; /* the identifier of the file */
         const boost::uuids::uuid m_uuid; /* the uuid of the file */
         int m_chunkNumber{}; /* the number of the chunk that is being uploaded */
+        std::vector<PartialState> m_partials; /* the partial uploads of a parallel upload */
 
         const std::string m_identifcationHash; /* the hash of the file path and the upload url and app name*/
 
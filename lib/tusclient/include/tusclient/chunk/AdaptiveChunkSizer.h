@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_ADAPTIVECHUNKSIZER_H_
+#define INCLUDE_CHUNK_ADAPTIVECHUNKSIZER_H_
+
+#include <chrono>
+#include <cstdint>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk {
+    /**
+     * @brief Chooses the size of the next PATCH from the throughput and the round trip time of the last ones.
+     *
+     * A request is sized to last the target duration at the measured bandwidth, and at least
+     * MIN_ROUND_TRIPS round trips so that the round trip stays a small part of it. The size moves toward
+     * that value by at most a factor of two per request and is halved after a failed request, so a large
+     * chunk on a flaky link is not sent again whole. It stays between the minimum and the maximum size,
+     * the maximum follows the limits of the server (Tus-Max-Size) and of the proxies in front of it.
+     */
+    class EXPORT_LIBTUSCLIENT AdaptiveChunkSizer {
+    public:
+        static constexpr std::chrono::milliseconds DEFAULT_TARGET_DURATION{2000};
+        static constexpr uint64_t DEFAULT_MIN_SIZE = 256 * 1024;
+        static constexpr uint64_t DEFAULT_MAX_SIZE = 1024 * 1024 * 1024;
+        static constexpr int MIN_ROUND_TRIPS = 10;
+        static constexpr double SMOOTHING = 0.5; /* weight of the last measure */
+
+        /**
+         * @param initialSize The size of the first request
+         * @param targetDuration The duration of a request the size converges to
+         * @param minSize The smallest request, it is lowered to the initial size if that is smaller
+         * @param maxSize The largest request, 0 for no limit
+         */
+        explicit AdaptiveChunkSizer(uint64_t initialSize,
+                                    std::chrono::milliseconds targetDuration = DEFAULT_TARGET_DURATION,
+                                    uint64_t minSize = DEFAULT_MIN_SIZE, uint64_t maxSize = DEFAULT_MAX_SIZE);
+
+        /**
+         * @brief Get the size of the next request.
+         */
+        [[nodiscard]] uint64_t getChunkSize() const;
+
+        /**
+         * @brief Lower the maximum size, e.g. to the Tus-Max-Size of the server or the body limit of a proxy.
+         * @param maxSize The largest request, 0 to keep the current maximum
+         */
+        void limitMaxSize(uint64_t maxSize);
+
+        [[nodiscard]] uint64_t getMaxSize() const;
+
+        /**
+         * @brief Record a request stored by the server.
+         * @param bytes The bytes of the body
+         * @param duration The time from the start of the request to its response
+         * @param bandwidth The speed measured while the body was sent in bytes per second, 0 if unknown,
+         * the rest of the duration is taken as the round trip
+         */
+        void onSuccess(uint64_t bytes, std::chrono::nanoseconds duration, double bandwidth = 0);
+
+        /**
+         * @brief Record a request that failed or was interrupted, the next one is half as large.
+         */
+        void onFailure();
+
+        /**
+         * @brief Get the smoothed bandwidth in bytes per second, 0 before the first request.
+         */
+        [[nodiscard]] double getBandwidth() const;
+
+        /**
+         * @brief Get the smoothed round trip time, 0 before the first request or when it is not known.
+         */
+        [[nodiscard]] std::chrono::nanoseconds getRoundTripTime() const;
+
+    private:
+        uint64_t clamp(uint64_t size) const;
+
+        const std::chrono::milliseconds m_targetDuration;
+        const uint64_t m_minSize;
+        uint64_t m_maxSize;
+        uint64_t m_chunkSize;
+        double m_bandwidth = 0;
+        double m_roundTripTime = 0; /* seconds */
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_ADAPTIVECHUNKSIZER_H_
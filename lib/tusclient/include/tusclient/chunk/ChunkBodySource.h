@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_CHUNKBODYSOURCE_H_
+#define INCLUDE_CHUNK_CHUNKBODYSOURCE_H_
+
+#include <cstdint>
+
+#include "http/RequestBody.h"
+
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk {
+    class ChunkWindow;
+    class TUSChunk;
+
+    /**
+     * @brief The body of a request that spans several chunks of a window, e.g. a PATCH larger than a chunk.
+     * The bytes are copied from the chunks of the window as the http client sends them, a chunk still
+     * being read is PENDING and the transfer waits for it without blocking. The chunks are freed by the
+     * uploader once the server has confirmed them, so the body must fit in the capacity of the window.
+     */
+    class EXPORT_LIBTUSCLIENT ChunkBodySource : public Http::IBodySource {
+    public:
+        /**
+         * @param window The window of the upload, it must outlive the request and not be released by
+         * another thread while the request runs
+         * @param offset The offset of the body in the file
+         * @param length The size of the body
+         */
+        ChunkBodySource(ChunkWindow &window, uint64_t offset, uint64_t length);
+
+        size_t read(uint64_t offset, char *buffer, size_t size) override;
+
+        [[nodiscard]] uint64_t size() const override;
+
+    private:
+        ChunkWindow &m_window;
+        const uint64_t m_offset;
+        const uint64_t m_length;
+        const TUSChunk *m_chunk = nullptr;
+        int m_chunkNumber = -1;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_CHUNKBODYSOURCE_H_
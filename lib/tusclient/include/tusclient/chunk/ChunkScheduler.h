@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_CHUNKSCHEDULER_H_
+#define INCLUDE_CHUNK_CHUNKSCHEDULER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk {
+    /**
+     * @brief Sends the chunks of many uploads on a pool of worker threads, with work stealing.
+     *
+     * An upload is a step sending its next chunk, e.g. TusClient::uploadNextChunk(), or the next chunk of a range of
+     * a parallel upload, TusClient::uploadNextPartialChunk(): the ranges are uploads of their own. The step of an upload is
+     * in one place at a time, the deque of a worker or a worker running it, so its PATCH requests are sent one
+     * after the other in the order of their offsets. A worker runs the uploads of its deque in turn, and
+     * once it is empty it steals an upload waiting in the deque of another worker: a worker whose uploads
+     * ended early or whose endpoint is fast does not stay idle while the others have chunks ready to send.
+     */
+    class EXPORT_LIBTUSCLIENT ChunkScheduler {
+    public:
+        /**
+         * @brief Send the next chunk of an upload.
+         * @return true while the upload has chunks to send, false once it ended
+         */
+        using Step = std::function<bool()>;
+
+        /**
+         * @param workers The number of worker threads, at least one
+         */
+        explicit ChunkScheduler(size_t workers);
+
+        /**
+         * @brief The workers stop after the steps they are running, the uploads waiting are dropped.
+         */
+        ~ChunkScheduler();
+
+        ChunkScheduler(const ChunkScheduler &) = delete;
+
+        ChunkScheduler &operator=(const ChunkScheduler &) = delete;
+
+        /**
+         * @brief Add an upload, its steps run until one returns false. Added by a worker, it goes to the deque
+         * of that worker, otherwise the deques take turns.
+         */
+        void add(Step step);
+
+        /**
+         * @brief Block until every upload added has ended.
+         */
+        void wait();
+
+        [[nodiscard]] size_t getWorkers() const;
+
+        /**
+         * @brief Get the number of uploads waiting or running.
+         */
+        [[nodiscard]] size_t getUploads() const;
+
+        /**
+         * @brief Get the number of steps a worker took from the deque of another one.
+         */
+        [[nodiscard]] uint64_t getStolenSteps() const;
+
+    private:
+        struct Deque {
+            std::mutex mutex;
+            std::deque<std::shared_ptr<Step> > steps;
+        };
+
+        void push(size_t worker, std::shared_ptr<Step> step);
+
+        /**
+         * @brief Take the next upload of a worker, or one of another worker if it has none
+         */
+        std::shared_ptr<Step> take(size_t worker);
+
+        void work(size_t worker);
+
+        std::vector<std::unique_ptr<Deque> > m_deques;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        size_t m_waiting = 0; /* uploads in the deques */
+        size_t m_uploads = 0; /* uploads waiting or running */
+        bool m_stopping = false;
+        std::atomic<size_t> m_nextDeque{0};
+        std::atomic<uint64_t> m_stolenSteps{0};
+        std::vector<std::thread> m_workers;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_CHUNKSCHEDULER_H_
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_CHUNKWINDOW_H_
+#define INCLUDE_CHUNK_CHUNKWINDOW_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "IFileChunker.h"
+#include "TUSChunk.h"
+
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk {
+    /**
+     * @brief A bounded window of the chunks of an upload.
+     *
+     * At most getCapacity() chunks are in memory: the one being sent and the next ones, which a
+     * reader thread reads ahead while it is sent, so the disk and the network work at the same time.
+     * The chunks are freed once the server has confirmed their bytes and their buffers go back to the
+     * pool of the chunker to read the next chunks, the memory used does not depend on the size of the file.
+     * The size of a stream is not known before its end: the window reads ahead until the reader finds a
+     * chunk shorter than the chunk size, which is the last one.
+     * The window must be used by one thread at a time.
+     */
+    class EXPORT_LIBTUSCLIENT ChunkWindow {
+    public:
+        static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+        /**
+         * @brief Chunks read ahead of the one being sent, with 2 the chunks are triple buffered
+         */
+        static constexpr size_t DEFAULT_READ_AHEAD = 2;
+
+        /**
+         * @brief The file size of a stream, it is known when its last chunk is read
+         */
+        static constexpr uint64_t UNKNOWN_SIZE = UINT64_MAX;
+
+        /**
+         * @brief Create a window over the chunks of a chunker
+         * @param chunker The chunker the chunks are read from, it must outlive the window
+         * @param fileSize The size of the file divided by the chunker, UNKNOWN_SIZE for a stream
+         * @param memoryLimit The bytes of the chunks in memory, one chunk is kept even if it is larger
+         * @param readAhead The number of chunks read ahead, within the memory limit
+         */
+        ChunkWindow(const IFileChunker<TUSChunk> &chunker, uint64_t fileSize,
+                    size_t memoryLimit = DEFAULT_MEMORY_LIMIT, size_t readAhead = DEFAULT_READ_AHEAD);
+
+        ~ChunkWindow();
+
+        ChunkWindow(const ChunkWindow &) = delete;
+
+        ChunkWindow &operator=(const ChunkWindow &) = delete;
+
+        /**
+         * @brief Get a chunk, it waits for the chunk if it is still being read, and starts reading the next ones.
+         * @return The chunk, valid until the next call to get() or release().
+         * @throws the exception thrown by the chunker while it read the chunk
+         */
+        const TUSChunk &get(int chunkNumber);
+
+        /**
+         * @brief Get a chunk without waiting for it, e.g. from the read callback of the http client.
+         * @return The chunk, valid until the next call to get() or release(), nullptr while it is being read
+         * @throws the exception thrown by the chunker while it read the chunk
+         */
+        const TUSChunk *tryGet(int chunkNumber);
+
+        /**
+         * @brief Free the chunks whose bytes are all before the offset confirmed by the server.
+         */
+        void release(uint64_t offset);
+
+        /**
+         * @brief Get the size of the file, for a stream it is known once its last chunk has been read.
+         */
+        [[nodiscard]] std::optional<uint64_t> getFileSize() const;
+
+        /**
+         * @brief Get the size of the chunks, the last one can be smaller.
+         */
+        [[nodiscard]] uint64_t getChunkSize() const;
+
+        /**
+         * @brief Get the maximum number of chunks in memory.
+         */
+        [[nodiscard]] size_t getCapacity() const;
+
+        /**
+         * @brief Get the number of chunks in memory or being read.
+         */
+        [[nodiscard]] size_t getResidentChunks() const;
+
+    private:
+        struct Slot {
+            std::optional<TUSChunk> chunk;
+            std::exception_ptr error;
+            bool reading = false;
+            bool ready = false;
+        };
+
+        /**
+         * @brief Queue the chunk if it is not in the window and the next ones to read ahead, the mutex must be held
+         */
+        Slot &request(int chunkNumber);
+
+        /**
+         * @brief Get the chunk of a slot that has been read, the mutex must be held
+         * @throws the exception thrown by the chunker, the slot is removed to read the chunk again
+         */
+        const TUSChunk &take(int chunkNumber, Slot &slot);
+
+        /**
+         * @brief Add a slot for the chunk and queue it for the reader, the mutex must be held
+         * @param first true to read the chunk before the ones already queued
+         */
+        void schedule(int chunkNumber, bool first);
+
+        void readChunks();
+
+        const IFileChunker<TUSChunk> &m_chunker;
+        const uint64_t m_chunkSize;
+        const size_t m_capacity;
+        uint64_t m_fileSize; /* set when the last chunk of a stream is read */
+        int m_chunkNumber;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::map<int, Slot> m_chunks;
+        std::deque<int> m_queue; /* chunks waiting for the reader */
+        bool m_stopping = false;
+        std::thread m_reader;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_CHUNKWINDOW_H_
@@ -21,12 +21,16 @@ using std::filesystem::path;
 
 namespace TUS::Chunk {
     class TUSChunk;
+    namespace Utility {
+        class BufferPool;
+    } // namespace Utility
+
     /**
      * @brief This class is responsible for chunking a file into multiple chunks.
      * The chunks are stored in a temporary directory and can be loaded from there.
      * The class also provides methods to remove the chunk files and to get the temporary directory.
      * To get the chunks, the loadChunks method must be called and you can get the chunks with the getChunks method,
-     * which returns a vector of TUSChunk objects.
+     * which returns a vector of TUSChunk objects. Without loadChunks, getChunk reads a single chunk file.
      */
     class EXPORT_LIBTUSCLIENT FileChunker : public IFileChunker<TUSChunk>, public FileVerifier::IFileVerifier {
     private:
@@ -40,9 +44,12 @@ namespace TUS::Chunk {
         std::vector<TUSChunk> m_chunks;
         int m_chunkNumber{};
         std::unique_ptr<FileVerifier::IFileVerifier> m_verifier;
+        std::shared_ptr<Utility::BufferPool> m_buffers;
 
         void calculateChunkSize();
 
+        [[nodiscard]] TUSChunk readChunkFile(int chunkNumber) const;
+
     public:
         FileChunker(string appName, string uuid, path filepath, int chunkSize = 0,
                     std::unique_ptr<FileVerifier::IFileVerifier> verifier = nullptr);
@@ -63,6 +70,8 @@ namespace TUS::Chunk {
 
         [[nodiscard]] std::vector<TUSChunk> getChunks() const override;
 
+        [[nodiscard]] TUSChunk getChunk(int chunkNumber) const override;
+
         [[nodiscard]] path getChunkFilePath(int chunkNumber) const override;
 
         [[nodiscard]] size_t getChunkSize() const override;
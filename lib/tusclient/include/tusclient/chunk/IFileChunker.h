@@ -6,6 +6,7 @@
 #ifndef INCLUDE_CHUNK_IFILECHUNKER_H_
 #define INCLUDE_CHUNK_IFILECHUNKER_H_
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <filesystem>
@@ -17,6 +18,20 @@ using std::filesystem::path;
 
 namespace TUS::Chunk {
     class TUSChunk;
+
+    /**
+     * @brief Where the chunks of an upload are read from
+     */
+    enum class EXPORT_LIBTUSCLIENT ChunkSourceType {
+        _SOURCE_FILE, /* positioned reads from the file being uploaded, nothing is copied */
+        _TEMPORARY_FILES, /* the file is copied in chunk files of the temporary directory first */
+        _MEMORY_MAPPED, /* the chunks are views of the file mapped in memory, nothing is copied */
+        _IO_URING, /* the reads of all the uploads are batched by an io_uring, pread where it is not available */
+        _IO_URING_DIRECT, /* like _IO_URING, bypassing the page cache */
+        _MEMORY, /* the chunks are views of a memory region of the caller, see MemoryChunker */
+        _STREAM, /* the chunks are read from a stream of unknown length, see StreamChunker */
+    };
+
     /**
      * @class IFileChunker
      * @brief Interface for chunking files into smaller parts.
@@ -70,11 +85,18 @@ namespace TUS::Chunk {
         virtual void clearChunks() = 0;
 
         /**
-         * @brief Gets the chunks.
-         * @return The chunks.
+         * @brief Gets the chunks, all of them in memory, use getChunk() to read one at a time.
+         * @return The chunks, copying them does not copy their bytes.
          */
         virtual std::vector<T> getChunks() const = 0;
 
+        /**
+         * @brief Gets a single chunk, the way to read a file chunk by chunk.
+         * @param chunkNumber The number of the chunk, from 0 to getChunkNumber() - 1.
+         * @return The chunk, a handle to a buffer shared by its copies.
+         */
+        [[nodiscard]] virtual T getChunk(int chunkNumber) const = 0;
+
         /**
          * @brief Gets the chunk file path.
          * @return The file path of the chunk.
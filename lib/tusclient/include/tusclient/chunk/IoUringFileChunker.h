@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_IOURINGFILECHUNKER_H_
+#define INCLUDE_CHUNK_IOURINGFILECHUNKER_H_
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "IFileChunker.h"
+
+#include "libtusclient.h"
+
+
+using std::string;
+using std::filesystem::path;
+
+
+namespace TUS::Chunk {
+    class TUSChunk;
+    namespace Utility {
+        class BufferPool;
+        class IoUringReader;
+        class SourceFile;
+    } // namespace Utility
+
+    /**
+     * @brief This class divides a file into chunks read through the io_uring of the process.
+     * The reads of all the uploads using this chunker are batched by one thread, see Utility::IoUringReader,
+     * where io_uring is not available or its ring has failed the chunks are read with pread, like the
+     * SourceFileChunker does.
+     * With direct I/O the file is read bypassing the page cache, so a large upload does not evict the
+     * pages other processes use. The reads must then be aligned: the chunk size is rounded up to a
+     * multiple of SourceFile::DIRECT_IO_ALIGNMENT, the buffers of Utility::BufferPool are aligned.
+     * A chunk requested after the file changed throws a TUSException.
+     */
+    class EXPORT_LIBTUSCLIENT IoUringFileChunker : public IFileChunker<TUSChunk> {
+    private:
+        const path m_filePath;
+        int64_t m_chunkSize;
+        int m_chunkNumber{};
+        bool m_directIo;
+        std::unique_ptr<Utility::SourceFile> m_source;
+        std::shared_ptr<Utility::IoUringReader> m_reader;
+        std::shared_ptr<Utility::BufferPool> m_buffers;
+
+    public:
+        /**
+         * @param filepath The file to upload
+         * @param chunkSize The size of the chunks, 0 selects it from the size of the file
+         * @param directIo Read the file bypassing the page cache where the file system supports it
+         */
+        explicit IoUringFileChunker(path filepath, int chunkSize = 0, bool directIo = false);
+
+        ~IoUringFileChunker() override;
+
+        /**
+         * @brief Open the file, the chunks are read when they are requested.
+         */
+        bool loadChunks() override;
+
+        /**
+         * @brief There are no chunk files, nothing is removed.
+         */
+        bool removeChunkFiles() override;
+
+        /**
+         * @brief There is no temporary directory, the path is empty.
+         */
+        [[nodiscard]] path getTemporaryDir() const override;
+
+        /**
+         * @brief Every chunk is a part of the file being uploaded, this is its name.
+         */
+        [[nodiscard]] string getChunkFilename(int chunkNumber) const override;
+
+        /**
+         * @brief Open the file and compute the number of chunks, nothing is copied.
+         */
+        int chunkFile() override;
+
+        /**
+         * @brief Close the file.
+         */
+        void clearChunks() override;
+
+        [[nodiscard]] std::vector<TUSChunk> getChunks() const override;
+
+        /**
+         * @brief Read a chunk in an aligned buffer of the pool of the process.
+         * @throws TUSException if the file changed since it was opened
+         */
+        [[nodiscard]] TUSChunk getChunk(int chunkNumber) const override;
+
+        [[nodiscard]] path getChunkFilePath(int chunkNumber) const override;
+
+        [[nodiscard]] size_t getChunkSize() const override;
+
+        [[nodiscard]] int getChunkNumber() const override;
+
+        /**
+         * @brief Check if the chunks are read through io_uring, false when they are read with pread, e.g. once
+         * the ring has failed.
+         */
+        [[nodiscard]] bool usesIoUring() const;
+
+        /**
+         * @brief Check if the file is read bypassing the page cache.
+         */
+        [[nodiscard]] bool usesDirectIo() const;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_IOURINGFILECHUNKER_H_
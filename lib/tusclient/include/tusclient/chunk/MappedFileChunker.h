@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_MAPPEDFILECHUNKER_H_
+#define INCLUDE_CHUNK_MAPPEDFILECHUNKER_H_
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "IFileChunker.h"
+
+#include "libtusclient.h"
+
+
+using std::string;
+using std::filesystem::path;
+
+
+namespace TUS::Chunk {
+    class TUSChunk;
+    namespace Utility {
+        class MappedFile;
+    } // namespace Utility
+
+    /**
+     * @brief This class divides a memory mapped file into chunks.
+     * The chunks are views of the mapping, their bytes go from the page cache to the socket without
+     * being copied in a buffer of the client. The pages of a chunk are read ahead when the chunk is
+     * requested and dropped when the last copy of the chunk is destroyed, e.g. once the server
+     * confirmed it, so the page cache used by the upload stays bounded.
+     * A chunk requested after the file changed throws a TUSException. The file must not be truncated
+     * while a chunk is sent: reading a mapped page past the end of the file raises SIGBUS.
+     */
+    class EXPORT_LIBTUSCLIENT MappedFileChunker : public IFileChunker<TUSChunk> {
+    private:
+        const path m_filePath;
+        int64_t m_chunkSize;
+        int m_chunkNumber{};
+        std::shared_ptr<Utility::MappedFile> m_mapping;
+
+    public:
+        explicit MappedFileChunker(path filepath, int chunkSize = 0);
+
+        ~MappedFileChunker() override;
+
+        /**
+         * @brief Map the file, the chunks are views of the mapping.
+         */
+        bool loadChunks() override;
+
+        /**
+         * @brief There are no chunk files, nothing is removed.
+         */
+        bool removeChunkFiles() override;
+
+        /**
+         * @brief There is no temporary directory, the path is empty.
+         */
+        [[nodiscard]] path getTemporaryDir() const override;
+
+        /**
+         * @brief Every chunk is a part of the file being uploaded, this is its name.
+         */
+        [[nodiscard]] string getChunkFilename(int chunkNumber) const override;
+
+        /**
+         * @brief Map the file and compute the number of chunks, nothing is copied.
+         */
+        int chunkFile() override;
+
+        /**
+         * @brief Unmap the file, once the chunks still referring to it are destroyed.
+         */
+        void clearChunks() override;
+
+        [[nodiscard]] std::vector<TUSChunk> getChunks() const override;
+
+        /**
+         * @brief Get a view of a chunk, its bytes are read from the mapping when they are sent.
+         * @throws TUSException if the file changed since it was mapped
+         */
+        [[nodiscard]] TUSChunk getChunk(int chunkNumber) const override;
+
+        [[nodiscard]] path getChunkFilePath(int chunkNumber) const override;
+
+        [[nodiscard]] size_t getChunkSize() const override;
+
+        [[nodiscard]] int getChunkNumber() const override;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_MAPPEDFILECHUNKER_H_
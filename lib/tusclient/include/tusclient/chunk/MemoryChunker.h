@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_MEMORYCHUNKER_H_
+#define INCLUDE_CHUNK_MEMORYCHUNKER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+
+#include "IFileChunker.h"
+
+#include "libtusclient.h"
+
+
+using std::string;
+using std::filesystem::path;
+
+
+namespace TUS::Chunk {
+    class TUSChunk;
+
+    /**
+     * @brief This class divides a memory region of the caller into chunks, e.g. a payload produced by a
+     * service. The chunks are views of the region, their bytes are sent from it without being copied nor
+     * written to a file. The region must not change during the upload, and must stay valid as long as the
+     * chunks unless an owner keeping it alive is given.
+     */
+    class EXPORT_LIBTUSCLIENT MemoryChunker : public IFileChunker<TUSChunk> {
+    private:
+        const string m_name;
+        const std::span<const std::byte> m_data;
+        std::shared_ptr<const void> m_owner;
+        int64_t m_chunkSize;
+        int m_chunkNumber;
+
+    public:
+        /**
+         * @param name The name of the upload, e.g. the name of the file it would be written to
+         * @param data The bytes to upload
+         * @param chunkSize The size of the chunks, 0 to choose it from the size of the data
+         * @param owner Keeps the data valid, it is held by the chunker and its chunks, e.g. the vector holding it
+         */
+        MemoryChunker(string name, std::span<const std::byte> data, int chunkSize = 0,
+                      std::shared_ptr<const void> owner = nullptr);
+
+        ~MemoryChunker() override;
+
+        /**
+         * @brief The data is already in memory, nothing is loaded.
+         */
+        bool loadChunks() override;
+
+        /**
+         * @brief There are no chunk files, nothing is removed.
+         */
+        bool removeChunkFiles() override;
+
+        /**
+         * @brief There is no temporary directory, the path is empty.
+         */
+        [[nodiscard]] path getTemporaryDir() const override;
+
+        /**
+         * @brief Every chunk is a part of the data, this is its name.
+         */
+        [[nodiscard]] string getChunkFilename(int chunkNumber) const override;
+
+        /**
+         * @brief Compute the number of chunks, nothing is copied.
+         */
+        int chunkFile() override;
+
+        /**
+         * @brief The chunks are views of the data, nothing is freed.
+         */
+        void clearChunks() override;
+
+        [[nodiscard]] std::vector<TUSChunk> getChunks() const override;
+
+        /**
+         * @brief Get a view of a chunk of the data.
+         * @throws std::out_of_range if the data has fewer chunks
+         */
+        [[nodiscard]] TUSChunk getChunk(int chunkNumber) const override;
+
+        [[nodiscard]] path getChunkFilePath(int chunkNumber) const override;
+
+        [[nodiscard]] size_t getChunkSize() const override;
+
+        [[nodiscard]] int getChunkNumber() const override;
+
+        /**
+         * @brief Get the size of the data.
+         */
+        [[nodiscard]] uint64_t getSize() const;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_MEMORYCHUNKER_H_
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_SOURCEFILECHUNKER_H_
+#define INCLUDE_CHUNK_SOURCEFILECHUNKER_H_
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "IFileChunker.h"
+
+#include "libtusclient.h"
+
+
+using std::string;
+using std::filesystem::path;
+
+
+namespace TUS::Chunk {
+    class TUSChunk;
+    namespace Utility {
+        class BufferPool;
+        class SourceFile;
+    } // namespace Utility
+
+    /**
+     * @brief This class divides a file into chunks without copying it.
+     * Every chunk is read from the file being uploaded when it is requested, with a positioned read
+     * at its offset, so the upload needs neither a temporary directory nor a copy of the file.
+     * The file is opened by chunkFile() or loadChunks(), a chunk requested after the size or the
+     * last write time of the file changed throws a TUSException.
+     */
+    class EXPORT_LIBTUSCLIENT SourceFileChunker : public IFileChunker<TUSChunk> {
+    private:
+        const path m_filePath;
+        int64_t m_chunkSize;
+        int m_chunkNumber{};
+        std::unique_ptr<Utility::SourceFile> m_source;
+        std::shared_ptr<Utility::BufferPool> m_buffers;
+
+    public:
+        explicit SourceFileChunker(path filepath, int chunkSize = 0);
+
+        ~SourceFileChunker() override;
+
+        /**
+         * @brief Open the file, the chunks are read when they are requested.
+         */
+        bool loadChunks() override;
+
+        /**
+         * @brief There are no chunk files, nothing is removed.
+         */
+        bool removeChunkFiles() override;
+
+        /**
+         * @brief There is no temporary directory, the path is empty.
+         */
+        [[nodiscard]] path getTemporaryDir() const override;
+
+        /**
+         * @brief Every chunk is a part of the file being uploaded, this is its name.
+         */
+        [[nodiscard]] string getChunkFilename(int chunkNumber) const override;
+
+        /**
+         * @brief Open the file and compute the number of chunks, nothing is copied.
+         */
+        int chunkFile() override;
+
+        void clearChunks() override;
+
+        /**
+         * @brief Read all the chunks, use getChunk() to keep a single chunk in memory.
+         */
+        [[nodiscard]] std::vector<TUSChunk> getChunks() const override;
+
+        /**
+         * @brief Read a chunk from the file in a buffer of the pool of the process.
+         * @throws TUSException if the file changed since it was opened
+         */
+        [[nodiscard]] TUSChunk getChunk(int chunkNumber) const override;
+
+        [[nodiscard]] path getChunkFilePath(int chunkNumber) const override;
+
+        [[nodiscard]] size_t getChunkSize() const override;
+
+        [[nodiscard]] int getChunkNumber() const override;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_SOURCEFILECHUNKER_H_
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef INCLUDE_CHUNK_STREAMCHUNKER_H_
+#define INCLUDE_CHUNK_STREAMCHUNKER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "IFileChunker.h"
+
+#include "libtusclient.h"
+
+
+using std::string;
+using std::filesystem::path;
+
+
+namespace TUS::Chunk {
+    class TUSChunk;
+    namespace Utility {
+        class BufferPool;
+    } // namespace Utility
+
+    /**
+     * @brief Reads the next bytes of a stream in a buffer, it blocks until some bytes are available.
+     * @return The number of bytes read, 0 at the end of the stream
+     * @throws any exception, the upload fails
+     */
+    using StreamReader = std::function<size_t(uint8_t *buffer, size_t size)>;
+
+    /**
+     * @brief This class divides a stream of unknown length into chunks, e.g. a pipe, a socket or the
+     * output of a compressor. The stream is read once and in order: getChunk() returns the next chunk,
+     * filled until the chunk size or the end of the stream, and a chunk already read cannot be read
+     * again. The last chunk is shorter than the chunk size, or empty when the stream ends on a chunk boundary,
+     * and the chunks after it are empty.
+     */
+    class EXPORT_LIBTUSCLIENT StreamChunker : public IFileChunker<TUSChunk> {
+    private:
+        const string m_name;
+        const int64_t m_chunkSize;
+        StreamReader m_reader;
+        std::shared_ptr<Utility::BufferPool> m_buffers;
+
+        mutable std::mutex m_mutex; /* held while a chunk is read */
+        mutable std::atomic<int> m_nextChunk{0};
+        mutable std::atomic<bool> m_ended{false};
+
+    public:
+        /**
+         * @brief The chunk size of a stream whose chunk size is not given, its length is not known.
+         */
+        static constexpr int64_t DEFAULT_CHUNK_SIZE = 5 * 1000 * 1000;
+
+        /**
+         * @param name The name of the stream, e.g. the name of the file it produces
+         * @param reader Reads the stream, it is called by one thread at a time
+         * @param chunkSize The size of the chunks, 0 for DEFAULT_CHUNK_SIZE
+         */
+        StreamChunker(string name, StreamReader reader, int chunkSize = 0);
+
+        ~StreamChunker() override;
+
+        /**
+         * @brief Read a file descriptor, e.g. a pipe or a socket, until its end. It is not closed.
+         * @throws TUSException if a read fails
+         */
+        static StreamReader readFileDescriptor(int fd);
+
+        /**
+         * @brief Read a standard stream until its end, e.g. std::cin. It must outlive the reader.
+         * @throws TUSException if the stream fails
+         */
+        static StreamReader readStream(std::istream &stream);
+
+        /**
+         * @brief The stream is read when the chunks are requested, nothing is loaded.
+         */
+        bool loadChunks() override;
+
+        /**
+         * @brief There are no chunk files, nothing is removed.
+         */
+        bool removeChunkFiles() override;
+
+        /**
+         * @brief There is no temporary directory, the path is empty.
+         */
+        [[nodiscard]] path getTemporaryDir() const override;
+
+        /**
+         * @brief Every chunk is a part of the stream, this is its name.
+         */
+        [[nodiscard]] string getChunkFilename(int chunkNumber) const override;
+
+        /**
+         * @brief Nothing is read, the number of chunks is not known before the end of the stream.
+         * @return The number of chunks read so far
+         */
+        int chunkFile() override;
+
+        /**
+         * @brief The stream is not read again, the chunks already read are lost.
+         */
+        void clearChunks() override;
+
+        /**
+         * @brief Read the rest of the stream, use getChunk() to keep a single chunk in memory.
+         */
+        [[nodiscard]] std::vector<TUSChunk> getChunks() const override;
+
+        /**
+         * @brief Read the next chunk of the stream in a buffer of the pool of the process.
+         * @param chunkNumber The number of the next chunk, the chunks are read in order
+         * @throws std::out_of_range if the chunk is not the next one
+         */
+        [[nodiscard]] TUSChunk getChunk(int chunkNumber) const override;
+
+        [[nodiscard]] path getChunkFilePath(int chunkNumber) const override;
+
+        [[nodiscard]] size_t getChunkSize() const override;
+
+        /**
+         * @brief Get the number of chunks read so far, the last one included once the stream ended.
+         */
+        [[nodiscard]] int getChunkNumber() const override;
+
+        /**
+         * @brief Check if the end of the stream was read, its length is then known.
+         */
+        [[nodiscard]] bool hasEnded() const;
+    };
+} // namespace TUS::Chunk
+
+
+#endif // INCLUDE_CHUNK_STREAMCHUNKER_H_
@@ -8,6 +8,8 @@
 
 #include <vector>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include "libtusclient.h"
 
 
@@ -17,24 +19,42 @@ namespace TUS::Chunk {
      * @brief Represents a chunk of a TUS file.
      *
      * This class represents a chunk of a TUS file. A chunk is a part of a file
-     * that is uploaded to the server in a single request.
+     * that is uploaded to the server in a single request. It is a handle: the bytes are held by a
+     * shared buffer, e.g. a buffer of the pool or a memory mapped file, copying a chunk does not
+     * copy them and the buffer is released with the last copy.
      */
     class EXPORT_LIBTUSCLIENT TUSChunk {
     public:
         /**
          * @brief Construct a TUSChunk object.
          *
-         * @param data The data of the chunk.
+         * @param data The data of the chunk, it is moved in a shared buffer.
          * @param offset The offset of the chunk in the file.
          */
         TUSChunk(std::vector<uint8_t> data, size_t offset);
 
+        /**
+         * @brief Construct a chunk that refers to memory it does not own, e.g. a part of a memory mapped file.
+         *
+         * @param owner Keeps the memory valid, it is released with the last copy of the chunk.
+         * @param data The first byte of the chunk.
+         * @param size The size of the chunk.
+         */
+        TUSChunk(std::shared_ptr<const void> owner, const uint8_t *data, size_t size);
+
         /**
          * @brief Get the data of the chunk.
          *
-         * @return The data of the chunk.
+         * @return The bytes of the chunk, valid as long as a copy of the chunk exists.
+         */
+        [[nodiscard]] std::span<const uint8_t> getData() const;
+
+        /**
+         * @brief Get the first byte of the chunk.
+         *
+         * @return The bytes of the chunk, getChunkSize() of them, valid as long as a copy of the chunk exists.
          */
-        [[nodiscard]] std::vector<uint8_t> getData() const;
+        [[nodiscard]] const uint8_t *getBytes() const;
 
         /**
          * @brief Get the offset of the chunk in the file.
@@ -44,8 +64,8 @@ namespace TUS::Chunk {
         [[nodiscard]] size_t getChunkSize() const;
 
     private:
-        std::vector<uint8_t> m_data;
-        size_t m_chunkSize;
+        std::shared_ptr<const void> m_owner;
+        std::span<const uint8_t> m_data;
     };
 } // namespace Model
 
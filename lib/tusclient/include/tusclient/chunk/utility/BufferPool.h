@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#ifndef INCLUDE_CHUNK_UTILITY_BUFFERPOOL_H_
+#define INCLUDE_CHUNK_UTILITY_BUFFERPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk::Utility {
+    /**
+     * @brief Buffers of the chunks, recycled by all the chunkers of the process.
+     *
+     * A buffer is held by the chunks that refer to it, the last one gives it back and the next chunk of
+     * the same size is read into it, so the uploads allocate only the buffers of the chunks in memory at
+     * the same time. The buffers are aligned for direct I/O. Idle buffers beyond the idle limit are freed.
+     * The pool must be owned by a std::shared_ptr, the buffers keep it alive.
+     */
+    class EXPORT_LIBTUSCLIENT BufferPool : public std::enable_shared_from_this<BufferPool> {
+    public:
+        static constexpr size_t ALIGNMENT = 4096;
+        static constexpr size_t DEFAULT_IDLE_LIMIT = 256 * 1024 * 1024;
+
+        /**
+         * @brief Get the pool shared by the chunkers of the process.
+         */
+        static std::shared_ptr<BufferPool> getShared();
+
+        /**
+         * @param idleLimit The bytes of the idle buffers kept for the next chunks
+         */
+        explicit BufferPool(size_t idleLimit = DEFAULT_IDLE_LIMIT);
+
+        ~BufferPool();
+
+        BufferPool(const BufferPool &) = delete;
+
+        BufferPool &operator=(const BufferPool &) = delete;
+
+        /**
+         * @brief Get a buffer of at least size bytes, a released buffer of the same capacity if there is one.
+         * @return The buffer, it goes back to the pool with the last copy of the pointer
+         */
+        std::shared_ptr<uint8_t> acquire(size_t size);
+
+        /**
+         * @brief Get the capacity of the buffers returned for a size, the size rounded up to the alignment.
+         */
+        [[nodiscard]] static size_t getCapacity(size_t size);
+
+        /**
+         * @brief Get the bytes of the idle buffers.
+         */
+        [[nodiscard]] size_t getIdleBytes() const;
+
+        /**
+         * @brief Change the bytes of the idle buffers kept, the ones beyond it are freed.
+         */
+        void setIdleLimit(size_t idleLimit);
+
+    private:
+        void release(uint8_t *buffer, size_t capacity);
+
+        void trim();
+
+        mutable std::mutex m_mutex;
+        std::map<size_t, std::vector<uint8_t *> > m_free; /* idle buffers by capacity */
+        size_t m_idleBytes = 0;
+        size_t m_idleLimit;
+    };
+} // namespace TUS::Chunk::Utility
+
+
+#endif // INCLUDE_CHUNK_UTILITY_BUFFERPOOL_H_
@@ -38,6 +38,21 @@ namespace TUS::Chunk::Utility {
          * @return The size of the chunk in byte
          */
         static std::int64_t getChunkSizeFromKB(int size);
+
+        /**
+         * @brief Get the chunk size used when no size is requested, it grows with the file.
+         * @param fileSize The size of the file in byte
+         * @return The size of the chunk in byte, the whole file when it is smaller than 10 MB
+         */
+        static std::int64_t getDefaultChunkSize(std::uintmax_t fileSize);
+
+        /**
+         * @brief Get the number of chunks of a file, an empty file has one empty chunk.
+         * @param fileSize The size of the file in byte
+         * @param chunkSize The size of the chunk in byte
+         * @throws std::overflow_error if the chunks are too small to be numbered by an int
+         */
+        static int getChunkCount(std::uintmax_t fileSize, std::int64_t chunkSize);
     };
 } // namespace TUS::Chunk::Utility
 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#ifndef INCLUDE_CHUNK_UTILITY_IOURINGREADER_H_
+#define INCLUDE_CHUNK_UTILITY_IOURINGREADER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk::Utility {
+    /**
+     * @brief Reads files through a Linux io_uring, from one thread for all the callers.
+     *
+     * read() queues the request and waits for it. The ring thread submits every queued read with a single
+     * system call and completes them as the kernel reports them, so the reads of many uploads are batched.
+     * io_uring is available on Linux 5.6 and later, getShared() returns nullptr where it is not, e.g. on
+     * other systems or when a seccomp profile denies it, the callers read with pread instead.
+     */
+    class EXPORT_LIBTUSCLIENT IoUringReader {
+    public:
+        static constexpr unsigned DEFAULT_QUEUE_DEPTH = 64;
+
+        /**
+         * @brief Get the reader shared by the process, it is created by the first caller and stopped with
+         * its last user.
+         * @return The reader, nullptr if io_uring is not available
+         */
+        static std::shared_ptr<IoUringReader> getShared();
+
+        /**
+         * @brief Create the ring and start its thread.
+         * @param queueDepth The maximum number of reads in flight, more are queued
+         * @throws std::runtime_error if io_uring is not available
+         */
+        explicit IoUringReader(unsigned queueDepth = DEFAULT_QUEUE_DEPTH);
+
+        /**
+         * @brief Wait for the reads in flight and release the ring.
+         */
+        ~IoUringReader();
+
+        IoUringReader(const IoUringReader &) = delete;
+
+        IoUringReader &operator=(const IoUringReader &) = delete;
+
+        /**
+         * @brief Read the bytes at an offset of a file, see SourceFile::readAt().
+         * @param fd The file descriptor, opened with O_DIRECT the read must be aligned
+         * @return The number of bytes read, less than size only at the end of the file
+         * @throws std::runtime_error if the read fails or the ring is broken
+         */
+        size_t read(int fd, std::uint64_t offset, void *buffer, size_t size);
+
+        /**
+         * @brief Check if the ring failed, its reads fail and the callers read with pread instead.
+         */
+        [[nodiscard]] bool isBroken() const;
+
+    private:
+        struct Request;
+        struct Ring;
+
+        void run();
+
+        /**
+         * @brief Record the result of a read reaped from the ring, the mutex must be held
+         */
+        void complete(Request *request, int result);
+
+        /**
+         * @brief Fail every read not completed yet and stop the ring thread, the mutex must be held
+         */
+        void fail(int error);
+
+        std::unique_ptr<Ring> m_ring; /* the rings shared with the kernel, only used by the ring thread */
+        std::unordered_set<Request *> m_inFlight; /* the reads pushed to the ring and not reaped yet */
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_completed;
+        std::deque<Request *> m_pending;
+        bool m_stopping = false;
+        std::atomic<bool> m_broken{false};
+        std::thread m_thread;
+    };
+} // namespace TUS::Chunk::Utility
+
+
+#endif // INCLUDE_CHUNK_UTILITY_IOURINGREADER_H_
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#ifndef INCLUDE_CHUNK_UTILITY_MAPPEDFILE_H_
+#define INCLUDE_CHUNK_UTILITY_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "SourceFile.h"
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk::Utility {
+    /**
+     * @brief A file mapped read-only in memory.
+     *
+     * The mapping is read sequentially: the pages of a range are requested before it is read with
+     * willNeed() and dropped, from the mapping and the page cache, with discard() once they are not
+     * needed anymore.
+     */
+    class EXPORT_LIBTUSCLIENT MappedFile {
+    public:
+        /**
+         * @brief Open and map the file.
+         * @param filePath The path of the file
+         * @throws std::runtime_error if the file cannot be opened or mapped
+         */
+        explicit MappedFile(std::filesystem::path filePath);
+
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /**
+         * @brief Get the first byte of the mapping, nullptr for an empty file.
+         */
+        [[nodiscard]] const uint8_t *getData() const;
+
+        /**
+         * @brief Get the size of the mapping, the size of the file when it was opened.
+         */
+        [[nodiscard]] std::uint64_t getSize() const;
+
+        /**
+         * @brief Check if the file changed since it was mapped, see SourceFile::hasChanged().
+         */
+        [[nodiscard]] bool hasChanged() const;
+
+        /**
+         * @brief Ask the system to read the pages of a range ahead.
+         */
+        void willNeed(std::uint64_t offset, size_t size) const;
+
+        /**
+         * @brief Drop the pages of a range that has been sent, the pages shared with the rest of the file are kept.
+         */
+        void discard(std::uint64_t offset, size_t size) const;
+
+    private:
+        SourceFile m_file;
+        uint8_t *m_data = nullptr;
+#ifdef _WIN32
+        void *m_mapping = nullptr;
+#endif
+    };
+} // namespace TUS::Chunk::Utility
+
+
+#endif // INCLUDE_CHUNK_UTILITY_MAPPEDFILE_H_
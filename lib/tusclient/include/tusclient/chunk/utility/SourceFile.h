@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#ifndef INCLUDE_CHUNK_UTILITY_SOURCEFILE_H_
+#define INCLUDE_CHUNK_UTILITY_SOURCEFILE_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include "libtusclient.h"
+
+
+namespace TUS::Chunk::Utility {
+    /**
+     * @brief A file opened for positioned reads.
+     *
+     * The reads do not move a shared file position, so they can be done by many threads at the same time.
+     * The size and the last write time are taken when the file is opened, hasChanged() compares them
+     * with the current ones.
+     */
+    class EXPORT_LIBTUSCLIENT SourceFile {
+    public:
+#ifdef _WIN32
+        using NativeHandle = void *;
+#else
+        using NativeHandle = int;
+#endif
+        static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+        /**
+         * @brief Open the file.
+         * @param filePath The path of the file
+         * @param directIo Read the file bypassing the page cache (O_DIRECT, FILE_FLAG_NO_BUFFERING) when the file
+         * system supports it, the reads must then be aligned, see isDirect()
+         * @throws std::runtime_error if the file cannot be opened
+         */
+        explicit SourceFile(std::filesystem::path filePath, bool directIo = false);
+
+        ~SourceFile();
+
+        SourceFile(const SourceFile &) = delete;
+
+        SourceFile &operator=(const SourceFile &) = delete;
+
+        /**
+         * @brief Read the bytes at an offset of the file.
+         * @param offset The offset of the first byte
+         * @param buffer The buffer the bytes are written to
+         * @param size The number of bytes to read
+         * @return The number of bytes read, less than size only at the end of the file
+         * @throws std::runtime_error if the read fails
+         */
+        size_t readAt(std::uint64_t offset, void *buffer, size_t size) const;
+
+        /**
+         * @brief Check if the size or the last write time of the file changed since it was opened,
+         * a file that was removed or replaced is changed too.
+         */
+        [[nodiscard]] bool hasChanged() const;
+
+        /**
+         * @brief Get the size of the file when it was opened.
+         */
+        [[nodiscard]] std::uint64_t getSize() const;
+
+        [[nodiscard]] const std::filesystem::path &getPath() const;
+
+        /**
+         * @brief Check if the file is read bypassing the page cache, the offset, the size and the address of
+         * the buffer of every read must then be multiples of DIRECT_IO_ALIGNMENT.
+         */
+        [[nodiscard]] bool isDirect() const;
+
+        /**
+         * @brief Get the file descriptor (HANDLE on Windows), it belongs to the SourceFile.
+         */
+        [[nodiscard]] NativeHandle getNativeHandle() const;
+
+    private:
+        std::filesystem::path m_filePath;
+        std::uint64_t m_size = 0;
+        std::filesystem::file_time_type m_lastWriteTime;
+        bool m_direct = false;
+#ifdef _WIN32
+        NativeHandle m_handle = nullptr;
+#else
+        NativeHandle m_handle = -1;
+#endif
+    };
+} // namespace TUS::Chunk::Utility
+
+
+#endif // INCLUDE_CHUNK_UTILITY_SOURCEFILE_H_
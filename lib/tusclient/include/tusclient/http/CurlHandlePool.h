@@ -0,0 +1,60 @@
+#ifndef INCLUDE_HTTP_CURLHANDLEPOOL_H_
+#define INCLUDE_HTTP_CURLHANDLEPOOL_H_
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <curl/curl.h>
+#include <mutex>
+#include <vector>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Http {
+    /**
+     * @brief Pool of reusable curl easy handles.
+     * A released handle is reset with curl_easy_reset, which keeps its connection and DNS caches,
+     * so the next request to the same host does not need a new TCP connection or TLS handshake.
+     */
+    class EXPORT_LIBTUSCLIENT CurlHandlePool {
+    public:
+        static constexpr size_t DEFAULT_MAX_IDLE_HANDLES = 32;
+
+        explicit CurlHandlePool(size_t maxIdleHandles = DEFAULT_MAX_IDLE_HANDLES);
+
+        ~CurlHandlePool();
+
+        CurlHandlePool(const CurlHandlePool &) = delete;
+
+        CurlHandlePool &operator=(const CurlHandlePool &) = delete;
+
+        /**
+         * @brief Get a handle from the pool, a new one is created if the pool is empty.
+         * @return The handle, nullptr if curl could not create it
+         */
+        CURL *acquire();
+
+        /**
+         * @brief Give a handle back to the pool, the handle is reset before it is reused.
+         * If the pool already holds the maximum number of idle handles the handle is destroyed.
+         */
+        void release(CURL *curl);
+
+        /**
+         * @brief Destroy all the idle handles
+         */
+        void clear();
+
+        [[nodiscard]] size_t getIdleHandles() const;
+
+    private:
+        const size_t m_maxIdleHandles;
+        std::vector<CURL *> m_idleHandles;
+        mutable std::mutex m_mutex;
+    };
+}
+
+
+#endif // INCLUDE_HTTP_CURLHANDLEPOOL_H_
@@ -0,0 +1,69 @@
+#ifndef INCLUDE_HTTP_HEADERLIST_H_
+#define INCLUDE_HTTP_HEADERLIST_H_
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Http {
+    /**
+     * @brief The headers of a request, stored in insertion order in a contiguous array.
+     * A request has a handful of headers, a linear search is cheaper than a tree and the headers
+     * are passed to curl without sorting. The names are compared case-insensitively.
+     */
+    class EXPORT_LIBTUSCLIENT HeaderList {
+    public:
+        using Header = std::pair<std::string, std::string>;
+        using const_iterator = std::vector<Header>::const_iterator;
+
+        HeaderList() = default;
+
+        HeaderList(std::initializer_list<Header> headers);
+
+        /**
+         * @brief Convert the headers of the previous map based interface
+         */
+        HeaderList(const std::map<std::string, std::string> &headers);
+
+        /**
+         * @brief Add a header, or replace the value of a header with the same name
+         */
+        void set(std::string_view name, std::string value);
+
+        /**
+         * @brief Get the value of a header
+         * @return The value, empty if the header is missing
+         */
+        [[nodiscard]] std::string_view get(std::string_view name) const;
+
+        [[nodiscard]] bool contains(std::string_view name) const;
+
+        [[nodiscard]] size_t size() const;
+
+        [[nodiscard]] bool empty() const;
+
+        [[nodiscard]] const_iterator begin() const;
+
+        [[nodiscard]] const_iterator end() const;
+
+    private:
+        static constexpr size_t INITIAL_CAPACITY = 8;
+
+        [[nodiscard]] const Header *find(std::string_view name) const;
+
+        std::vector<Header> m_headers;
+    };
+}
+
+
+#endif // INCLUDE_HTTP_HEADERLIST_H_
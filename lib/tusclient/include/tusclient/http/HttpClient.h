@@ -5,37 +5,70 @@
  * This file is part of libtusclient, licensed under the MIT License.
  * See the LICENSE file in the project root for more information.
  */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
-#include <queue>
 #include <functional>
 #include <curl/curl.h>
 #include <memory>
-#include <mutex>
 
 #include "libtusclient.h"
 #include "IHttpClient.h"
 #include "http/RequestTask.h"
+#include "http/TransportContext.h"
 #include "logging/ILogger.h"
 #include "Request.h"
 
 
 namespace TUS::Http {
-    struct EXPORT_LIBTUSCLIENT Progress {
-        char *data;
-        size_t size;
+    /**
+     * @brief HTTP version used by the requests of a HttpClient
+     */
+    enum class EXPORT_LIBTUSCLIENT HttpVersion {
+        _NONE, /* no request has completed yet */
+        _HTTP_1_0,
+        _HTTP_1_1,
+        _HTTP_2, /* HTTP/2 negotiated with the server over TLS, HTTP/1.1 for the plain connections */
+        _HTTP_2_PRIOR_KNOWLEDGE, /* HTTP/2 without negotiation, also over plain connections (h2c) */
     };
 
     /**
      * @brief Represents a HTTP client
+     *
+     * The requests are executed by a curl multi handle, up to getMaxConcurrentTransfers() transfers
+     * are in flight at the same time. The client can be shared between threads: every thread that
+     * calls execute() waits for its own requests, while one of the waiting threads drives the
+     * transfers of all of them.
+     * The curl handles are taken from a pool and the connections are kept alive, consecutive
+     * requests to the same server reuse the same connection.
+     * The multi handle, the pools and the caches belong to a TransportContext: by default every
+     * client has its own, a context passed to the constructor is shared with the other clients
+     * attached to it.
+     * With HTTP/2 the requests to the same server are multiplexed as streams of a single
+     * connection, up to getMaxConcurrentStreams() streams per connection.
      */
     class EXPORT_LIBTUSCLIENT HttpClient : public IHttpClient {
     public:
+        static constexpr size_t DEFAULT_MAX_CONCURRENT_TRANSFERS = TransportContext::DEFAULT_MAX_CONCURRENT_TRANSFERS;
+
         HttpClient();
 
         explicit HttpClient(std::unique_ptr<TUS::Logging::ILogger> logger);
 
+        /**
+         * @brief Create a client that performs its requests in a shared transport context
+         * @param logger The logger, it can be nullptr
+         * @param context The context, a private one is created if it is nullptr
+         */
+        HttpClient(std::unique_ptr<TUS::Logging::ILogger> logger, std::shared_ptr<TransportContext> context);
+
         ~HttpClient() override;
 
+        HttpClient(const HttpClient &) = delete;
+
+        HttpClient &operator=(const HttpClient &) = delete;
+
         IHttpClient *get(Request request) override;
 
         IHttpClient *post(Request request) override;
@@ -52,9 +85,12 @@ namespace TUS::Http {
 
         IHttpClient *abortAll() override;
 
+        IHttpClient *abort(const std::string &tag) override;
+
         /**
          * @brief Execute the requests in the queue
-         * it start a new thread that will execute the requests, if the thread is already running it will do nothing
+         * The calling thread blocks until all the requests it queued have completed, the callbacks
+         * of these requests are invoked on the calling thread.
          */
         IHttpClient *execute() override;
 
@@ -62,18 +98,76 @@ namespace TUS::Http {
 
         bool isAuthenticated() override;
 
+        /**
+         * @brief Set the maximum number of transfers that are performed at the same time,
+         * the other requests wait in the queue. The limit applies to all the clients of the context.
+         * @param maxTransfers The number of transfers, at least 1
+         */
+        void setMaxConcurrentTransfers(size_t maxTransfers);
+
+        [[nodiscard]] size_t getMaxConcurrentTransfers() const;
+
+        /**
+         * @brief Get how many connections were opened and how many requests reused a connection
+         * in the transport context of the client
+         */
+        [[nodiscard]] ConnectionStats getConnectionStats() const;
+
+        [[nodiscard]] std::shared_ptr<TransportContext> getTransportContext() const;
+
+        /**
+         * @brief Set the HTTP version of the next requests, by default HTTP/2 is used when the
+         * server supports it over TLS. Without HTTP/2 support in libcurl the negotiated HTTP/2 falls back to
+         * HTTP/1.1 with a warning, and the requests with prior knowledge throw std::runtime_error.
+         */
+        void setHttpVersion(HttpVersion version);
+
+        [[nodiscard]] HttpVersion getHttpVersion() const;
+
+        /**
+         * @brief Get the HTTP version used by the last completed request of the client
+         * @return HttpVersion::_HTTP_2 when the request was sent as an HTTP/2 stream
+         */
+        [[nodiscard]] HttpVersion getNegotiatedHttpVersion() const;
+
+        /**
+         * @brief Set the maximum number of requests multiplexed over one HTTP/2 connection
+         * of the transport context.
+         */
+        void setMaxConcurrentStreams(size_t maxStreams);
+
+        [[nodiscard]] size_t getMaxConcurrentStreams() const;
+
         static string convertHttpMethodToString(HttpMethod method);
 
+        /**
+         * @brief Get the status code of the last status line of a raw header block
+         * @return The status code, -1 if there is no status line
+         */
         static int getHttpReturnCode(const std::string &header);
 
     private:
-        void setupCURLRequest(CURL *curl, HttpMethod method, const Request &request) const;
+        static constexpr long UPLOAD_BUFFER_SIZE = 512 * 1024;
+        static constexpr std::chrono::milliseconds PENDING_BODY_DELAY{1}; /* a body still being read is polled */
 
-        IHttpClient *sendRequest(HttpMethod method, const Request &request);
+        curl_slist *setupCURLRequest(CURL *curl, HttpMethod method, const Request &request) const;
 
-        std::queue<RequestTask> m_requestsQueue;
-        bool m_abort = false;
-        std::mutex m_queueMutex; // Mutex to protect shared resources
+        IHttpClient *sendRequest(HttpMethod method, Request &&request);
+
+        /**
+         * @brief Invoke the callbacks of a finished transfer and release its curl handle.
+         */
+        void dispatch(std::unique_ptr<RequestTask> task);
+
+        /**
+         * @brief Convert a CURL_HTTP_VERSION_* value reported by curl
+         */
+        static HttpVersion toHttpVersion(long curlVersion);
+
+        std::shared_ptr<TransportContext> m_context;
+        std::atomic<HttpVersion> m_httpVersion{HttpVersion::_HTTP_2};
+        std::atomic<HttpVersion> m_negotiatedHttpVersion{HttpVersion::_NONE};
+        mutable std::atomic<bool> m_http2Unsupported{false}; /* the fallback to HTTP/1.1 is logged once */
         std::shared_ptr<TUS::Logging::ILogger> m_logger;
         std::string m_token = "";
 
@@ -82,23 +176,51 @@ namespace TUS::Http {
          * @param ptr is the pointer to the data
          * @param size is the size of the data
          * @param nmemb  the size of the data
-         * @param data is the data
+         * @param data is the Response the body is appended to
          * @return size_t
          */
-        static size_t writeDataCallback(void *ptr, size_t size, size_t nmemb, std::string *data);
+        static size_t writeDataCallback(void *ptr, size_t size, size_t nmemb, Response *data);
+
+        /**
+         * @brief Callback function that parses a header line of the response while it is received
+         * @param buffer is the header line, it is not null terminated
+         * @param size is always 1
+         * @param nitems is the length of the line
+         * @param response is the Response of the request
+         * @return the number of bytes handled
+         */
+        static size_t headerCallback(char *buffer, size_t size, size_t nitems, Response *response);
 
         /**
-         * @brief Callback function for the progress of the request
-         * @param clientp is a pointer to the client
+         * @brief Callback function that gives curl the next bytes of a body source
+         * @param buffer is the curl upload buffer
+         * @param size is the size of an item
+         * @param nitems is the number of items that fit in the buffer
+         * @param userdata is the RequestTask being sent
+         * @return the number of bytes written in the buffer, 0 at the end of the body
+         */
+        static size_t readBodyCallback(char *buffer, size_t size, size_t nitems, void *userdata);
+
+        /**
+         * @brief Callback function used by curl to rewind a body source, e.g. when a request is resent
+         * @param userdata is the RequestTask being sent
+         * @param offset is the new position
+         * @param origin is SEEK_SET, SEEK_CUR or SEEK_END
+         * @return CURL_SEEKFUNC_OK or CURL_SEEKFUNC_FAIL
+         */
+        static int seekBodyCallback(void *userdata, curl_off_t offset, int origin);
+
+        /**
+         * @brief Callback function for the progress of the request, it updates the Progress of the request
+         * @param clientp is the RequestTask being transferred
          * @param dltotal is the total size of the download
          * @param dlnow is the current size of the download
          * @param ultotal is the total size of the upload
          * @param ulnow is the current size of the upload
          * @return int (0=ok, 1=abort)
          */
-        static int progressCallback(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow);
-
-        std::shared_ptr<string> m_buffer;
+        static int progressCallback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
+                                    curl_off_t ulnow);
     };
 }
 
@@ -24,49 +24,49 @@ namespace TUS::Http {
     public:
         /**
          * @brief Perform a GET request.
-         * @param request The request to perform.
+         * @param request The request to perform, the client takes it over until it completes.
          * @return A pointer to the HTTP client.
          */
         virtual IHttpClient *get(Request request) = 0;
 
         /**
          * @brief Perform a POST request.
-         * @param request The request to perform.
+         * @param request The request to perform, the client takes it over until it completes.
          * @return A pointer to the HTTP client.
          */
         virtual IHttpClient *post(Request request) = 0;
 
         /**
          * @brief Perform a PUT request.
-         * @param request The request to perform.
+         * @param request The request to perform, the client takes it over until it completes.
          * @return A pointer to the HTTP client.
          */
         virtual IHttpClient *put(Request request) = 0;
 
         /**
          * @brief Perform a PATCH request.
-         * @param request The request to perform.
+         * @param request The request to perform, the client takes it over until it completes.
          * @return A pointer to the HTTP client.
          */
         virtual IHttpClient *patch(Request request) = 0;
 
         /**
          * @brief Perform a DELETE request.
-         * @param request The request to perform.
+         * @param request The request to perform, the client takes it over until it completes.
          * @return A pointer to the HTTP client.
          */
         virtual IHttpClient *del(Request request) = 0;
 
         /**
          * @brief Perform a HEAD request.
-         * @param request The request to perform.
+         * @param request The request to perform, the client takes it over until it completes.
          * @return A pointer to the HTTP client.
          */
         virtual IHttpClient *head(Request request) = 0;
 
         /**
          * @brief Perform an OPTIONS request.
-         * @param request The request to perform.
+         * @param request The request to perform, the client takes it over until it completes.
          * @return A pointer to the HTTP client.
          */
         virtual IHttpClient *options(Request request) = 0;
@@ -76,6 +76,17 @@ namespace TUS::Http {
          */
         virtual IHttpClient *abortAll() = 0;
 
+        /**
+         * @brief Abort the requests with the given tag, requests with other tags are not affected.
+         * @param tag The tag of the requests to abort.
+         */
+        virtual IHttpClient *abort(const std::string &tag) = 0;
+
+        /**
+         * @brief Execute the queued requests.
+         * It returns when all the requests queued by the calling thread have completed and their
+         * callbacks have been invoked.
+         */
         virtual IHttpClient *execute() = 0;
 
         virtual ~IHttpClient()=default;
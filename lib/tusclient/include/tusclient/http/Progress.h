@@ -0,0 +1,78 @@
+#ifndef INCLUDE_HTTP_PROGRESS_H_
+#define INCLUDE_HTTP_PROGRESS_H_
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <atomic>
+#include <cstdint>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Http {
+    /**
+     * @brief Byte counters of the requests that share it, updated by the http client while the
+     * transfers run.
+     *
+     * The counters are atomics written from the curl transfer callback, they can be read at any
+     * time from any thread without locking. The upload speed is sampled at most every
+     * SPEED_SAMPLE_INTERVAL_MS and smoothed with an exponential moving average.
+     */
+    class EXPORT_LIBTUSCLIENT Progress {
+    public:
+        static constexpr int64_t SPEED_SAMPLE_INTERVAL_MS = 200;
+        static constexpr double SPEED_SMOOTHING = 0.5; /* weight of the last sample */
+
+        /**
+         * @brief Record the state of the running request, as reported by curl
+         */
+        void update(uint64_t uploadNow, uint64_t uploadTotal, uint64_t downloadNow, uint64_t downloadTotal);
+
+        /**
+         * @brief Count bytes sent since the last call, they are added to the total and to the speed.
+         * A call with 0 bytes lets the speed decay while a transfer is stalled.
+         */
+        void addUploadedBytes(uint64_t bytes);
+
+        /**
+         * @brief Forget the counters of the last request, the total and the speed are kept
+         */
+        void reset();
+
+        /**
+         * @brief Get the bytes of the body of the running request that have been sent
+         */
+        [[nodiscard]] uint64_t getUploadedBytes() const;
+
+        [[nodiscard]] uint64_t getUploadTotal() const;
+
+        [[nodiscard]] uint64_t getDownloadedBytes() const;
+
+        [[nodiscard]] uint64_t getDownloadTotal() const;
+
+        /**
+         * @brief Get the bytes sent by all the requests that used these counters
+         */
+        [[nodiscard]] uint64_t getTotalUploadedBytes() const;
+
+        /**
+         * @brief Get the upload speed in bytes per second, 0 before the first sample
+         */
+        [[nodiscard]] double getUploadSpeed() const;
+
+    private:
+        std::atomic<uint64_t> m_uploadNow{0};
+        std::atomic<uint64_t> m_uploadTotal{0};
+        std::atomic<uint64_t> m_downloadNow{0};
+        std::atomic<uint64_t> m_downloadTotal{0};
+        std::atomic<uint64_t> m_totalUploaded{0};
+        std::atomic<int64_t> m_sampleTime{0}; /* steady clock nanoseconds of the last speed sample */
+        std::atomic<uint64_t> m_sampleBytes{0}; /* value of m_totalUploaded at the last speed sample */
+        std::atomic<double> m_uploadSpeed{0};
+    };
+}
+
+
+#endif // INCLUDE_HTTP_PROGRESS_H_
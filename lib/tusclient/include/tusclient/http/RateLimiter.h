@@ -0,0 +1,132 @@
+#ifndef INCLUDE_HTTP_RATELIMITER_H_
+#define INCLUDE_HTTP_RATELIMITER_H_
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Http {
+    /**
+     * @brief A token bucket limiting the bytes sent per second, nested in the bucket of its parent.
+     *
+     * The buckets form a hierarchy: each TusClient has one, its parent is the bucket of the host of the upload and
+     * the parent of the hosts is the global bucket of the process. The read callback of the http client takes the
+     * bytes of a request body from the bucket of the request, they are taken from every level at once: a transfer
+     * sends no faster than the lowest limit of its chain, and the transfers sharing a bucket share its rate
+     * whatever the thread or the connection they run on. When a bucket is empty the transfer is paused, not the
+     * thread driving it, and resumed once the bucket has refilled.
+     * The limits can be changed at any time, the next bytes read use them. While no level of a chain has a limit,
+     * the bytes are granted without locking the buckets.
+     */
+    class EXPORT_LIBTUSCLIENT RateLimiter {
+    public:
+        static constexpr uint64_t UNLIMITED = 0;
+
+        /**
+         * @brief The smallest grant of a limited bucket, unless fewer bytes are asked: a slow limit sends fewer
+         * and larger blocks instead of a trickle of small TCP segments.
+         */
+        static constexpr size_t MIN_GRANT = 16 * 1024;
+
+        static constexpr std::chrono::milliseconds DEFAULT_BURST_DURATION{100};
+
+        /**
+         * @param bytesPerSecond The limit of this bucket, UNLIMITED to only apply the limits of the parents
+         * @param parent The bucket of the level above, e.g. the host of the upload
+         */
+        explicit RateLimiter(uint64_t bytesPerSecond = UNLIMITED, std::shared_ptr<RateLimiter> parent = nullptr);
+
+        /**
+         * @brief Change the limit, the transfers running use it for their next bytes.
+         * @param bytesPerSecond The limit, UNLIMITED to remove it
+         * @param burst The bytes that can be sent at once after an idle period, 0 for DEFAULT_BURST_DURATION of
+         * the limit
+         */
+        void setRate(uint64_t bytesPerSecond, uint64_t burst = 0);
+
+        [[nodiscard]] uint64_t getRate() const;
+
+        [[nodiscard]] uint64_t getBurst() const;
+
+        [[nodiscard]] const std::shared_ptr<RateLimiter> &getParent() const;
+
+        /**
+         * @brief Take up to the given bytes from this bucket and from its parents.
+         * @return The bytes that can be sent now, 0 if a bucket has not refilled enough
+         */
+        size_t acquire(size_t bytes);
+
+        /**
+         * @brief Give back bytes taken by acquire() but not sent, e.g. the source returned fewer bytes
+         */
+        void release(size_t bytes);
+
+        /**
+         * @brief Get the time until acquire() grants the given bytes, or MIN_GRANT of them, at every level
+         */
+        [[nodiscard]] std::chrono::nanoseconds getDelay(size_t bytes) const;
+
+        /**
+         * @brief Get the bytes taken from this bucket, by the requests using it and by its children
+         */
+        [[nodiscard]] uint64_t getAcquiredBytes() const;
+
+        /**
+         * @brief Get the bucket of the process, the parent of the buckets of the hosts. It is unlimited until
+         * setRate() is called.
+         */
+        static const std::shared_ptr<RateLimiter> &global();
+
+        /**
+         * @brief Get the bucket of the host and port of a url, its parent is the global bucket. The uploads to the
+         * same host share it, it is unlimited until setRate() is called.
+         * The bucket lives as long as it is held: by the clients uploading to the host, whose buckets are its
+         * children, and by the callers of forHost(). A limit set on it is kept between the uploads only while the
+         * caller that set it keeps the bucket, once nothing holds it the next call creates an unlimited one.
+         */
+        static std::shared_ptr<RateLimiter> forHost(const std::string &url);
+
+    private:
+        /**
+         * @brief Add the tokens earned since the last refill, the mutex must be held
+         */
+        void refill(std::chrono::steady_clock::time_point now);
+
+        /**
+         * @brief Check if this bucket or one of its parents has a limit, without locking them
+         */
+        [[nodiscard]] bool isLimited() const;
+
+        /**
+         * @brief Lock this bucket then its parents up to the root, the order every caller locks them in, and take
+         * the bytes granted by every level
+         * @param granted The bytes granted by the levels below
+         * @param minimum The smallest grant accepted by the levels below
+         * @return The bytes taken, 0 if a level has not refilled enough
+         */
+        size_t acquireLocked(size_t granted, size_t minimum, std::chrono::steady_clock::time_point now);
+
+        mutable std::mutex m_mutex;
+        uint64_t m_rate;
+        uint64_t m_burst = 0;
+        double m_tokens = 0;
+        std::chrono::steady_clock::time_point m_lastRefill;
+        const std::shared_ptr<RateLimiter> m_parent;
+        std::atomic<bool> m_limited{false}; /* m_rate is not UNLIMITED, read without the mutex */
+        std::atomic<uint64_t> m_acquired{0};
+    };
+}
+
+
+#endif // INCLUDE_HTTP_RATELIMITER_H_
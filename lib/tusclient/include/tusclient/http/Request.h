@@ -6,9 +6,16 @@
  * This file is part of libtusclient, licensed under the MIT License.
  * See the LICENSE file in the project root for more information.
  */
+#include <memory>
 #include <string>
+#include <string_view>
 #include <map>
 #include "libtusclient.h"
+#include "http/HeaderList.h"
+#include "http/Progress.h"
+#include "http/RateLimiter.h"
+#include "http/RequestBody.h"
+#include "http/Response.h"
 #include <functional>
 using std::string;
 using std::map;
@@ -28,11 +35,17 @@ namespace TUS::Http {
 
     /**
      * @brief Represents a HTTP request
+     *
+     * A request is move-only: it is built by the caller and moved into the http client, which
+     * keeps it until the transfer completes. The accessors return references and views.
      */
     class EXPORT_LIBTUSCLIENT Request {
     public:
-        using SuccessCallback = std::function<void(std::string header, std::string data)>;
-        using ErrorCallback = std::function<void(std::string header, std::string data)>;
+        /**
+         * @brief Callbacks invoked when the request completes, the response is only valid during the call
+         */
+        using SuccessCallback = std::function<void(const Response &response)>;
+        using ErrorCallback = std::function<void(const Response &response)>;
 
         Request();
 
@@ -42,26 +55,27 @@ namespace TUS::Http {
 
         Request(std::string url, std::string body, HttpMethod method);
 
-        Request(std::string url, std::string body, HttpMethod method, map<string, string> headers);
+        Request(std::string url, std::string body, HttpMethod method, HeaderList headers);
 
-        Request(std::string url, std::string body, HttpMethod method, map<string, string> headers,
+        Request(std::string url, std::string body, HttpMethod method, HeaderList headers,
                 SuccessCallback onSuccessCallback);
 
-        Request(std::string url, std::string body, HttpMethod method, map<string, string> headers,
+        Request(std::string url, std::string body, HttpMethod method, HeaderList headers,
                 SuccessCallback onSuccessCallback, ErrorCallback onErrorCallback);
 
-        /**
-         * @brief Copy constructor
-         */
-        Request(const Request &request);
+        Request(const Request &) = delete;
+
+        Request &operator=(const Request &) = delete;
+
+        Request(Request &&) noexcept = default;
 
-        Request &operator=(const Request &request);
+        Request &operator=(Request &&) noexcept = default;
 
         /**
          * @brief Add a header to the request
          * @param header The header to be added
          */
-        void addHeader(const std::string &key, const std::string &value);
+        void addHeader(std::string_view key, std::string value);
 
         /**
          * @brief Add the Authorization header to the request
@@ -69,30 +83,71 @@ namespace TUS::Http {
          */
         void autorizationHeader(const std::string &berearToken);
 
-        [[nodiscard]] std::string getUrl() const;
+        [[nodiscard]] const std::string &getUrl() const;
 
-        [[nodiscard]] std::string getBody() const;
+        [[nodiscard]] std::string_view getBody() const;
 
         [[nodiscard]] HttpMethod getMethod() const;
 
-        [[nodiscard]] map<string, string> getHeaders() const;
+        /**
+         * @brief Send the body from a window of a source instead of the body string,
+         * the bytes are read from the source while the request is transferred.
+         * @param body The source, the offset of the first byte and the number of bytes to send,
+         * or a view of memory created with RequestBody::view()
+         */
+        void setBodySource(RequestBody body);
+
+        [[nodiscard]] const RequestBody &getBodySource() const;
+
+        [[nodiscard]] bool hasBodySource() const;
+
+        [[nodiscard]] const HeaderList &getHeaders() const;
 
         void setOnSuccessCallback(SuccessCallback onSuccessCallback);
 
         void setOnErrorCallback(ErrorCallback onErrorCallback);
 
-        [[nodiscard]] SuccessCallback getOnSuccessCallback() const;
+        [[nodiscard]] const SuccessCallback &getOnSuccessCallback() const;
+
+        [[nodiscard]] const ErrorCallback &getOnErrorCallback() const;
 
-        [[nodiscard]] ErrorCallback getOnErrorCallback() const;
+        /**
+         * @brief Set the counters updated while the request is transferred, they can be shared
+         * by the consecutive requests of an upload
+         */
+        void setProgress(std::shared_ptr<Progress> progress);
+
+        [[nodiscard]] const std::shared_ptr<Progress> &getProgress() const;
+
+        /**
+         * @brief Set the bucket the bytes of the body are taken from while it is sent, null to send it at full speed
+         */
+        void setRateLimiter(std::shared_ptr<RateLimiter> rateLimiter);
+
+        [[nodiscard]] const std::shared_ptr<RateLimiter> &getRateLimiter() const;
+
+        /**
+         * @brief Set the tag of the request, requests with the same tag can be aborted together
+         * @param tag The tag, usually the identifier of the upload that created the request
+         */
+        void setTag(std::string tag);
+
+        [[nodiscard]] const std::string &getTag() const;
 
     private:
         std::string url;
         std::string body;
+        RequestBody m_bodySource;
         HttpMethod method;
-        map<string, string> headers;
+        HeaderList headers;
         SuccessCallback m_onSuccessCallback;
         ErrorCallback m_onErrorCallback;
+        std::shared_ptr<Progress> m_progress;
+        std::shared_ptr<RateLimiter> m_rateLimiter;
+        std::string m_tag;
+
 
+        void setDefaultContentType();
 
         static SuccessCallback defaultSuccessCallback();
 
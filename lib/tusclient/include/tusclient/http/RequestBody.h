@@ -0,0 +1,101 @@
+#ifndef INCLUDE_HTTP_REQUESTBODY_H_
+#define INCLUDE_HTTP_REQUESTBODY_H_
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Http {
+    /**
+     * @brief Source of the bytes of a request body.
+     * The http client pulls the bytes from the source while the request is sent, so the body
+     * does not have to be copied in memory before the request is queued.
+     */
+    class EXPORT_LIBTUSCLIENT IBodySource {
+    public:
+        /**
+         * @brief Returned by read() when the bytes are not available yet, the transfer is paused and reads them
+         * again a moment later instead of blocking the thread driving the other transfers
+         */
+        static constexpr size_t PENDING = SIZE_MAX;
+
+        virtual ~IBodySource() = default;
+
+        /**
+         * @brief Copy the bytes of the source starting at offset into the buffer.
+         * @param offset The position of the first byte to read
+         * @param buffer The destination
+         * @param size The maximum number of bytes to copy
+         * @return The number of bytes copied, 0 at the end of the source, PENDING if they are not available yet
+         */
+        virtual size_t read(uint64_t offset, char *buffer, size_t size) = 0;
+
+        /**
+         * @brief Get the number of bytes of the source
+         */
+        [[nodiscard]] virtual uint64_t size() const = 0;
+    };
+
+    /**
+     * @brief Body source that reads from a file on disk.
+     */
+    class EXPORT_LIBTUSCLIENT FileBodySource : public IBodySource {
+    public:
+        explicit FileBodySource(std::filesystem::path filePath);
+
+        size_t read(uint64_t offset, char *buffer, size_t size) override;
+
+        [[nodiscard]] uint64_t size() const override;
+
+    private:
+        const std::filesystem::path m_filePath;
+        const uint64_t m_size;
+        std::ifstream m_file;
+        std::mutex m_mutex;
+    };
+
+    /**
+     * @brief Body source over a buffer owned by the caller.
+     * The buffer is not copied, it must stay valid until the request has completed.
+     */
+    class EXPORT_LIBTUSCLIENT BufferBodySource : public IBodySource {
+    public:
+        BufferBodySource(const void *data, size_t size);
+
+        size_t read(uint64_t offset, char *buffer, size_t size) override;
+
+        [[nodiscard]] uint64_t size() const override;
+
+    private:
+        const char *m_data;
+        const size_t m_size;
+    };
+
+    /**
+     * @brief The body of a request as a window of length bytes of a source, starting at offset.
+     * A body created with view() borrows the memory of the caller instead of using a source.
+     */
+    struct EXPORT_LIBTUSCLIENT RequestBody {
+        std::shared_ptr<IBodySource> source;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        const char *data = nullptr; /* the borrowed bytes, used when there is no source */
+
+        /**
+         * @brief Borrow size bytes of memory, they must stay valid until the request has completed
+         */
+        static RequestBody view(const void *data, size_t size);
+    };
+}
+
+
+#endif // INCLUDE_HTTP_REQUESTBODY_H_
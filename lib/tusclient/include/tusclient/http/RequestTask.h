@@ -5,17 +5,44 @@
  * This file is part of libtusclient, licensed under the MIT License.
  * See the LICENSE file in the project root for more information.
  */
+#include <atomic>
+#include <chrono>
 #include <curl/curl.h>
+#include <string>
+#include <thread>
 
 #include "Request.h"
+#include "Response.h"
 #include "libtusclient.h"
 
 
 namespace TUS::Http {
+    class IHttpClient;
+
+    /**
+     * @brief A request queued in a TransportContext together with its transfer state.
+     * The task owns the header list passed to curl and the buffers the response is written to,
+     * so it must stay at the same address while the transfer is running.
+     */
     struct EXPORT_LIBTUSCLIENT RequestTask : public Request {
         CURL *curl;
+        curl_slist *headers = nullptr;
+        std::thread::id owner; /* the thread that queued the request, it receives the callbacks */
+        const IHttpClient *client = nullptr; /* the client that queued the request, nullptr once it is detached */
+        uint64_t bodyPosition = 0; /* bytes of the body source already passed to curl */
+        uint64_t reportedUpload = 0; /* bytes sent by curl already added to the progress */
+        Response response; /* filled by the header and write callbacks while the transfer runs */
+        CURLcode result = CURLE_OK;
+        long httpVersion = CURL_HTTP_VERSION_NONE; /* the version used by the transfer, a CURL_HTTP_VERSION_* value */
+        std::atomic<bool> aborted{false}; /* set by abort(), the transfer callback stops the transfer */
+        bool readPaused = false; /* the bucket or the body was empty, the driving thread resumes the transfer */
+        std::chrono::steady_clock::time_point resumeAt; /* when the bucket has refilled or the body is read again */
+
+        RequestTask(Request &&request, CURL *curl);
+
+        RequestTask(const RequestTask &) = delete;
 
-        RequestTask(const Request &request, CURL *curl);
+        RequestTask &operator=(const RequestTask &) = delete;
 
         ~RequestTask();
     };
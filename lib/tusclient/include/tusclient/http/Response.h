@@ -0,0 +1,151 @@
+#ifndef INCLUDE_HTTP_RESPONSE_H_
+#define INCLUDE_HTTP_RESPONSE_H_
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "libtusclient.h"
+
+
+namespace TUS::Http {
+    /**
+     * @brief Response of a HTTP request with a typed view of the headers used by the tus protocol.
+     *
+     * The header lines are parsed one at a time while curl receives them: the known headers are
+     * stored as offsets in the raw header buffer or as integers, the accessors do not allocate.
+     * When a new status line arrives (e.g. after "100 Continue" or a redirect) the headers of
+     * the previous response are discarded.
+     */
+    class EXPORT_LIBTUSCLIENT Response {
+    public:
+        Response() = default;
+
+        /**
+         * @brief Parse a complete response header block, one header per "\r\n" terminated line
+         */
+        explicit Response(std::string_view headers, std::string body = "", long statusCode = 0);
+
+        /**
+         * @brief Add a header line, as it is passed to the curl header callback
+         * @param line The line including the terminating "\r\n"
+         */
+        void parseHeaderLine(std::string_view line);
+
+        /**
+         * @brief Add bytes of the response body
+         */
+        void appendBody(const char *data, size_t size);
+
+        /**
+         * @brief Set the status code reported by curl (CURLINFO_RESPONSE_CODE)
+         */
+        void setStatusCode(long statusCode);
+
+        /**
+         * @brief Get the status code, 0 if no response has been received
+         */
+        [[nodiscard]] long getStatusCode() const;
+
+        /**
+         * @brief Set how the body of the request was sent, as measured by curl
+         * @param bytes The bytes sent (CURLINFO_SIZE_UPLOAD_T)
+         * @param duration The time from the start of the transfer to the end of the response
+         * (CURLINFO_TOTAL_TIME_T - CURLINFO_PRETRANSFER_TIME_T)
+         */
+        void setUploadStats(uint64_t bytes, std::chrono::microseconds duration);
+
+        /**
+         * @brief Get the speed this request sent its body at in bytes per second, 0 without body or timing
+         */
+        [[nodiscard]] double getUploadSpeed() const;
+
+        [[nodiscard]] std::optional<int64_t> getUploadOffset() const;
+
+        [[nodiscard]] std::optional<int64_t> getUploadLength() const;
+
+        /**
+         * @brief Check the Upload-Defer-Length header, the length of the upload is not known yet
+         */
+        [[nodiscard]] bool isUploadLengthDeferred() const;
+
+        [[nodiscard]] std::string_view getLocation() const;
+
+        [[nodiscard]] std::string_view getTusResumable() const;
+
+        [[nodiscard]] std::string_view getTusVersion() const;
+
+        [[nodiscard]] std::string_view getTusExtension() const;
+
+        [[nodiscard]] std::optional<int64_t> getTusMaxSize() const;
+
+        /**
+         * @brief Check if an extension (e.g. "creation-with-upload") is listed in Tus-Extension
+         */
+        [[nodiscard]] bool supportsExtension(std::string_view extension) const;
+
+        /**
+         * @brief Get the Upload-Expires header of the expiration extension, the time the server may drop the upload
+         * @return Empty if the header is missing or is not an HTTP date
+         */
+        [[nodiscard]] std::optional<std::chrono::system_clock::time_point> getUploadExpires() const;
+
+        /**
+         * @brief Find the value of any header, the name is compared case-insensitively
+         * @return The trimmed value, empty if the header is missing
+         */
+        [[nodiscard]] std::string_view getHeader(std::string_view name) const;
+
+        /**
+         * @brief Get the raw header lines of the response, for logging
+         */
+        [[nodiscard]] std::string_view getHeaders() const;
+
+        [[nodiscard]] std::string_view getBody() const;
+
+        /**
+         * @brief Extract the status code from a status line such as "HTTP/1.1 204 No Content"
+         * or "HTTP/2 200"
+         * @return The status code, -1 if the text does not start with a status line
+         */
+        static int parseStatusLine(std::string_view line);
+
+    private:
+        static constexpr size_t HEADERS_CAPACITY = 1024;
+
+        /**
+         * @brief Position of a value in the raw header buffer, the buffer can grow while the
+         * headers are received so pointers would not stay valid
+         */
+        struct Field {
+            uint32_t offset = 0;
+            uint32_t length = 0;
+        };
+
+        [[nodiscard]] std::string_view view(Field field) const;
+
+        void reset();
+
+        std::string m_headers;
+        std::string m_body;
+        long m_statusCode = 0;
+        uint64_t m_uploadedBytes = 0;
+        std::chrono::microseconds m_uploadDuration{0};
+        std::optional<int64_t> m_uploadOffset;
+        std::optional<int64_t> m_uploadLength;
+        std::optional<int64_t> m_tusMaxSize;
+        bool m_uploadLengthDeferred = false;
+        Field m_location;
+        Field m_tusResumable;
+        Field m_tusVersion;
+        Field m_tusExtension;
+    };
+}
+
+#endif // INCLUDE_HTTP_RESPONSE_H_
@@ -0,0 +1,173 @@
+#ifndef INCLUDE_HTTP_TRANSPORTCONTEXT_H_
+#define INCLUDE_HTTP_TRANSPORTCONTEXT_H_
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <curl/curl.h>
+
+#include "libtusclient.h"
+#include "http/CurlHandlePool.h"
+#include "http/RequestTask.h"
+#include "logging/ILogger.h"
+
+
+namespace TUS::Http {
+    /**
+     * @brief Number of connections opened by the client and number of requests that reused an
+     * already open connection.
+     */
+    struct EXPORT_LIBTUSCLIENT ConnectionStats {
+        uint64_t newConnections = 0;
+        uint64_t reusedConnections = 0;
+        uint64_t http2Requests = 0; /* requests that were sent as a stream of an HTTP/2 connection */
+    };
+
+    /**
+     * @brief The transport used by one or more HttpClient: a curl multi handle with its connection
+     * pool, the pool of easy handles and a curl share handle for the DNS cache and the TLS sessions.
+     *
+     * Every HttpClient creates a private context, a context created by the application can be
+     * passed to many HttpClient and TusClient so that they resolve each host once, resume the TLS
+     * sessions and reuse the open connections of each other.
+     * The transfers of all the attached clients are performed by the same multi handle, driven by
+     * one waiting thread at a time, because libcurl does not allow a connection cache to be used
+     * by several threads at the same time.
+     */
+    class EXPORT_LIBTUSCLIENT TransportContext {
+    public:
+        static constexpr size_t DEFAULT_MAX_CONCURRENT_TRANSFERS = 16;
+        static constexpr size_t DEFAULT_MAX_CONCURRENT_STREAMS = 100;
+        static constexpr size_t MAX_CONCURRENT_STREAMS = 2147483647;
+
+        TransportContext();
+
+        explicit TransportContext(std::shared_ptr<TUS::Logging::ILogger> logger);
+
+        ~TransportContext();
+
+        TransportContext(const TransportContext &) = delete;
+
+        TransportContext &operator=(const TransportContext &) = delete;
+
+        /**
+         * @brief Get a curl handle for a new request, it uses the DNS cache and TLS sessions of the context
+         */
+        CURL *acquireHandle();
+
+        /**
+         * @brief Give back a handle that is not part of a transfer anymore
+         */
+        void releaseHandle(CURL *curl);
+
+        /**
+         * @brief Queue a request, the transfer starts when a thread waits in nextCompleted()
+         */
+        void enqueue(std::unique_ptr<RequestTask> task);
+
+        /**
+         * @brief Remove the requests of a client that match the predicate, without invoking their callbacks.
+         * The queued requests are dropped, the transfers in flight are interrupted: the transfer callback
+         * stops them at the next block of data and the driving thread removes them from the multi handle.
+         * It does not wait for the transfers, it can be called while another thread is in nextCompleted().
+         */
+        void abort(const IHttpClient *client, const std::function<bool(const RequestTask &)> &predicate);
+
+        /**
+         * @brief Forget all the requests of a client that is being destroyed.
+         * The transfers in flight are interrupted without invoking their callbacks.
+         */
+        void detach(const IHttpClient *client);
+
+        /**
+         * @brief Wait for the next finished request queued by the calling thread through the client.
+         * While waiting the thread may drive the transfers of every client attached to the context.
+         * @return the finished request, nullptr when the thread has no more requests in the context
+         */
+        std::unique_ptr<RequestTask> nextCompleted(const IHttpClient *client);
+
+        /**
+         * @brief Set the maximum number of transfers that are performed at the same time,
+         * the other requests wait in the queue.
+         * @param maxTransfers The number of transfers, at least 1
+         */
+        void setMaxConcurrentTransfers(size_t maxTransfers);
+
+        [[nodiscard]] size_t getMaxConcurrentTransfers() const;
+
+        /**
+         * @brief Set the maximum number of streams that are multiplexed over one HTTP/2 connection,
+         * when the limit is reached the next transfers open a new connection.
+         * The server can announce a lower limit, in that case the limit of the server is used.
+         * @param maxStreams The number of streams, between 1 and MAX_CONCURRENT_STREAMS
+         */
+        void setMaxConcurrentStreams(size_t maxStreams);
+
+        [[nodiscard]] size_t getMaxConcurrentStreams() const;
+
+        /**
+         * @brief Get how many connections were opened and how many requests reused a connection
+         */
+        [[nodiscard]] ConnectionStats getConnectionStats() const;
+
+    private:
+        static constexpr int POLL_TIMEOUT_MS = 100;
+        static constexpr long MAX_CACHED_CONNECTIONS = 64;
+
+        /**
+         * @brief Run one round of the multi handle: start the queued transfers, perform the
+         * pending I/O and move the finished transfers to the completed list.
+         * Only the thread that owns the driver role calls it, the queue mutex must not be held.
+         */
+        void performTransfers();
+
+        /**
+         * @brief Resume the paused transfers whose bucket has refilled or whose body can be read again, only the
+         * thread that owns the driver role calls it after curl_multi_perform(), which may have paused more transfers
+         * @return The time to wait for the sockets before the next paused transfer can be resumed, in ms
+         */
+        int resumePausedTransfers();
+
+        [[nodiscard]] bool hasPendingWork(const IHttpClient *client, std::thread::id owner) const;
+
+        /**
+         * @brief Remove the aborted transfers from the multi handle, the queue mutex must be held
+         */
+        void removeAbortedTransfers();
+
+        static void lockShare(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+
+        static void unlockShare(CURL *handle, curl_lock_data data, void *userptr);
+
+        CURLM *m_multi = nullptr;
+        CURLSH *m_share = nullptr;
+        std::array<std::mutex, CURL_LOCK_DATA_LAST> m_shareMutexes;
+        CurlHandlePool m_handlePool;
+        std::atomic<uint64_t> m_newConnections{0};
+        std::atomic<uint64_t> m_reusedConnections{0};
+        std::atomic<uint64_t> m_http2Requests{0};
+        std::atomic<size_t> m_maxConcurrentStreams{DEFAULT_MAX_CONCURRENT_STREAMS};
+        std::deque<std::unique_ptr<RequestTask> > m_requestsQueue;
+        std::list<std::unique_ptr<RequestTask> > m_inFlight;
+        std::list<std::unique_ptr<RequestTask> > m_completed;
+        size_t m_maxConcurrentTransfers = DEFAULT_MAX_CONCURRENT_TRANSFERS;
+        bool m_driving = false; // true while a thread is running performTransfers()
+        bool m_pendingStreamsLimit = false; // the stream limit is applied by the driving thread
+        mutable std::mutex m_queueMutex;
+        std::condition_variable m_transfersProgressed;
+        std::shared_ptr<TUS::Logging::ILogger> m_logger;
+    };
+}
+
+#endif // INCLUDE_HTTP_TRANSPORTCONTEXT_H_
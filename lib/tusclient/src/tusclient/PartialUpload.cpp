@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <algorithm>
+#include <fmt/core.h>
+
+#include "PartialUpload.h"
+#include "chunk/ChunkWindow.h"
+#include "chunk/TUSChunk.h"
+#include "exceptions/TUSException.h"
+#include "http/HeaderList.h"
+#include "http/IHttpClient.h"
+#include "http/Progress.h"
+#include "http/RateLimiter.h"
+#include "http/Request.h"
+#include "http/RequestBody.h"
+#include "http/Response.h"
+
+using TUS::PartialUpload;
+using TUS::Http::HeaderList;
+using TUS::Http::HttpMethod;
+using TUS::Http::Request;
+using TUS::Http::Response;
+
+PartialUpload::PartialUpload(std::shared_ptr<Http::IHttpClient> httpClient, string url, string tag,
+                             const Chunk::IFileChunker<Chunk::TUSChunk> &chunker, uint64_t start, uint64_t length,
+                             size_t memoryLimit)
+    : m_httpClient(std::move(httpClient)), m_url(std::move(url)), m_tag(std::move(tag)), m_chunker(chunker),
+      m_start(start), m_length(length), m_memoryLimit(memoryLimit),
+      m_progress(std::make_shared<Http::Progress>()) {
+}
+
+PartialUpload::~PartialUpload() = default;
+
+void PartialUpload::create() {
+    HeaderList headers;
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    headers.set("Content-Length", "0");
+    headers.set("Upload-Length", std::to_string(m_length));
+    headers.set("Upload-Concat", "partial");
+    Request request(m_url, "", HttpMethod::_POST, std::move(headers), [this](const Response &response) {
+        const std::string_view location = response.getLocation();
+        const size_t lastSlash = location.find_last_of('/');
+        if (lastSlash == std::string_view::npos || lastSlash + 1 == location.size()) {
+            throw Exceptions::TUSException("Error: The partial upload has no location");
+        }
+        // relative or absolute, the location is resolved against the endpoint like the one of the client
+        m_location = m_url + string(location.substr(lastSlash + 1));
+        m_offset.store(0);
+    });
+    request.setOnErrorCallback([](const Response &response) {
+        throw Exceptions::TUSException(fmt::format("Error: Unable to create a partial upload: {}",
+                                                   response.getBody()));
+    });
+    request.setTag(m_tag);
+    m_httpClient->post(std::move(request));
+    m_httpClient->execute();
+}
+
+bool PartialUpload::resume(const string &location) {
+    m_location = location;
+    try {
+        getUploadInfo();
+    } catch (const Exceptions::TUSException &) {
+        m_location.clear();
+        return false;
+    }
+    return m_offset.load() <= m_length;
+}
+
+void PartialUpload::getUploadInfo() {
+    HeaderList headers;
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    Request request(m_location, "", HttpMethod::_HEAD, std::move(headers), [this](const Response &response) {
+        if (!response.getUploadOffset().has_value()) {
+            throw Exceptions::TUSException("Failed to parse header: missing Upload-Offset");
+        }
+        m_offset.store(static_cast<uint64_t>(*response.getUploadOffset()));
+    });
+    request.setOnErrorCallback([](const Response &) {
+        throw Exceptions::TUSException("Error: Unable to get the offset of the partial upload");
+    });
+    request.setTag(m_tag);
+    m_httpClient->head(std::move(request));
+    m_httpClient->execute();
+}
+
+void PartialUpload::handleUploadConflict(const Response &response) {
+    if (++m_conflicts > MAX_CONFLICTS) {
+        throw Exceptions::TUSException(fmt::format("Error: Too many conflicts on the partial upload at {}: {}",
+                                                   m_start, response.getHeaders()));
+    }
+    // the server can still hold a part of an interrupted PATCH, the next one starts at its offset
+    getUploadInfo();
+}
+
+bool PartialUpload::uploadNextChunk(const std::atomic<TusStatus> &status) {
+    if (m_offset.load() >= m_length || status.load() != TusStatus::UPLOADING) {
+        return false;
+    }
+    if (m_chunkWindow == nullptr) {
+        // the window ends with the range, the chunks of the next range are not read ahead
+        m_chunkWindow = std::make_unique<Chunk::ChunkWindow>(m_chunker, m_start + m_length, m_memoryLimit);
+    }
+    const uint64_t offset = m_offset.load();
+    const uint64_t chunkSize = m_chunkWindow->getChunkSize();
+    const auto chunkNumber = static_cast<int>((m_start + offset) / chunkSize);
+    const uint64_t chunkOffset = m_start + offset - static_cast<uint64_t>(chunkNumber) * chunkSize;
+    const Chunk::TUSChunk &chunk = m_chunkWindow->get(chunkNumber);
+    // the rest of the chunk, sent straight from its buffer
+    const uint64_t size = std::min<uint64_t>(chunk.getChunkSize() - chunkOffset, m_length - offset);
+
+    HeaderList headers;
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    headers.set("Content-Type", "application/offset+octet-stream");
+    headers.set("Content-Length", std::to_string(size));
+    headers.set("Upload-Offset", std::to_string(offset));
+    Request request(m_location, "", HttpMethod::_PATCH, std::move(headers), [this](const Response &response) {
+        if (response.getStatusCode() == 409) {
+            handleUploadConflict(response);
+            return;
+        }
+        if (!response.getUploadOffset().has_value()) {
+            throw Exceptions::TUSException("Failed to parse header: missing Upload-Offset");
+        }
+        m_offset.store(static_cast<uint64_t>(*response.getUploadOffset()));
+        m_conflicts = 0;
+    });
+    request.setOnErrorCallback([this, &status](const Response &response) {
+        if (response.getStatusCode() == 409) {
+            handleUploadConflict(response);
+            return;
+        }
+        if (status.load() == TusStatus::UPLOADING) {
+            throw Exceptions::TUSException(fmt::format("Error: Unable to upload the partial upload at {}",
+                                                       m_start));
+        }
+        // aborted by pause() or cancel()
+    });
+    request.setTag(m_tag);
+    request.setBodySource(Http::RequestBody::view(chunk.getBytes() + chunkOffset, size));
+    request.setProgress(m_progress);
+    request.setRateLimiter(m_rateLimiter);
+    try {
+        m_httpClient->patch(std::move(request));
+        m_httpClient->execute();
+    } catch (...) {
+        m_progress->reset();
+        throw;
+    }
+    m_progress->reset();
+    m_chunkWindow->release(m_start + m_offset.load());
+    if (m_offset.load() >= m_length) {
+        m_chunkWindow.reset();
+        return false;
+    }
+    return status.load() == TusStatus::UPLOADING;
+}
+
+bool PartialUpload::upload(const std::atomic<TusStatus> &status) {
+    while (uploadNextChunk(status)) {
+    }
+    return m_offset.load() >= m_length;
+}
+
+void PartialUpload::cancel() {
+    if (m_location.empty()) {
+        return;
+    }
+    HeaderList headers;
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    Request request(m_location, "", HttpMethod::_DELETE, std::move(headers), [](const Response &) {
+    });
+    // a partial upload already removed by the server is not an error
+    request.setOnErrorCallback([](const Response &) {
+    });
+    request.setTag(m_tag);
+    m_httpClient->del(std::move(request));
+    m_httpClient->execute();
+}
+
+uint64_t PartialUpload::getStart() const {
+    return m_start;
+}
+
+uint64_t PartialUpload::getLength() const {
+    return m_length;
+}
+
+uint64_t PartialUpload::getOffset() const {
+    return m_offset.load();
+}
+
+uint64_t PartialUpload::getBytesInFlight() const {
+    return m_progress->getUploadedBytes();
+}
+
+double PartialUpload::getUploadSpeed() const {
+    return m_progress->getUploadSpeed();
+}
+
+string PartialUpload::getLocation() const {
+    return m_location;
+}
+
+void PartialUpload::setRateLimiter(std::shared_ptr<Http::RateLimiter> rateLimiter) {
+    m_rateLimiter = std::move(rateLimiter);
+}
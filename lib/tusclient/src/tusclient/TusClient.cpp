@@ -4,20 +4,35 @@
  * See the LICENSE file in the project root for more information.
  */
 
+#include <algorithm>
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <charconv>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <thread>
 #include <fmt/core.h>
 
 #include "TusClient.h"
+#include "PartialUpload.h"
 #include "cache/CacheRepository.h"
 #include "cache/TUSFile.h"
+#include "chunk/AdaptiveChunkSizer.h"
+#include "chunk/ChunkBodySource.h"
+#include "chunk/ChunkScheduler.h"
+#include "chunk/ChunkWindow.h"
 #include "chunk/FileChunker.h"
+#include "chunk/IoUringFileChunker.h"
+#include "chunk/MappedFileChunker.h"
+#include "chunk/MemoryChunker.h"
+#include "chunk/SourceFileChunker.h"
+#include "chunk/StreamChunker.h"
 #include "chunk/TUSChunk.h"
 #include "http/HttpClient.h"
+#include "http/Progress.h"
+#include "http/RateLimiter.h"
 #include "logging/GLoggingService.h"
 #include "exceptions/TUSException.h"
 using boost::uuids::random_generator;
@@ -26,24 +41,147 @@ using TUS::TusStatus;
 using TUS::Logging::GLoggingService;
 using TUS::Logging::LogLevel;
 
+namespace {
+    /**
+     * @brief What the endpoints already asked support, the OPTIONS request is sent once per endpoint
+     * and process instead of once per upload
+     */
+    struct ServerCapabilities {
+        bool creationWithUpload = false;
+        bool deferLength = false; /* Creation Defer Length, the length is sent after the upload is created */
+        bool concatenation = false; /* Concatenation, partial uploads are joined into a final one */
+        uint64_t maxSize = 0; /* Tus-Max-Size, 0 when the server does not limit the size */
+    };
+
+    std::mutex serverCapabilitiesMutex;
+    std::map<std::string, ServerCapabilities, std::less<> > serverCapabilities;
+
+    bool containsExtension(std::string_view extensions, std::string_view extension) {
+        while (!extensions.empty()) {
+            const size_t comma = extensions.find(',');
+            std::string_view token = extensions.substr(0, comma);
+            token.remove_prefix(std::min(token.find_first_not_of(' '), token.size()));
+            token.remove_suffix(token.size() - std::min(token.find_last_not_of(' ') + 1, token.size()));
+            if (token == extension) {
+                return true;
+            }
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            extensions.remove_prefix(comma + 1);
+        }
+        return false;
+    }
+
+    ServerCapabilities getServerCapabilities(const TusClient &client) {
+        const std::string url = client.getUrl();
+        {
+            std::lock_guard<std::mutex> lock(serverCapabilitiesMutex);
+            if (const auto it = serverCapabilities.find(url); it != serverCapabilities.end()) {
+                return it->second;
+            }
+        }
+        const auto serverInfo = client.getTusServerInformation();
+        const auto extensions = serverInfo.find("Tus-Extension");
+        if (extensions == serverInfo.end()) {
+            // the server did not answer, it is asked again by the next upload
+            return {};
+        }
+        ServerCapabilities capabilities;
+        capabilities.creationWithUpload = containsExtension(extensions->second, "creation-with-upload");
+        capabilities.deferLength = containsExtension(extensions->second, "creation-defer-length");
+        capabilities.concatenation = containsExtension(extensions->second, "concatenation");
+        if (const auto maxSize = serverInfo.find("Tus-Max-Size"); maxSize != serverInfo.end()) {
+            const std::string &value = maxSize->second;
+            std::from_chars(value.data(), value.data() + value.size(), capabilities.maxSize);
+        }
+        std::lock_guard<std::mutex> lock(serverCapabilitiesMutex);
+        serverCapabilities[url] = capabilities;
+        return capabilities;
+    }
+}
+
 void TusClient::initialize(int chunkSize) {
     sanitizeUrl();
+    m_transferProgress = std::make_shared<TUS::Http::Progress>();
+    m_rateLimiter = std::make_shared<Http::RateLimiter>(Http::RateLimiter::UNLIMITED, Http::RateLimiter::forHost(m_url));
+    if (m_fileChunker == nullptr) {
+        m_chunkSourceType = Chunk::ChunkSourceType::_SOURCE_FILE;
+    }
     createTusFile();
-    m_cacheManager = std::make_unique<TUS::Cache::CacheRepository>(m_appName);
-    m_fileChunker = std::make_unique<TUS::Chunk::FileChunker>(m_appName, getUUIDString(), m_filePath, chunkSize);
+    m_cacheManager = std::make_shared<TUS::Cache::CacheRepository>(m_appName);
+    m_requestedChunkSize = chunkSize;
+    m_chunkMemoryLimit = Chunk::ChunkWindow::DEFAULT_MEMORY_LIMIT;
+    createFileChunker();
+    loadCachedState();
+}
+
+void TusClient::loadCachedState() {
     // update the tusFile with the data from the cache
-    if (m_cacheManager->findByHash(m_tusFile->getIdentificationHash()) !=
-        nullptr) {
-        auto tusFile = m_cacheManager->findByHash(m_tusFile->getIdentificationHash());
+    if (m_tusFile == nullptr) {
+        return;
+    }
+    if (const auto tusFile = m_cacheManager->findByHash(m_tusFile->getIdentificationHash()); tusFile != nullptr) {
         m_tusFile->setUploadOffset(tusFile->getUploadOffset());
         m_tusFile->setLastEdit(tusFile->getLastEdit());
         m_tusFile->setTusIdentifier(tusFile->getTusIdentifier());
         m_tusFile->setResumeFrom(tusFile->getResumeFrom());
         m_tusFile->setChunkNumber(tusFile->getChunkNumber());
+        m_tusFile->setPartials(tusFile->getPartials());
         m_chunkNumber = m_tusFile->getChunkNumber();
     }
 }
 
+void TusClient::createFileChunker() {
+    // the window reads from the chunker, the chunks being read ahead are waited for
+    m_chunkWindow.reset();
+    {
+        std::lock_guard lock(m_partialsMutex);
+        m_partials.clear();
+    }
+    if (!readsFile()) {
+        return; // the chunker of a memory region or of a stream is created with the client
+    }
+    if (m_chunkSourceType == Chunk::ChunkSourceType::_TEMPORARY_FILES) {
+        m_fileChunker = std::make_unique<TUS::Chunk::FileChunker>(m_appName, getUUIDString(), m_filePath,
+                                                                  m_requestedChunkSize);
+    } else if (m_chunkSourceType == Chunk::ChunkSourceType::_MEMORY_MAPPED) {
+        m_fileChunker = std::make_unique<TUS::Chunk::MappedFileChunker>(m_filePath, m_requestedChunkSize);
+    } else if (m_chunkSourceType == Chunk::ChunkSourceType::_IO_URING ||
+               m_chunkSourceType == Chunk::ChunkSourceType::_IO_URING_DIRECT) {
+        m_fileChunker = std::make_unique<TUS::Chunk::IoUringFileChunker>(
+            m_filePath, m_requestedChunkSize, m_chunkSourceType == Chunk::ChunkSourceType::_IO_URING_DIRECT);
+    } else {
+        m_fileChunker = std::make_unique<TUS::Chunk::SourceFileChunker>(m_filePath, m_requestedChunkSize);
+    }
+}
+
+bool TusClient::prepareChunks() {
+    m_chunkWindow.reset();
+    m_chunkNumber = m_fileChunker->chunkFile();
+    if (m_chunkNumber == -1) {
+        m_logger->error("Error: Unable to divide file in chunks");
+        return false;
+    }
+    m_chunkWindow = std::make_unique<Chunk::ChunkWindow>(*m_fileChunker, getSourceSize(), m_chunkMemoryLimit);
+    return true;
+}
+
+bool TusClient::readsFile() const {
+    return m_chunkSourceType != Chunk::ChunkSourceType::_MEMORY &&
+           m_chunkSourceType != Chunk::ChunkSourceType::_STREAM;
+}
+
+uint64_t TusClient::getSourceSize() const {
+    if (m_chunkSourceType == Chunk::ChunkSourceType::_MEMORY) {
+        return static_cast<const Chunk::MemoryChunker &>(*m_fileChunker).getSize();
+    }
+    if (m_chunkSourceType == Chunk::ChunkSourceType::_STREAM) {
+        return Chunk::ChunkWindow::UNKNOWN_SIZE;
+    }
+    return std::filesystem::file_size(m_filePath);
+}
+
 TusClient::TusClient(std::string appName, std::string url, path filePath,
                      const int chunkSize, Logging::LogLevel logLevel)
     : m_url(std::move(url)), m_filePath(std::move(filePath)),
@@ -64,90 +202,200 @@ TusClient::TusClient(std::string appName, std::string url, path filePath,
     initialize(0);
 }
 
+TusClient::TusClient(std::string appName, std::string url, path filePath,
+                     std::shared_ptr<Http::IHttpClient> httpClient, const int chunkSize,
+                     TUS::Logging::LogLevel logLevel)
+    : m_url(std::move(url)), m_filePath(std::move(filePath)),
+      m_status(TusStatus::READY), m_httpClient(std::move(httpClient)),
+      m_logger(std::make_unique<TUS::Logging::GLoggingService>(logLevel)),
+      m_appName(std::move(appName)) {
+    initialize(chunkSize);
+}
+
+TusClient::TusClient(std::string appName, std::string url, path filePath,
+                     std::shared_ptr<Http::TransportContext> context, const int chunkSize,
+                     TUS::Logging::LogLevel logLevel)
+    : m_url(std::move(url)), m_filePath(std::move(filePath)),
+      m_status(TusStatus::READY), m_httpClient(std::make_shared<TUS::Http::HttpClient>(
+          std::make_unique<TUS::Logging::GLoggingService>(logLevel), std::move(context))),
+      m_logger(std::make_unique<TUS::Logging::GLoggingService>(logLevel)),
+      m_appName(std::move(appName)) {
+    initialize(chunkSize);
+}
+
+TusClient::TusClient(std::string appName, std::string url, std::string name,
+                     std::function<size_t(uint8_t *, size_t)> reader, const int chunkSize,
+                     TUS::Logging::LogLevel logLevel)
+    : m_url(std::move(url)), m_filePath(std::move(name)),
+      m_status(TusStatus::READY), m_httpClient(std::make_shared<TUS::Http::HttpClient>(
+          std::make_unique<TUS::Logging::GLoggingService>(logLevel))),
+      m_logger(std::make_unique<TUS::Logging::GLoggingService>(logLevel)),
+      m_appName(std::move(appName)) {
+    m_chunkSourceType = Chunk::ChunkSourceType::_STREAM;
+    m_fileChunker = std::make_unique<Chunk::StreamChunker>(m_filePath.string(), std::move(reader), chunkSize);
+    initialize(chunkSize);
+}
+
+TusClient::TusClient(std::string appName, std::string url, std::string name, std::span<const std::byte> data,
+                     const int chunkSize, TUS::Logging::LogLevel logLevel)
+    : m_url(std::move(url)), m_filePath(std::move(name)),
+      m_status(TusStatus::READY), m_httpClient(std::make_shared<TUS::Http::HttpClient>(
+          std::make_unique<TUS::Logging::GLoggingService>(logLevel))),
+      m_logger(std::make_unique<TUS::Logging::GLoggingService>(logLevel)),
+      m_appName(std::move(appName)) {
+    m_chunkSourceType = Chunk::ChunkSourceType::_MEMORY;
+    m_fileChunker = std::make_unique<Chunk::MemoryChunker>(m_filePath.string(), data, chunkSize);
+    initialize(chunkSize);
+}
+
 TusClient::~TusClient() {
-    m_httpClient->abortAll();
+    m_httpClient->abort(getUUIDString());
+}
+
+TUS::Http::Request TusClient::createRequest(string url, string body, Http::HttpMethod method,
+                                            Http::HeaderList headers, OnSuccessCallback onSuccess,
+                                            OnErrorCallback onError) const {
+    Http::Request request(std::move(url), std::move(body), method, std::move(headers), std::move(onSuccess));
+    if (onError != nullptr) {
+        request.setOnErrorCallback(std::move(onError));
+    }
+    request.setTag(getUUIDString());
+    request.setRateLimiter(m_rateLimiter);
+    return request;
 }
 
 void TusClient::createTusFile() {
     m_tusFile.reset();
     boost::uuids::uuid uuid = random_generator()();
     m_uuid = uuid;
+    if (!readsFile()) {
+        return; // a memory region or a stream cannot be resumed by another process, it is not cached
+    }
     m_tusFile = std::make_unique<TUS::Cache::TUSFile>(m_filePath, m_url,
                                                       m_appName, m_uuid);
 }
 
-std::string extractHeaderValue(const std::string &header,
-                               const std::string &key) {
-    const auto toLower = [](const std::string &s) {
-        std::string result = s;
-        std::ranges::transform(result, result.begin(),
-                               [](unsigned char c) { return std::tolower(c); });
-        return result;
-    };
-
-    std::string keyLower = toLower(key);
-    size_t pos = 0;
-
-    while (pos < header.size()) {
-        size_t lineEnd = header.find("\r\n", pos);
-        if (lineEnd == std::string::npos)
-            lineEnd = header.size();
-
-
-        if (const size_t colonPos = header.find(':', pos); colonPos != std::string::npos && colonPos < lineEnd) {
-            std::string lineKey = header.substr(pos, colonPos - pos);
-            std::string lineValue = header.substr(colonPos + 1, lineEnd - colonPos - 1);
-
-            // Trim spaces helper
-            auto trim = [](std::string &str) {
-                const char *whitespace = " \t";
-                size_t start = str.find_first_not_of(whitespace);
-                size_t end = str.find_last_not_of(whitespace);
-                if (start == std::string::npos) {
-                    str.clear();
-                    return;
-                }
-                str = str.substr(start, end - start + 1);
-            };
-
-            trim(lineKey);
-            trim(lineValue);
+bool TusClient::supportsCreationWithUpload() const {
+    return getServerCapabilities(*this).creationWithUpload;
+}
 
-            if (toLower(lineKey) == keyLower)
-                return lineValue;
-        }
+void TusClient::limitRequestSize() {
+    if (m_chunkSizer != nullptr) {
+        m_chunkSizer->limitMaxSize(getServerCapabilities(*this).maxSize);
+    }
+}
 
-        pos = lineEnd + 2;
+uint64_t TusClient::getRequestSize(uint64_t offset) {
+    const uint64_t chunkSize = m_chunkWindow->getChunkSize();
+    // the chunk is read first, the length of a stream is known once its last chunk is read
+    (void) m_chunkWindow->get(static_cast<int>(offset / chunkSize));
+    const uint64_t chunkEnd = (offset / chunkSize + 1) * chunkSize;
+    const std::optional<uint64_t> length = m_chunkWindow->getFileSize();
+    if (!length.has_value()) {
+        return chunkEnd - offset;
+    }
+    if (m_chunkSizer != nullptr) {
+        // the chunks of the request stay in the window until the server confirms them
+        const uint64_t windowEnd = (offset / chunkSize + m_chunkWindow->getCapacity()) * chunkSize;
+        return std::min({m_chunkSizer->getChunkSize(), windowEnd - offset, *length - offset});
     }
+    // the rest of the chunk, the part of an interrupted PATCH received by the server is not sent again
+    return std::min(chunkEnd, *length) - offset;
+}
 
-    return "";
+TUS::Http::RequestBody TusClient::createChunkBody(uint64_t offset, uint64_t length) {
+    const uint64_t chunkSize = m_chunkWindow->getChunkSize();
+    const auto chunkNumber = static_cast<int>(offset / chunkSize);
+    const uint64_t chunkOffset = offset - static_cast<uint64_t>(chunkNumber) * chunkSize;
+    // the window reads the next chunks while this one is sent
+    const Chunk::TUSChunk &chunk = m_chunkWindow->get(chunkNumber);
+    if (chunkOffset + length <= chunk.getChunkSize()) {
+        // the chunk is sent straight from its buffer, it stays alive until execute() returns
+        return Http::RequestBody::view(chunk.getBytes() + chunkOffset, length);
+    }
+    return {std::make_shared<Chunk::ChunkBodySource>(*m_chunkWindow, offset, length), 0, length};
 }
 
 bool TusClient::upload() {
+    if (!start()) {
+        return false;
+    }
+    if (hasPartials()) {
+        return uploadPartials();
+    }
+    // patch chunks of the file to the server while chunk is not the last one
+    return uploadChunks();
+}
+
+bool TusClient::start() {
     if (m_tusFile == nullptr) {
         createTusFile();
     }
+    {
+        // the ranges of the last upload read from the chunker being divided again
+        std::lock_guard lock(m_partialsMutex);
+        m_partials.clear();
+    }
 
     // chunk the file
-    m_chunkNumber = m_fileChunker->chunkFile();
-    if (m_chunkNumber == -1) {
-        m_logger->error("Error: Unable to divide file in chunks");
+    if (!prepareChunks()) {
         return false;
     }
-    uintmax_t size = std::filesystem::file_size(m_filePath);
-    std::map<std::string, std::string> headers;
-    headers["Tus-Resumable"] = TUS_PROTOCOL_VERSION;
-    headers["Content-Type"] =
-            "application/octet-stream"; // Set the appropriate content type
-    headers["Content-Disposition"] =
-            "attachment; filename=\"" + getFilePath().filename().string() + "\"";
-    headers["Content-Length"] = "0";
-    headers["Upload-Length"] = std::to_string(size);
-    headers["Upload-Metadata"] =
-            "filename " + getFilePath().filename().string();
-    OnSuccessCallback onPostSuccess = [this](const std::string &header,
-                                             [[maybe_unused]] const std::string &data) {
-        m_tusLocation = extractHeaderValue(header, "Location");
+    std::optional<uint64_t> size = m_chunkWindow->getFileSize();
+    if (!size.has_value()) {
+        // a stream that fits in its first chunk is sent like a file
+        (void) m_chunkWindow->get(0);
+        size = m_chunkWindow->getFileSize();
+        if (!size.has_value() && !getServerCapabilities(*this).deferLength) {
+            m_logger->error("Error: The server does not support uploads of unknown length");
+            m_status.store(TusStatus::FAILED);
+            return false;
+        }
+    }
+    m_uploadLength = size.value_or(0);
+    m_uploadLengthDeferred = !size.has_value();
+    if (usesParallelUploads()) {
+        // every range has its own window
+        m_chunkWindow.reset();
+        try {
+            createPartials();
+        } catch (const TUS::Exceptions::TUSException &e) {
+            m_logger->error(e.what());
+            m_status.store(TusStatus::FAILED);
+            return false;
+        }
+        savePartials();
+        m_logger->info("Parallel upload started");
+        return true;
+    }
+    // with Creation With Upload the first chunk is sent by the POST, a file of one chunk needs a single request
+    const bool withUpload = size != 0 && supportsCreationWithUpload();
+    Http::HeaderList headers;
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    headers.set("Content-Type",
+                "application/octet-stream"); // Set the appropriate content type
+    headers.set("Content-Disposition",
+                "attachment; filename=\"" + getFilePath().filename().string() + "\"");
+    headers.set("Content-Length", "0");
+    if (m_uploadLengthDeferred) {
+        headers.set("Upload-Defer-Length", "1");
+    } else {
+        headers.set("Upload-Length", std::to_string(m_uploadLength));
+    }
+    headers.set("Upload-Metadata",
+                "filename " + getFilePath().filename().string());
+    Http::RequestBody firstBody;
+    if (withUpload) {
+        limitRequestSize();
+        const uint64_t firstRequestSize = getRequestSize(0);
+        firstBody = createChunkBody(0, firstRequestSize);
+        headers.set("Content-Type", "application/offset+octet-stream");
+        headers.set("Content-Length", std::to_string(firstRequestSize));
+    }
+    bool firstChunkStored = false;
+    OnSuccessCallback onPostSuccess = [this, withUpload, &firstChunkStored](const Http::Response &response) {
+        m_tusLocation = response.getLocation();
+        updateUploadExpires(response);
         size_t lastSlashPosition = m_tusLocation.find_last_of('/');
         if (lastSlashPosition != std::string::npos) {
             // remove the url from the location
@@ -158,187 +406,480 @@ bool TusClient::upload() {
                             "Please ensure the URL is a complete TUS server endpoint (e.g., 'http://localhost:8080/files/')\n"
                             "Current URL: '{}'\n", m_url) << std::endl;
         }
+        if (withUpload && response.getUploadOffset().has_value()) {
+            // the server stored the first chunk
+            handleSuccessfulUpload(response);
+            firstChunkStored = true;
+        }
     };
-    OnErrorCallback onError = [this]([[maybe_unused]] const std::string &header, const std::string &data) {
+    OnErrorCallback onError = [this](const Http::Response &response) {
+        const std::string data(response.getBody());
         m_logger->error(data);
         m_status.store(TusStatus::FAILED);
         throw TUS::Exceptions::TUSException(data);
     };
     m_logger->debug("Starting new upload");
-    m_httpClient->post(Http::Request(m_url, "",
-                                     TUS::Http::HttpMethod::_POST, headers,
-                                     onPostSuccess, onError));
+    Http::Request request = createRequest(m_url, "", TUS::Http::HttpMethod::_POST, std::move(headers),
+                                          onPostSuccess, onError);
+    if (withUpload) {
+        request.setBodySource(std::move(firstBody));
+        request.setProgress(m_transferProgress);
+        m_chunkOffset.store(0);
+    }
+    m_uploadOffset = 0;
+    m_httpClient->post(std::move(request));
     m_httpClient->execute();
-    m_logger->debug("Getting information about the upload");
-
-    getUploadInfo();
+    m_transferProgress->reset();
+    m_chunkWindow->release(m_uploadOffset);
+    // with the first chunk stored, the offset is in the response of the POST and the HEAD request is not needed
+    if (!firstChunkStored) {
+        m_logger->debug("Getting information about the upload");
+        getUploadInfo();
+    }
 
-    m_logger->debug("Saving tusFile to cache");
-    m_cacheManager->add(m_tusFile);
-    m_cacheManager->save();
+    if (m_tusFile != nullptr) {
+        m_logger->debug("Saving tusFile to cache");
+        m_cacheManager->add(m_tusFile);
+        m_cacheManager->save();
+    }
     m_logger->debug("Uploading");
     m_logger->info("Upload started");
-    // patch chunks of the file to the server while chunk is not the last one
-    return uploadChunks();
+    return true;
 }
 
 bool TusClient::uploadChunks() {
-    int i = m_uploadedChunks;
     m_status.store(TusStatus::UPLOADING);
-    if (m_fileChunker->getChunkNumber() == 0 && !m_fileChunker->loadChunks()) {
+    while (uploadNextChunk()) {
+    }
+    return m_status.load() != TusStatus::FAILED;
+}
+
+bool TusClient::uploadNextChunk() {
+    if (hasPartials()) {
+        // the ranges one after the other, uploadNextPartialChunk() sends them concurrently
+        TusStatus ready = TusStatus::READY;
+        m_status.compare_exchange_strong(ready, TusStatus::UPLOADING);
+        const size_t count = getPartialUploads();
+        for (size_t i = 0; i < count; ++i) {
+            if (const PartialUpload &partial = getPartial(i); partial.getOffset() >= partial.getLength()) {
+                continue;
+            }
+            if (uploadNextPartialChunk(i) || (m_status.load() == TusStatus::UPLOADING && !partialsStored())) {
+                return true;
+            }
+            break;
+        }
+        finishPartials();
+        return false;
+    }
+    if (m_status.load() == TusStatus::READY) {
+        m_status.store(TusStatus::UPLOADING); // the first chunk after start()
+    }
+    // resume() without upload() has no chunks yet
+    if (m_chunkWindow == nullptr && !prepareChunks()) {
         m_status.store(TusStatus::FAILED);
         throw TUS::Exceptions::TUSException("Error: Unable to load chunks");
     }
 
-    if (m_uploadLength == 0) {
+    if (!m_uploadLengthDeferred && m_uploadLength == 0) {
         m_logger->warning("No file to upload");
         m_status.store(TusStatus::FINISHED);
-        return true;
+        return false;
     }
-    while ((m_uploadOffset < m_uploadLength) &&
-           m_status.load() == TusStatus::UPLOADING) {
+    const auto hasNextChunk = [this] {
+        return (m_uploadLengthDeferred || m_uploadOffset < m_uploadLength) && m_status.load() == TusStatus::UPLOADING;
+    };
+    if (hasNextChunk()) {
         try {
-            uploadChunk(i);
+            // the request starts at the offset of the server, it can be inside a chunk after a pause
+            uploadChunk();
         } catch (TUS::Exceptions::TUSException &e) {
+            m_transferProgress->reset();
             m_logger->error(e.what());
             m_status.store(TusStatus::FAILED);
             return false;
         }
-        i++;
+        if (hasNextChunk()) {
+            return true;
+        }
     }
     stop();
+    return false;
+}
+
+bool TusClient::hasPartials() const {
+    std::lock_guard lock(m_partialsMutex);
+    return !m_partials.empty();
+}
+
+void TusClient::updateUploadExpires(const Http::Response &response) {
+    if (const auto expires = response.getUploadExpires(); expires.has_value()) {
+        m_uploadExpires.store(std::chrono::duration_cast<std::chrono::seconds>(
+            expires->time_since_epoch()).count());
+    }
+}
+
+bool TusClient::usesParallelUploads() const {
+    if (m_parallelUploads <= 1 || m_uploadLengthDeferred) {
+        return false;
+    }
+    if (m_uploadLength <= m_chunkWindow->getChunkSize()) {
+        return false; // a single chunk has nothing to send in parallel
+    }
+    if (!getServerCapabilities(*this).concatenation) {
+        m_logger->warning("The server does not support the Concatenation extension, the file is uploaded sequentially");
+        return false;
+    }
     return true;
 }
 
-void TusClient::handleSuccessfulUpload(const string &header) {
+void TusClient::createPartials() {
+    const uint64_t chunkSize = m_fileChunker->getChunkSize();
+    const uint64_t chunks = (m_uploadLength + chunkSize - 1) / chunkSize;
+    const uint64_t count = std::min<uint64_t>(m_parallelUploads, chunks);
+    const std::vector<Cache::TUSFile::PartialState> cached =
+            m_tusFile != nullptr ? m_tusFile->getPartials() : std::vector<Cache::TUSFile::PartialState>();
+    std::vector<std::unique_ptr<PartialUpload> > partials;
+    for (uint64_t i = 0; i < count; ++i) {
+        // the ranges end on chunk boundaries, a chunk is read by a single range
+        const uint64_t start = chunks * i / count * chunkSize;
+        const uint64_t end = i + 1 == count ? m_uploadLength : chunks * (i + 1) / count * chunkSize;
+        auto partial = std::make_unique<PartialUpload>(m_httpClient, m_url, getUUIDString(), *m_fileChunker, start,
+                                                       end - start, m_chunkMemoryLimit / count);
+        partial->setRateLimiter(m_rateLimiter);
+        const auto state = std::ranges::find_if(cached, [start, end](const Cache::TUSFile::PartialState &range) {
+            return range.start == static_cast<int64_t>(start) && range.length == static_cast<int64_t>(end - start);
+        });
+        if (state != cached.end() && !state->tusIdentifier.empty() && partial->resume(state->tusIdentifier)) {
+            m_logger->debug(fmt::format("Resuming the range at {} from {}", start, partial->getOffset()));
+        } else {
+            partial->create();
+        }
+        partials.push_back(std::move(partial));
+    }
+    std::lock_guard lock(m_partialsMutex);
+    m_partials = std::move(partials);
+}
+
+bool TusClient::uploadPartials() {
+    const size_t count = getPartialUploads();
+    {
+        // a worker per range, the steps of a range send its requests in the order of their offsets
+        Chunk::ChunkScheduler scheduler(count);
+        for (size_t i = 0; i < count; ++i) {
+            scheduler.add([this, i] { return uploadNextPartialChunk(i); });
+        }
+        scheduler.wait();
+    }
+    return finishPartials();
+}
+
+size_t TusClient::getPartialUploads() const {
+    std::lock_guard lock(m_partialsMutex);
+    return m_partials.size();
+}
+
+TUS::PartialUpload &TusClient::getPartial(size_t index) const {
+    std::lock_guard lock(m_partialsMutex);
+    return *m_partials.at(index);
+}
+
+bool TusClient::partialsStored() const {
+    std::lock_guard lock(m_partialsMutex);
+    return std::ranges::all_of(m_partials, [](const auto &partial) {
+        return partial->getOffset() >= partial->getLength();
+    });
+}
+
+bool TusClient::uploadNextPartialChunk(size_t index) {
+    PartialUpload &partial = getPartial(index);
+    // the first request after start() or prepareResume(), the ranges can start at the same time
+    TusStatus ready = TusStatus::READY;
+    m_status.compare_exchange_strong(ready, TusStatus::UPLOADING);
+    m_progressLength.store(m_uploadLength);
+    try {
+        return partial.uploadNextChunk(m_status);
+    } catch (const std::exception &e) {
+        m_logger->error(e.what());
+        // the other ranges stop after their current request, they are resumed by retry()
+        m_status.store(TusStatus::FAILED);
+        m_httpClient->abort(getUUIDString());
+        return false;
+    }
+}
+
+bool TusClient::finishPartials() {
+    savePartials();
+    const TusStatus status = m_status.load();
+    if (status == TusStatus::FAILED) {
+        return false;
+    }
+    if (status != TusStatus::UPLOADING || !partialsStored()) {
+        return true; // paused, canceled, or stopped at a chunk boundary, e.g. preempted by an UploadManager
+    }
+    try {
+        concatenatePartials();
+    } catch (const TUS::Exceptions::TUSException &e) {
+        m_logger->error(e.what());
+        m_status.store(TusStatus::FAILED);
+        return false;
+    }
+    {
+        std::lock_guard lock(m_partialsMutex);
+        m_partials.clear();
+    }
+    m_uploadOffset = m_uploadLength;
+    m_progress.store(100);
+    stop();
+    return true;
+}
+
+void TusClient::concatenatePartials() {
+    string concat = "final;";
+    {
+        std::lock_guard lock(m_partialsMutex);
+        for (const auto &partial: m_partials) {
+            concat += (concat.back() == ';' ? "" : " ") + partial->getLocation();
+        }
+    }
+    Http::HeaderList headers;
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    headers.set("Content-Length", "0");
+    headers.set("Upload-Concat", concat);
+    headers.set("Upload-Metadata", "filename " + getFilePath().filename().string());
+    OnSuccessCallback onSuccess = [this](const Http::Response &response) {
+        const std::string_view location = response.getLocation();
+        m_tusLocation = location.substr(location.find_last_of('/') + 1);
+    };
+    OnErrorCallback onError = [](const Http::Response &response) {
+        throw TUS::Exceptions::TUSException(fmt::format("Error: Unable to concatenate the partial uploads: {}",
+                                                        response.getBody()));
+    };
+    m_logger->debug("Concatenating the partial uploads");
+    m_httpClient->post(createRequest(m_url, "", Http::HttpMethod::_POST, std::move(headers), onSuccess, onError));
+    m_httpClient->execute();
+}
+
+void TusClient::savePartials() {
+    if (m_tusFile == nullptr || m_status.load() == TusStatus::CANCELED) {
+        return; // a canceled upload is removed from the cache
+    }
+    std::vector<Cache::TUSFile::PartialState> states;
+    uint64_t stored = 0;
+    {
+        std::lock_guard lock(m_partialsMutex);
+        for (const auto &partial: m_partials) {
+            states.push_back({static_cast<int64_t>(partial->getStart()), static_cast<int64_t>(partial->getLength()),
+                              static_cast<int64_t>(partial->getOffset()), partial->getLocation()});
+            stored += partial->getOffset();
+        }
+    }
+    m_tusFile->setPartials(states);
+    m_tusFile->setUploadOffset(static_cast<int64_t>(stored));
+    // the record of the file is replaced
+    m_cacheManager->add(m_tusFile);
+    m_cacheManager->save();
+}
+
+void TusClient::handleSuccessfulUpload(const Http::Response &response) {
     if (m_status.load() == TusStatus::CANCELED) {
         m_logger->debug("Upload canceled");
         return;
     }
     m_uploadedChunks++;
-    try {
-        m_uploadOffset = std::stoi(extractHeaderValue(header, "Upload-Offset"));
-    }catch (const std::exception &e) {
-        m_logger->error("Failed to parse header: " + std::string(e.what()));
+    m_retry = 0;
+    updateUploadExpires(response);
+    if (!response.getUploadOffset().has_value()) {
+        m_logger->error("Failed to parse header: missing Upload-Offset");
         return;
     }
+    m_uploadOffset = static_cast<uint64_t>(*response.getUploadOffset());
+    if (m_uploadLengthDeferred) {
+        return; // the progress is known with the length of the upload
+    }
 
-    float progress = static_cast<float>(m_uploadOffset) /
-                     static_cast<float>(std::filesystem::file_size(m_filePath)) * 100;
+    float progress = m_uploadLength == 0 ? 100 : static_cast<float>(m_uploadOffset) /
+                                                 static_cast<float>(m_uploadLength) * 100;
+    m_progressLength.store(m_uploadLength);
     m_progress.store(progress);
 }
 
-void TusClient::handleUploadConflict(const string &header) {
+void TusClient::handleUploadConflict(const Http::Response &response) {
     if (m_retry < 3) {
         m_retry++;
         m_logger->warning("Conflict detected, retrying the upload");
+        // the server can still be storing an interrupted PATCH, give it time before reading the offset
+        std::this_thread::sleep_for(m_requestTimeout);
         getUploadInfo();
     } else {
         m_logger->error(fmt::format("Error: Too many conflicts {}", m_uploadedChunks));
-        m_logger->error(header);
+        m_logger->error(std::string(response.getHeaders()));
         m_status.store(TusStatus::FAILED);
         throw TUS::Exceptions::TUSException("Error: Too many conflicts");
     }
-    std::this_thread::sleep_for(m_requestTimeout);
 }
 
-void TusClient::handleUploadError(const string &header) {
+void TusClient::handleUploadError(const Http::Response &response) {
     m_logger->error(fmt::format("Error: Unable to upload chunk {}", m_uploadedChunks));
-    m_logger->error(header);
+    m_logger->error(std::string(response.getHeaders()));
     m_status.store(TusStatus::FAILED);
     throw TUS::Exceptions::TUSException("Error: Unable to upload chunk");
 }
 
 
-void TusClient::uploadChunk(int chunkNumber) {
+void TusClient::uploadChunk() {
     if (m_status.load() != TusStatus::UPLOADING) {
         return;
     }
 
-    Chunk::TUSChunk chunk = m_fileChunker->getChunks().at(chunkNumber);
-    std::map<std::string, std::string> patchHeaders;
+    const uint64_t offset = m_uploadOffset;
+    const uint64_t bodySize = getRequestSize(offset);
+    Http::RequestBody body = createChunkBody(offset, bodySize);
+    Http::HeaderList patchHeaders;
 
-    patchHeaders["Tus-Resumable"] = TUS_PROTOCOL_VERSION;
-    patchHeaders["Content-Type"] = "application/offset+octet-stream";
-    patchHeaders["Content-Length"] = std::to_string(chunk.getChunkSize());
-    patchHeaders["Upload-Offset"] = std::to_string(m_uploadOffset);
-    OnSuccessCallback onPatchSuccess = [this](const std::string &header, [[maybe_unused]] const std::string &data) {
-        if (header.find("204 No Content") != std::string::npos) {
-            handleSuccessfulUpload(header);
-        } else if (header.find("409 Conflict") != std::string::npos) {
-            handleUploadConflict(header);
+    patchHeaders.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    patchHeaders.set("Content-Type", "application/offset+octet-stream");
+    patchHeaders.set("Content-Length", std::to_string(bodySize));
+    patchHeaders.set("Upload-Offset", std::to_string(offset));
+    // once the end of a stream is read, its length is sent with the next request, possibly without body
+    std::optional<uint64_t> declaredLength;
+    if (m_uploadLengthDeferred) {
+        declaredLength = m_chunkWindow->getFileSize();
+        if (declaredLength.has_value()) {
+            patchHeaders.set("Upload-Length", std::to_string(*declaredLength));
+        }
+    }
+    // a failed request makes the next one smaller
+    const auto onFailure = [this] {
+        if (m_chunkSizer != nullptr) {
+            m_chunkSizer->onFailure();
+        }
+    };
+    bool stored = false;
+    double bandwidth = 0;
+    OnSuccessCallback onPatchSuccess = [this, &stored, &bandwidth, &declaredLength, onFailure](
+        const Http::Response &response) {
+        if (response.getStatusCode() == 204) {
+            bandwidth = response.getUploadSpeed();
+            if (declaredLength.has_value()) {
+                m_uploadLength = *declaredLength;
+                m_uploadLengthDeferred = false;
+            }
+            handleSuccessfulUpload(response);
+            stored = true;
+        } else if (response.getStatusCode() == 409) {
+            onFailure();
+            handleUploadConflict(response);
         } else {
-            handleUploadError(header);
+            onFailure();
+            handleUploadError(response);
         }
     };
 
 
-    OnErrorCallback onPatchError = [this]([[maybe_unused]] const std::string &header,
-                                          [[maybe_unused]] const std::string &data) {
+    OnErrorCallback onPatchError = [this, onFailure](const Http::Response &response) {
+        if (response.getStatusCode() == 409) {
+            // the offset of the server changed, e.g. it stored a part of a PATCH interrupted by pause()
+            onFailure();
+            handleUploadConflict(response);
+            return;
+        }
         m_logger->error("Error: Unable to upload chunk");
         if (m_status.load() != TusStatus::CANCELED &&
             m_status.load() != TusStatus::PAUSED) // in this case is not a
         // problem if request fails
         {
+            onFailure();
             m_status.store(TusStatus::FAILED);
             throw TUS::Exceptions::TUSException("Error: Unable to upload chunk");
         }
     };
-    m_logger->debug(fmt::format("Uploading chunk {}", chunkNumber));
-    m_httpClient->patch(Http::Request(
-        m_url + m_tusLocation,
-        std::string(reinterpret_cast<char *>(chunk.getData().data()),
-                    chunk.getChunkSize()),
-        Http::HttpMethod::_PATCH, patchHeaders, onPatchSuccess, onPatchError));
+    m_logger->debug(fmt::format("Uploading chunk {}", offset / m_chunkWindow->getChunkSize()));
+    Http::Request request = createRequest(m_url + m_tusLocation, "", Http::HttpMethod::_PATCH, std::move(patchHeaders),
+                                          onPatchSuccess, onPatchError);
+    request.setBodySource(std::move(body));
+    request.setProgress(m_transferProgress);
+    m_chunkOffset.store(offset);
+    const auto start = std::chrono::steady_clock::now();
+    m_httpClient->patch(std::move(request));
     m_httpClient->execute();
+    if (stored && m_chunkSizer != nullptr) {
+        m_chunkSizer->onSuccess(bodySize, std::chrono::steady_clock::now() - start, bandwidth);
+    }
+    // the chunk is confirmed or failed, its bytes are not in flight anymore
+    m_transferProgress->reset();
+    if (stored) {
+        // the chunks are freed once the server has confirmed them, a failed request sends them again
+        m_chunkWindow->release(m_uploadOffset);
+    }
 }
 
 void TusClient::cancel() {
     m_logger->debug("Cancelling upload");
+    if (std::lock_guard lock(m_partialsMutex); !m_partials.empty()) {
+        m_status.store(TusStatus::CANCELED);
+        m_httpClient->abort(getUUIDString());
+        for (const auto &partial: m_partials) {
+            partial->cancel();
+        }
+        if (m_tusFile != nullptr) {
+            m_tusFile->setPartials({});
+            m_cacheManager->remove(m_tusFile);
+            m_cacheManager->save();
+        }
+        m_logger->info("Upload canceled");
+        return;
+    }
     if (m_tusLocation.empty()) {
         m_logger->error("No upload to cancel");
         return;
     }
     m_status.store(TusStatus::CANCELED);
-    function<void(string, string)> onSuccess = [this]([[maybe_unused]] const string &header,
-                                                      [[maybe_unused]] const string &data) {
-        m_cacheManager->remove(m_tusFile);
-        m_cacheManager->save();
+    OnSuccessCallback onSuccess = [this]([[maybe_unused]] const Http::Response &response) {
+        if (m_tusFile != nullptr) {
+            m_cacheManager->remove(m_tusFile);
+            m_cacheManager->save();
+        }
         m_logger->info("Upload canceled");
     };
-    std::map<std::string, std::string> headers;
-    headers["Tus-Resumable"] = TUS_PROTOCOL_VERSION;
-    headers["accept"] = "*/*";
-    m_httpClient->abortAll();
-    m_httpClient->del(Http::Request(m_url + m_tusLocation, "",
-                                    Http::HttpMethod::_DELETE, headers,
+    Http::HeaderList headers;
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    headers.set("accept", "*/*");
+    m_httpClient->abort(getUUIDString());
+    m_httpClient->del(createRequest(m_url + m_tusLocation, "",
+                                    Http::HttpMethod::_DELETE, std::move(headers),
                                     onSuccess));
     m_httpClient->execute();
 }
 
 void TusClient::getUploadInfo() {
-    std::map<std::string, std::string> headers;
+    Http::HeaderList headers;
 
-    OnSuccessCallback headSuccess = [this](const std::string &header,
-                                           [[maybe_unused]] const std::string &data) {
-        try {
-            m_uploadOffset = std::stoi(extractHeaderValue(header, "Upload-Offset"));
-            m_uploadLength = std::stoi(extractHeaderValue(header, "Upload-Length"));
-        } catch (const std::exception &e) {
-            m_logger->error("Failed to parse header: " + std::string(e.what()));
+    OnSuccessCallback headSuccess = [this](const Http::Response &response) {
+        if (!response.getUploadOffset().has_value() ||
+            (!response.getUploadLength().has_value() && !response.isUploadLengthDeferred())) {
+            m_logger->error("Failed to parse header: missing Upload-Offset or Upload-Length");
+            return;
+        }
+        m_uploadOffset = static_cast<uint64_t>(*response.getUploadOffset());
+        updateUploadExpires(response);
+        // the length of a stream is not known before its end
+        m_uploadLengthDeferred = !response.getUploadLength().has_value();
+        if (!m_uploadLengthDeferred) {
+            m_uploadLength = static_cast<uint64_t>(*response.getUploadLength());
+            m_progressLength.store(m_uploadLength);
         }
     };
 
-    OnErrorCallback onError = [this]([[maybe_unused]] const std::string &header, const std::string &data) {
-        m_logger->error(data);
+    OnErrorCallback onError = [this](const Http::Response &response) {
+        m_logger->error(std::string(response.getBody()));
         m_status.store(TusStatus::FAILED);
         throw TUS::Exceptions::TUSException("Error: Unable to get upload information");
     };
 
-    headers.clear();
-    headers["Tus-Resumable"] = TUS_PROTOCOL_VERSION;
-    m_httpClient->head(Http::Request(m_url + m_tusLocation, "",
-                                     Http::HttpMethod::_HEAD, headers,
+    headers.set("Tus-Resumable", TUS_PROTOCOL_VERSION);
+    m_httpClient->head(createRequest(m_url + m_tusLocation, "",
+                                     Http::HttpMethod::_HEAD, std::move(headers),
                                      headSuccess, onError));
 
     m_httpClient->execute();
@@ -349,35 +890,54 @@ void TusClient::getUploadInfo() {
 
 std::map<std::string, std::string, std::less<> > TusClient::getTusServerInformation() const {
     std::map<string, string, std::less<> > serverInfo;
-    std::map<std::string, std::string> headers;
-    headers["accept"] = "*/*";
-
-    function<void(string, string)> onSuccess = [&serverInfo](const string &header,
-                                                             [[maybe_unused]] const string &data) {
-        serverInfo["Upload-Offset"] =
-                extractHeaderValue(header, "Upload-Offset");
-        serverInfo["Upload-Length"] =
-                extractHeaderValue(header, "Upload-Length");
-        serverInfo["Tus-Resumable"] =
-                extractHeaderValue(header, "Tus-Resumable");
-        serverInfo["Tus-Version"] = extractHeaderValue(header, "Tus-Version");
-        serverInfo["Tus-Extension"] =
-                extractHeaderValue(header, "Tus-Extension");
-        serverInfo["Tus-Max-Size"] = extractHeaderValue(header, "Tus-Max-Size");
+    Http::HeaderList headers;
+    headers.set("accept", "*/*");
+
+    OnSuccessCallback onSuccess = [&serverInfo](const Http::Response &response) {
+        serverInfo["Upload-Offset"] = response.getHeader("Upload-Offset");
+        serverInfo["Upload-Length"] = response.getHeader("Upload-Length");
+        serverInfo["Tus-Resumable"] = response.getTusResumable();
+        serverInfo["Tus-Version"] = response.getTusVersion();
+        serverInfo["Tus-Extension"] = response.getTusExtension();
+        serverInfo["Tus-Max-Size"] = response.getHeader("Tus-Max-Size");
     };
     m_logger->debug("Getting server information");
-    m_httpClient->options(Http::Request(
-        m_url, "", Http::HttpMethod::_OPTIONS, headers, onSuccess));
+    m_httpClient->options(createRequest(
+        m_url, "", Http::HttpMethod::_OPTIONS, std::move(headers), onSuccess));
     m_httpClient->execute();
     return serverInfo;
 }
 
 bool TusClient::resume() {
+    if (!prepareResume()) {
+        return false;
+    }
+    return hasPartials() ? uploadPartials() : uploadChunks();
+}
+
+bool TusClient::prepareResume() {
     m_logger->debug("Resuming the upload");
+    if (hasPartials()) {
+        try {
+            // the offsets of the ranges are asked again, a range lost by the server starts over
+            std::lock_guard lock(m_partialsMutex);
+            for (const auto &partial: m_partials) {
+                if (!partial->resume(partial->getLocation())) {
+                    partial->create();
+                }
+            }
+        } catch (const TUS::Exceptions::TUSException &e) {
+            m_logger->error(e.what());
+            m_status.store(TusStatus::FAILED);
+            return false;
+        }
+        m_status.store(TusStatus::READY);
+        return true;
+    }
     getUploadInfo();
+    limitRequestSize();
     m_status.store(TusStatus::READY);
-
-    return uploadChunks();
+    return true;
 }
 
 void TusClient::pause() {
@@ -385,7 +945,7 @@ void TusClient::pause() {
     if (m_status.load() == TusStatus::UPLOADING) {
         m_status.store(TusStatus::PAUSED);
         m_logger->info("Upload paused");
-        m_httpClient->abortAll();
+        m_httpClient->abort(getUUIDString());
     } else {
         m_logger->error("Cannot pause, current status is not UPLOADING");
     }
@@ -397,26 +957,133 @@ void TusClient::stop() {
         return;
     }
     m_logger->debug("Stopping the upload");
-    if (m_uploadOffset == m_uploadLength &&
+    if (!m_uploadLengthDeferred && m_uploadOffset == m_uploadLength &&
         (m_status.load() != TusStatus::CANCELED &&
          m_status.load() != TusStatus::FAILED)) {
         m_logger->debug("Upload completed");
         m_status.store(TusStatus::FINISHED);
     }
 
-    m_cacheManager->remove(m_tusFile);
-    m_cacheManager->save();
+    if (m_tusFile != nullptr) {
+        m_cacheManager->remove(m_tusFile);
+        m_cacheManager->save();
+    }
+}
+
+float TusClient::progress() const {
+    const uint64_t length = m_progressLength.load();
+    if (std::lock_guard lock(m_partialsMutex); !m_partials.empty() && length != 0) {
+        // the bytes stored and in flight of every range
+        uint64_t sent = 0;
+        for (const auto &partial: m_partials) {
+            sent += partial->getOffset() + partial->getBytesInFlight();
+        }
+        return std::min(static_cast<float>(sent) / static_cast<float>(length) * 100, 100.0f);
+    }
+    if (length == 0) {
+        return m_progress.load();
+    }
+    const uint64_t inFlight = getBytesInFlight();
+    if (inFlight == 0) {
+        return m_progress.load();
+    }
+    // the confirmed offset can already include the chunk while its counters are still set
+    const float sending = static_cast<float>(m_chunkOffset.load() + inFlight) / static_cast<float>(length) * 100;
+    return std::min(std::max(m_progress.load(), sending), 100.0f);
 }
 
-float TusClient::progress() const { return m_progress.load(); }
+uint64_t TusClient::getBytesInFlight() const {
+    std::lock_guard lock(m_partialsMutex);
+    uint64_t inFlight = m_transferProgress->getUploadedBytes();
+    for (const auto &partial: m_partials) {
+        inFlight += partial->getBytesInFlight();
+    }
+    return inFlight;
+}
+
+double TusClient::getUploadSpeed() const {
+    std::lock_guard lock(m_partialsMutex);
+    double speed = m_transferProgress->getUploadSpeed();
+    for (const auto &partial: m_partials) {
+        speed += partial->getUploadSpeed();
+    }
+    return speed;
+}
+
+std::optional<std::chrono::system_clock::time_point> TusClient::getUploadExpires() const {
+    const int64_t expires = m_uploadExpires.load();
+    if (expires == 0) {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::time_point(std::chrono::seconds(expires));
+}
+
+void TusClient::setChunkSourceType(Chunk::ChunkSourceType type) {
+    if (m_status.load() == TusStatus::UPLOADING) {
+        m_logger->error("Cannot change the chunk source while uploading");
+        return;
+    }
+    if (!readsFile() || type == Chunk::ChunkSourceType::_MEMORY || type == Chunk::ChunkSourceType::_STREAM) {
+        m_logger->error("The chunks of a memory region or of a stream are read from the source of the client");
+        return;
+    }
+    m_chunkSourceType = type;
+    createFileChunker();
+}
+
+TUS::Chunk::ChunkSourceType TusClient::getChunkSourceType() const {
+    return m_chunkSourceType;
+}
+
+void TusClient::setChunkMemoryLimit(size_t bytes) {
+    m_chunkMemoryLimit = bytes;
+}
+
+size_t TusClient::getChunkMemoryLimit() const {
+    return m_chunkMemoryLimit;
+}
+
+void TusClient::setAdaptiveChunkSize(std::chrono::milliseconds targetDuration, uint64_t maxRequestSize) {
+    if (targetDuration.count() <= 0) {
+        m_chunkSizer.reset();
+        return;
+    }
+    m_chunkSizer = std::make_unique<Chunk::AdaptiveChunkSizer>(m_fileChunker->getChunkSize(), targetDuration);
+    m_chunkSizer->limitMaxSize(maxRequestSize);
+}
+
+uint64_t TusClient::getNextRequestSize() const {
+    if (m_chunkSizer != nullptr) {
+        return m_chunkSizer->getChunkSize();
+    }
+    return m_fileChunker->getChunkSize();
+}
+
+void TusClient::setParallelUploads(size_t count) {
+    m_parallelUploads = std::max<size_t>(count, 1);
+}
+
+size_t TusClient::getParallelUploads() const {
+    return m_parallelUploads;
+}
+
+void TusClient::setCacheRepository(std::shared_ptr<Repository::IRepository<Cache::TUSFile> > repository) {
+    m_cacheManager = std::move(repository);
+    loadCachedState();
+}
 
 TusStatus TusClient::status() { return m_status.load(); }
 
 bool TusClient::retry() {
     if (m_status.load() == TusStatus::FAILED ||
         m_status.load() == TusStatus::CANCELED) {
+        if (m_chunkSourceType == Chunk::ChunkSourceType::_STREAM) {
+            m_logger->error("Cannot retry the upload of a stream, it has been read");
+            return false;
+        }
         m_logger->debug("Retrying upload");
         m_status.store(TusStatus::READY);
+        m_chunkWindow.reset();
         m_fileChunker->clearChunks();
         m_uploadedChunks = 0;
         m_uploadOffset = 0;
@@ -440,6 +1107,18 @@ std::chrono::milliseconds TusClient::getRequestTimeout() const {
     return m_requestTimeout;
 }
 
+void TusClient::setMaxUploadSpeed(uint64_t bytesPerSecond) {
+    m_rateLimiter->setRate(bytesPerSecond);
+}
+
+uint64_t TusClient::getMaxUploadSpeed() const {
+    return m_rateLimiter->getRate();
+}
+
+const std::shared_ptr<TUS::Http::RateLimiter> &TusClient::getRateLimiter() const {
+    return m_rateLimiter;
+}
+
 void TUS::TusClient::setBearerToken(const std::string &token) const {
     m_httpClient->setAuthorization(token);
 }
@@ -0,0 +1,544 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fmt/core.h>
+
+#include "UploadManager.h"
+#include "TusClient.h"
+#include "cache/CacheRepository.h"
+#include "chunk/ChunkScheduler.h"
+#include "exceptions/TUSException.h"
+#include "http/HttpClient.h"
+#include "logging/GLoggingService.h"
+
+using TUS::UploadManager;
+using TUS::TusStatus;
+using TUS::Logging::GLoggingService;
+
+namespace {
+    /**
+     * @brief Refuse a limit of 0 uploads running at once, the queued uploads would never start
+     */
+    size_t checkMaxConcurrentUploads(size_t count) {
+        if (count == 0) {
+            throw std::invalid_argument("At least one upload must run at once");
+        }
+        return count;
+    }
+}
+
+UploadManager::UploadManager(string appName, size_t maxConcurrentUploads, Logging::LogLevel logLevel)
+    : m_appName(std::move(appName)), m_logLevel(logLevel),
+      m_logger(std::make_unique<GLoggingService>(logLevel)),
+      m_httpClient(std::make_shared<Http::HttpClient>(std::make_unique<GLoggingService>(logLevel))),
+      m_cache(Cache::CacheRepository::create(m_appName)),
+      m_maxConcurrentUploads(checkMaxConcurrentUploads(maxConcurrentUploads)),
+      m_scheduler(std::make_unique<Chunk::ChunkScheduler>(maxConcurrentUploads)) {
+}
+
+UploadManager::~UploadManager() {
+    std::vector<std::shared_ptr<TusClient> > running;
+    std::vector<std::shared_ptr<TusClient> > preempted; // destroyed once the mutex is released
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+        for (const auto &job: m_queue) {
+            if (job->client == nullptr) {
+                job->status = TusStatus::CANCELED;
+                continue;
+            }
+            // a preempted upload stays paused in the cache
+            job->status = TusStatus::PAUSED;
+            job->progress = job->client->progress();
+            preempted.push_back(std::move(job->client));
+        }
+        m_queue.clear();
+        for (const auto &[id, job]: m_jobs) {
+            if (job->client != nullptr) {
+                running.push_back(job->client);
+            }
+        }
+    }
+    m_condition.notify_all();
+    // paused at the end of their current request, their state stays in the cache
+    for (const auto &client: running) {
+        client->pause();
+    }
+    m_scheduler->wait();
+    m_scheduler.reset();
+}
+
+UploadManager::JobId UploadManager::add(string url, path filePath, int chunkSize, UploadPriority priority,
+                                        Deadline deadline) {
+    std::error_code error;
+    const uint64_t size = std::filesystem::file_size(filePath, error);
+    if (error) {
+        throw Exceptions::TUSException(fmt::format("Unable to upload {}: {}", filePath.string(), error.message()));
+    }
+    std::lock_guard lock(m_mutex);
+    if (m_queue.size() >= m_maxQueuedUploads) {
+        throw Exceptions::TUSException(fmt::format("The upload queue is full, {} uploads are waiting",
+                                                   m_queue.size()));
+    }
+    string host = getHost(url);
+    auto job = std::make_shared<Job>(Job{m_nextId++, std::move(url), std::move(filePath), chunkSize,
+                                         std::move(host), size, priority, deadline, TusStatus::READY, 0,
+                                         nullptr, std::chrono::steady_clock::now(), false, false});
+    m_jobs.emplace(job->id, job);
+    m_queue.push_back(job);
+    admit();
+    return job->id;
+}
+
+bool UploadManager::cancel(JobId id) {
+    std::shared_ptr<TusClient> client;
+    {
+        std::lock_guard lock(m_mutex);
+        const std::shared_ptr<Job> &job = getJob(id);
+        if (const auto queued = std::ranges::find(m_queue, job); queued != m_queue.end()) {
+            m_queue.erase(queued);
+            job->status = TusStatus::CANCELED;
+            m_condition.notify_all();
+            if (job->client == nullptr) {
+                return true;
+            }
+            // a preempted upload is deleted from the server
+            client = std::move(job->client);
+        } else if (job->status != TusStatus::READY) {
+            return false; // it already ended
+        } else if (job->client == nullptr) {
+            // taken by a worker, it does not start
+            job->status = TusStatus::CANCELED;
+            return true;
+        } else {
+            client = job->client;
+        }
+    }
+    client->cancel();
+    return true;
+}
+
+void UploadManager::wait() {
+    std::unique_lock lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_queue.empty() && m_running == 0; });
+}
+
+TusStatus UploadManager::status(JobId id) const {
+    std::lock_guard lock(m_mutex);
+    const std::shared_ptr<Job> &job = getJob(id);
+    return job->client != nullptr ? job->client->status() : job->status;
+}
+
+float UploadManager::progress(JobId id) const {
+    std::lock_guard lock(m_mutex);
+    const std::shared_ptr<Job> &job = getJob(id);
+    return job->client != nullptr ? job->client->progress() : job->progress;
+}
+
+float UploadManager::progress() const {
+    std::lock_guard lock(m_mutex);
+    double total = 0;
+    double sent = 0;
+    for (const auto &[id, job]: m_jobs) {
+        if (job->status == TusStatus::CANCELED) {
+            continue;
+        }
+        const float jobProgress = job->client != nullptr ? job->client->progress() : job->progress;
+        total += static_cast<double>(job->size);
+        sent += static_cast<double>(job->size) * jobProgress / 100;
+    }
+    if (total == 0) {
+        return m_jobs.empty() ? 0 : 100;
+    }
+    return static_cast<float>(sent / total * 100);
+}
+
+double UploadManager::getUploadSpeed() const {
+    std::lock_guard lock(m_mutex);
+    double speed = 0;
+    for (const auto &[id, job]: m_jobs) {
+        if (job->client != nullptr) {
+            speed += job->client->getUploadSpeed();
+        }
+    }
+    return speed;
+}
+
+size_t UploadManager::getQueuedUploads() const {
+    std::lock_guard lock(m_mutex);
+    return m_queue.size();
+}
+
+size_t UploadManager::getRunningUploads() const {
+    std::lock_guard lock(m_mutex);
+    return m_running;
+}
+
+UploadManager::QueueingDelay UploadManager::getQueueingDelay(UploadPriority priority) const {
+    std::lock_guard lock(m_mutex);
+    const DelayStats &stats = m_delays[static_cast<size_t>(priority)];
+    QueueingDelay delay;
+    delay.uploads = stats.uploads;
+    if (stats.uploads > 0) {
+        delay.average = std::chrono::duration_cast<std::chrono::milliseconds>(stats.total / stats.uploads);
+        delay.max = std::chrono::duration_cast<std::chrono::milliseconds>(stats.max);
+    }
+    return delay;
+}
+
+uint64_t UploadManager::getPreemptions() const {
+    std::lock_guard lock(m_mutex);
+    return m_preemptions;
+}
+
+void UploadManager::setMaxConcurrentUploads(size_t count) {
+    checkMaxConcurrentUploads(count);
+    std::lock_guard lock(m_mutex);
+    m_maxConcurrentUploads = count;
+    admit();
+}
+
+size_t UploadManager::getMaxConcurrentUploads() const {
+    std::lock_guard lock(m_mutex);
+    return m_maxConcurrentUploads;
+}
+
+void UploadManager::setMaxUploadsPerHost(size_t count) {
+    std::lock_guard lock(m_mutex);
+    m_maxUploadsPerHost = count;
+    admit();
+}
+
+size_t UploadManager::getMaxUploadsPerHost() const {
+    std::lock_guard lock(m_mutex);
+    return m_maxUploadsPerHost;
+}
+
+void UploadManager::setMaxQueuedUploads(size_t count) {
+    std::lock_guard lock(m_mutex);
+    m_maxQueuedUploads = count;
+}
+
+size_t UploadManager::getMaxQueuedUploads() const {
+    std::lock_guard lock(m_mutex);
+    return m_maxQueuedUploads;
+}
+
+void UploadManager::setParallelUploads(size_t count) {
+    std::lock_guard lock(m_mutex);
+    m_parallelUploads = count;
+}
+
+size_t UploadManager::getParallelUploads() const {
+    std::lock_guard lock(m_mutex);
+    return m_parallelUploads;
+}
+
+void UploadManager::setBearerToken(const std::string &token) const {
+    m_httpClient->setAuthorization(token);
+}
+
+std::string UploadManager::getHost(const string &url) {
+    const size_t scheme = url.find("://");
+    const size_t start = scheme == string::npos ? 0 : scheme + 3;
+    return url.substr(start, url.find('/', start) - start);
+}
+
+UploadManager::Deadline UploadManager::getDeadline(const Job &job) {
+    Deadline deadline = job.deadline;
+    if (job.client != nullptr) {
+        // the server drops the upload once it expires, the bytes sent would be lost
+        const auto expires = job.client->getUploadExpires();
+        if (expires.has_value() && (!deadline.has_value() || *expires < *deadline)) {
+            deadline = expires;
+        }
+    }
+    return deadline;
+}
+
+bool UploadManager::startsBefore(const Job &job, const Job &other) {
+    if (job.priority != other.priority) {
+        return job.priority > other.priority;
+    }
+    const Deadline deadline = getDeadline(job);
+    const Deadline otherDeadline = getDeadline(other);
+    if (deadline != otherDeadline) {
+        // an upload without deadline goes after the others
+        return deadline.has_value() && (!otherDeadline.has_value() || *deadline < *otherDeadline);
+    }
+    return job.id < other.id;
+}
+
+bool UploadManager::hostHasSlot(const Job &job) const {
+    const auto running = m_runningPerHost.find(job.host);
+    return m_maxUploadsPerHost == 0 || running == m_runningPerHost.end() || running->second < m_maxUploadsPerHost;
+}
+
+std::shared_ptr<UploadManager::Job> UploadManager::takeNext() {
+    if (m_running >= m_maxConcurrentUploads) {
+        return nullptr;
+    }
+    // an upload to a busy host lets the next ones start
+    auto next = m_queue.end();
+    for (auto job = m_queue.begin(); job != m_queue.end(); ++job) {
+        if (hostHasSlot(**job) && (next == m_queue.end() || startsBefore(**job, **next))) {
+            next = job;
+        }
+    }
+    if (next == m_queue.end()) {
+        return nullptr;
+    }
+    std::shared_ptr<Job> job = *next;
+    m_queue.erase(next);
+    return job;
+}
+
+void UploadManager::admit() {
+    if (m_stopping) {
+        return;
+    }
+    while (std::shared_ptr<Job> job = takeNext()) {
+        ++m_running;
+        ++m_runningPerHost[job->host];
+        m_runningJobs.emplace(job->id, job);
+        DelayStats &delay = m_delays[static_cast<size_t>(job->priority)];
+        const auto waited = std::chrono::steady_clock::now() - job->queuedAt;
+        ++delay.uploads;
+        delay.total += waited;
+        delay.max = std::max(delay.max, waited);
+        m_scheduler->add([this, job] { return step(job); });
+    }
+    preempt();
+}
+
+void UploadManager::preempt() {
+    if (m_queue.empty() || m_runningJobs.empty()) {
+        return;
+    }
+    // the queued uploads are paused, their deadlines do not change while they are sorted
+    std::vector<std::shared_ptr<Job> > waiting(m_queue.begin(), m_queue.end());
+    std::ranges::sort(waiting, [](const auto &job, const auto &other) { return startsBefore(*job, *other); });
+    // the running uploads that would start last are preempted first, their deadlines are taken once
+    std::vector<std::pair<std::shared_ptr<Job>, Deadline> > running;
+    for (const auto &[id, job]: m_runningJobs) {
+        if (!job->preempted) {
+            running.emplace_back(job, getDeadline(*job));
+        }
+    }
+    std::ranges::sort(running, [](const auto &job, const auto &other) {
+        if (job.first->priority != other.first->priority) {
+            return job.first->priority < other.first->priority;
+        }
+        if (job.second != other.second) {
+            return !job.second.has_value() || (other.second.has_value() && *job.second > *other.second);
+        }
+        return job.first->id > other.first->id;
+    });
+    // the first ones take the slots of the uploads preempted already
+    for (size_t i = m_preempting; i < waiting.size(); ++i) {
+        const std::shared_ptr<Job> &job = waiting[i];
+        // with its host at the limit, only an upload to the same host frees a slot for it
+        const bool sameHost = !hostHasSlot(*job);
+        const auto victim = std::ranges::find_if(running, [&job, sameHost](const auto &other) {
+            return other.first->priority < job->priority && (!sameHost || other.first->host == job->host);
+        });
+        if (victim == running.end()) {
+            continue;
+        }
+        victim->first->preempted = true;
+        ++m_preempting;
+        ++m_preemptions;
+        m_logger->debug(fmt::format("Preempting the upload of {}", victim->first->filePath.string()));
+        running.erase(victim);
+    }
+}
+
+void UploadManager::requeue(const std::shared_ptr<Job> &job) {
+    std::shared_ptr<TusClient> client;
+    {
+        std::lock_guard lock(m_mutex);
+        client = job->client;
+    }
+    // at a chunk boundary no request is in flight, a client created by the step has not sent a chunk yet
+    if (client->status() == TusStatus::UPLOADING) {
+        client->pause();
+    }
+    std::lock_guard lock(m_mutex);
+    job->preempted = false;
+    --m_preempting;
+    --m_running;
+    if (--m_runningPerHost[job->host] == 0) {
+        m_runningPerHost.erase(job->host);
+    }
+    m_runningJobs.erase(job->id);
+    job->paused = true;
+    job->queuedAt = std::chrono::steady_clock::now();
+    m_queue.push_back(job);
+    admit();
+    m_condition.notify_all();
+}
+
+bool UploadManager::step(const std::shared_ptr<Job> &job) {
+    std::shared_ptr<TusClient> client;
+    bool resume = false;
+    bool stopping = false;
+    {
+        std::lock_guard lock(m_mutex);
+        client = job->client;
+        resume = std::exchange(job->paused, false);
+        stopping = m_stopping;
+    }
+    if (stopping && client != nullptr) {
+        // the destructor pauses only the uploads sending a chunk, one between two chunks does not send the next one
+        if (client->status() == TusStatus::UPLOADING) {
+            client->pause();
+        }
+        finish(job);
+        return false;
+    }
+    bool next = false;
+    if (client == nullptr) {
+        client = start(job);
+        next = client != nullptr;
+    } else {
+        try {
+            // a preempted upload asks the server its offset again
+            next = resume ? client->prepareResume() : client->uploadNextChunk();
+        } catch (const std::exception &e) {
+            m_logger->error(fmt::format("Unable to upload {}: {}", job->filePath.string(), e.what()));
+        }
+    }
+    if (!next) {
+        finish(job);
+        return false;
+    }
+    bool preempted = false;
+    {
+        std::lock_guard lock(m_mutex);
+        preempted = job->preempted;
+    }
+    if (preempted) {
+        requeue(job);
+        return false;
+    }
+    // a parallel upload goes on as a step per range, the idle workers steal them like the uploads of the others
+    if (const size_t partials = client->getPartialUploads(); partials > 0) {
+        {
+            std::lock_guard lock(m_mutex);
+            job->partialSteps = partials;
+        }
+        for (size_t i = 0; i < partials; ++i) {
+            m_scheduler->add([this, job, client, i] { return stepPartial(job, client, i); });
+        }
+        return false;
+    }
+    return true;
+}
+
+bool UploadManager::stepPartial(const std::shared_ptr<Job> &job, const std::shared_ptr<TusClient> &client,
+                                size_t index) {
+    bool stopping = false;
+    bool preempted = false;
+    {
+        std::lock_guard lock(m_mutex);
+        stopping = m_stopping;
+        preempted = job->preempted;
+    }
+    // a range stops at its chunk boundary, the upload is paused or ended once every range stopped
+    if (!stopping && !preempted && client->uploadNextPartialChunk(index)) {
+        return true;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        if (--job->partialSteps > 0) {
+            return false;
+        }
+        stopping = m_stopping;
+        preempted = job->preempted;
+    }
+    if ((stopping || preempted) && client->status() == TusStatus::UPLOADING) {
+        client->pause();
+    }
+    try {
+        // the state of the ranges is saved, they are joined once they are all stored
+        client->finishPartials();
+    } catch (const std::exception &e) {
+        m_logger->error(fmt::format("Unable to upload {}: {}", job->filePath.string(), e.what()));
+    }
+    if (preempted && !stopping && client->status() == TusStatus::PAUSED) {
+        requeue(job);
+    } else {
+        finish(job);
+    }
+    return false;
+}
+
+std::shared_ptr<TUS::TusClient> UploadManager::start(const std::shared_ptr<Job> &job) {
+    std::shared_ptr<TusClient> client;
+    try {
+        client = std::make_shared<TusClient>(m_appName, job->url, job->filePath, m_httpClient, job->chunkSize,
+                                             m_logLevel);
+        client->setCacheRepository(m_cache);
+    } catch (const std::exception &e) {
+        m_logger->error(fmt::format("Unable to upload {}: {}", job->filePath.string(), e.what()));
+        std::lock_guard lock(m_mutex);
+        job->status = TusStatus::FAILED;
+        return nullptr;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        if (job->status == TusStatus::CANCELED || m_stopping) {
+            job->status = TusStatus::CANCELED;
+            return nullptr;
+        }
+        client->setParallelUploads(m_parallelUploads);
+        job->client = client;
+    }
+    try {
+        if (client->start()) {
+            return client;
+        }
+    } catch (const std::exception &e) {
+        m_logger->error(fmt::format("Unable to upload {}: {}", job->filePath.string(), e.what()));
+    }
+    return nullptr;
+}
+
+void UploadManager::finish(const std::shared_ptr<Job> &job) {
+    std::shared_ptr<TusClient> client; // destroyed once the mutex is released
+    std::lock_guard lock(m_mutex);
+    client = std::move(job->client);
+    if (client != nullptr) {
+        job->status = client->status();
+        job->progress = client->progress();
+    }
+    if (job->status == TusStatus::READY || job->status == TusStatus::UPLOADING) {
+        // stopped by the destructor it stays in the cache, otherwise it stopped before its end
+        job->status = m_stopping ? TusStatus::PAUSED : TusStatus::FAILED;
+    }
+    if (std::exchange(job->preempted, false)) {
+        --m_preempting; // it ended before its next chunk
+    }
+    --m_running;
+    if (--m_runningPerHost[job->host] == 0) {
+        m_runningPerHost.erase(job->host);
+    }
+    m_runningJobs.erase(job->id);
+    admit();
+    m_condition.notify_all();
+}
+
+const std::shared_ptr<UploadManager::Job> &UploadManager::getJob(JobId id) const {
+    const auto job = m_jobs.find(id);
+    if (job == m_jobs.end()) {
+        throw std::out_of_range(fmt::format("Unknown upload {}", id));
+    }
+    return job->second;
+}
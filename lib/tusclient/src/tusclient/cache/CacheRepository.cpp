@@ -36,14 +36,27 @@ std::shared_ptr<CacheRepository> CacheRepository::create(std::string appName, bo
     return repository;
 }
 CacheRepository::~CacheRepository() {
-    CacheRepository::save();
+    if (m_modified) {
+        CacheRepository::save();
+    }
 }
 
 void CacheRepository::add(std::shared_ptr<TUSFile> item) {
-    m_cache.push_back(std::make_shared<TUSFile>(item));
+    auto record = std::make_shared<TUSFile>(item);
+    std::lock_guard lock(m_mutex);
+    m_modified = true;
+    if (auto it = std::ranges::find_if(m_cache, [&record](const std::shared_ptr<TUSFile> &file) {
+        return file->getIdentificationHash() == record->getIdentificationHash();
+    }); it != m_cache.end()) {
+        *it = std::move(record);
+        return;
+    }
+    m_cache.push_back(std::move(record));
 }
 
 void CacheRepository::remove(std::shared_ptr<TUSFile> item) {
+    std::lock_guard lock(m_mutex);
+    m_modified = true;
     auto it = std::ranges::find_if(m_cache, [&item](const std::shared_ptr<TUSFile> &file) {
         return file->getIdentificationHash() == item->getIdentificationHash();
     });
@@ -56,6 +69,7 @@ void CacheRepository::remove(std::shared_ptr<TUSFile> item) {
 }
 
 std::shared_ptr<TUSFile> CacheRepository::findByHash(const std::string &id) const {
+    std::lock_guard lock(m_mutex);
     if (auto it = std::ranges::find_if(m_cache, [&id](const std::shared_ptr<TUSFile> &file) {
         return file->getIdentificationHash() == id;
     }); it != m_cache.end()) {
@@ -66,6 +80,7 @@ std::shared_ptr<TUSFile> CacheRepository::findByHash(const std::string &id) cons
 }
 
 std::vector<std::shared_ptr<TUSFile> > CacheRepository::findAll() const {
+    std::lock_guard lock(m_mutex);
     std::vector<std::shared_ptr<TUSFile> > files;
 
     files.reserve(m_cache.size());
@@ -77,6 +92,7 @@ std::vector<std::shared_ptr<TUSFile> > CacheRepository::findAll() const {
 }
 
 bool CacheRepository::open() {
+    std::lock_guard lock(m_mutex);
     if (!std::filesystem::exists(m_path)) {
         return true;
     }
@@ -125,11 +141,20 @@ bool CacheRepository::open() {
         std::string uuidString = item["uuid"];
         boost::uuids::uuid uuid = gen(uuidString);
         auto tusFile = std::make_shared<TUSFile>(filePath, uploadUrl, appName, uuid);
-        tusFile->setUploadOffset(item["uploadOffset"]);
-        tusFile->setResumeFrom(item["resumeFrom"]);
-        tusFile->setLastEdit(item["lastEdit"]);
+        tusFile->setUploadOffset(item["uploadOffset"].get<int64_t>());
+        tusFile->setResumeFrom(item["resumeFrom"].get<int64_t>());
+        tusFile->setLastEdit(item["lastEdit"].get<int64_t>());
         tusFile->setTusIdentifier(item["tusId"]);
         tusFile->setChunkNumber(item["chunkNumber"]);
+        if (item.contains("partials")) {
+            // the ranges of a parallel upload, absent from the records of a sequential one
+            std::vector<TUSFile::PartialState> partials;
+            for (const auto &partial: item["partials"]) {
+                partials.push_back({partial["start"].get<int64_t>(), partial["length"].get<int64_t>(),
+                                    partial["uploadOffset"].get<int64_t>(), partial["tusId"]});
+            }
+            tusFile->setPartials(std::move(partials));
+        }
         m_cache.push_back(tusFile);
     }
 
@@ -137,13 +162,18 @@ bool CacheRepository::open() {
 }
 
 void CacheRepository::clearCache() {
-    m_cache.clear();
+    {
+        std::lock_guard lock(m_mutex);
+        m_cache.clear();
+        m_modified = true;
+    }
     save();
     open();
 }
 
 bool CacheRepository::save() noexcept {
     try {
+        std::lock_guard lock(m_mutex);
         json j;
         if (!m_cache.empty()) {
             for (const auto &file: m_cache) {
@@ -158,6 +188,12 @@ bool CacheRepository::save() noexcept {
                 item["resumeFrom"] = file->getResumeFrom();
                 item["tusId"] = file->getTusIdentifier();
                 item["chunkNumber"] = file->getChunkNumber();
+                for (const auto &partial: file->getPartials()) {
+                    item["partials"].push_back({
+                        {"start", partial.start}, {"length", partial.length},
+                        {"uploadOffset", partial.uploadOffset}, {"tusId", partial.tusIdentifier}
+                    });
+                }
                 j.push_back(item);
             }
         } else {
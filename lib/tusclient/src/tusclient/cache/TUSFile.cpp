@@ -27,8 +27,9 @@ TUSFile::TUSFile(const std::filesystem::path &filePath, const std::string &uploa
 TUSFile::TUSFile(const std::shared_ptr<TUSFile> &file)
     : m_lastEdit(file->getLastEdit()), m_filePath(file->getFilePath()), m_uploadUrl(file->getUploadUrl()),
       m_appName(file->getAppName())
-      , m_uploadOffset(file->getUploadOffset()), m_fileSize(file->getFileSize()),
-      m_tusIdentifier(file->getTusIdentifier()), m_uuid(file->getUuid()),
+      , m_uploadOffset(file->getUploadOffset()), m_resumeFrom(file->getResumeFrom()), m_fileSize(file->getFileSize()),
+      m_tusIdentifier(file->getTusIdentifier()), m_uuid(file->getUuid()), m_chunkNumber(file->getChunkNumber()),
+      m_partials(file->getPartials()),
       m_identifcationHash(file->getIdentificationHash()) {
 }
 
@@ -89,12 +90,21 @@ void TUSFile::setUploadOffset(int64_t uploadOffset) {
     updateFile();
 }
 
-void TUSFile::setResumeFrom(int resumeFrom) {
+std::vector<TUSFile::PartialState> TUSFile::getPartials() const {
+    return m_partials;
+}
+
+void TUSFile::setPartials(std::vector<PartialState> partials) {
+    m_partials = std::move(partials);
+    updateFile();
+}
+
+void TUSFile::setResumeFrom(int64_t resumeFrom) {
     m_resumeFrom = resumeFrom;
     updateFile();
 }
 
-int TUSFile::getResumeFrom() const {
+int64_t TUSFile::getResumeFrom() const {
     return m_resumeFrom;
 }
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+
+#include "chunk/AdaptiveChunkSizer.h"
+
+using TUS::Chunk::AdaptiveChunkSizer;
+
+namespace {
+    double smooth(double average, double sample) {
+        return average == 0 ? sample : AdaptiveChunkSizer::SMOOTHING * sample +
+                                       (1 - AdaptiveChunkSizer::SMOOTHING) * average;
+    }
+}
+
+AdaptiveChunkSizer::AdaptiveChunkSizer(uint64_t initialSize, std::chrono::milliseconds targetDuration,
+                                       uint64_t minSize, uint64_t maxSize)
+    : m_targetDuration(targetDuration), m_minSize(std::max<uint64_t>(1, std::min(minSize, initialSize))),
+      m_maxSize(maxSize == 0 ? UINT64_MAX : std::max(maxSize, m_minSize)), m_chunkSize(clamp(initialSize)) {
+}
+
+uint64_t AdaptiveChunkSizer::getChunkSize() const {
+    return m_chunkSize;
+}
+
+void AdaptiveChunkSizer::limitMaxSize(uint64_t maxSize) {
+    if (maxSize == 0) {
+        return;
+    }
+    // a limit below the minimum wins, a larger request would be refused
+    m_maxSize = std::min(m_maxSize, maxSize);
+    m_chunkSize = std::min(m_chunkSize, m_maxSize);
+}
+
+uint64_t AdaptiveChunkSizer::getMaxSize() const {
+    return m_maxSize;
+}
+
+void AdaptiveChunkSizer::onSuccess(uint64_t bytes, std::chrono::nanoseconds duration, double bandwidth) {
+    const double seconds = std::chrono::duration<double>(duration).count();
+    if (bytes == 0 || seconds <= 0) {
+        return;
+    }
+    if (bandwidth <= 0) {
+        bandwidth = static_cast<double>(bytes) / seconds; // the round trip is part of the transfer time
+    } else {
+        m_roundTripTime = smooth(m_roundTripTime, std::max(0.0, seconds - static_cast<double>(bytes) / bandwidth));
+    }
+    m_bandwidth = smooth(m_bandwidth, bandwidth);
+
+    const double target = std::max(std::chrono::duration<double>(m_targetDuration).count(),
+                                   MIN_ROUND_TRIPS * m_roundTripTime);
+    const auto ideal = static_cast<uint64_t>(m_bandwidth * (target - m_roundTripTime));
+    m_chunkSize = clamp(std::clamp(ideal, m_chunkSize / 2, m_chunkSize * 2));
+}
+
+void AdaptiveChunkSizer::onFailure() {
+    m_chunkSize = clamp(m_chunkSize / 2);
+}
+
+double AdaptiveChunkSizer::getBandwidth() const {
+    return m_bandwidth;
+}
+
+std::chrono::nanoseconds AdaptiveChunkSizer::getRoundTripTime() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(m_roundTripTime));
+}
+
+uint64_t AdaptiveChunkSizer::clamp(uint64_t size) const {
+    return std::min(std::max(size, m_minSize), m_maxSize);
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <cstring>
+
+#include "chunk/ChunkBodySource.h"
+#include "chunk/ChunkWindow.h"
+#include "chunk/TUSChunk.h"
+
+using TUS::Chunk::ChunkBodySource;
+
+ChunkBodySource::ChunkBodySource(ChunkWindow &window, uint64_t offset, uint64_t length)
+    : m_window(window), m_offset(offset), m_length(length) {
+}
+
+size_t ChunkBodySource::read(uint64_t offset, char *buffer, size_t size) {
+    if (offset >= m_length) {
+        return 0;
+    }
+    const uint64_t position = m_offset + offset;
+    const uint64_t chunkSize = m_window.getChunkSize();
+    const auto chunkNumber = static_cast<int>(position / chunkSize);
+    if (chunkNumber != m_chunkNumber) {
+        // the chunks before stay in the window until the server confirms them, they are sent again on a retry
+        const TUSChunk *chunk = m_window.tryGet(chunkNumber);
+        if (chunk == nullptr) {
+            return PENDING; // the reader of the window is still reading it
+        }
+        m_chunk = chunk;
+        m_chunkNumber = chunkNumber;
+    }
+    const uint64_t chunkOffset = position - static_cast<uint64_t>(chunkNumber) * chunkSize;
+    if (chunkOffset >= m_chunk->getChunkSize()) {
+        return 0; // the file is shorter than the body
+    }
+    const size_t count = std::min<uint64_t>({size, m_chunk->getChunkSize() - chunkOffset, m_length - offset});
+    std::memcpy(buffer, m_chunk->getBytes() + chunkOffset, count);
+    return count;
+}
+
+uint64_t ChunkBodySource::size() const {
+    return m_length;
+}
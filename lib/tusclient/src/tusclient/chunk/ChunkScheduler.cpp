@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+
+#include "chunk/ChunkScheduler.h"
+
+using TUS::Chunk::ChunkScheduler;
+
+namespace {
+    /**
+     * @brief The scheduler and the deque of the worker running on this thread
+     */
+    thread_local const ChunkScheduler *currentScheduler = nullptr;
+    thread_local size_t currentWorker = 0;
+}
+
+ChunkScheduler::ChunkScheduler(size_t workers) {
+    workers = std::max<size_t>(workers, 1);
+    for (size_t i = 0; i < workers; ++i) {
+        m_deques.push_back(std::make_unique<Deque>());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&ChunkScheduler::work, this, i);
+    }
+}
+
+ChunkScheduler::~ChunkScheduler() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto &worker: m_workers) {
+        worker.join();
+    }
+}
+
+void ChunkScheduler::add(Step step) {
+    {
+        std::lock_guard lock(m_mutex);
+        ++m_uploads;
+    }
+    const size_t worker = currentScheduler == this
+                              ? currentWorker
+                              : m_nextDeque.fetch_add(1, std::memory_order_relaxed) % m_deques.size();
+    push(worker, std::make_shared<Step>(std::move(step)));
+}
+
+void ChunkScheduler::push(size_t worker, std::shared_ptr<Step> step) {
+    {
+        // counted first, a worker taking it right away does not find fewer uploads than it took
+        std::lock_guard lock(m_mutex);
+        ++m_waiting;
+    }
+    {
+        std::lock_guard lock(m_deques[worker]->mutex);
+        m_deques[worker]->steps.push_back(std::move(step));
+    }
+    // an idle worker can steal it, the condition is shared with wait()
+    m_condition.notify_all();
+}
+
+std::shared_ptr<ChunkScheduler::Step> ChunkScheduler::take(size_t worker) {
+    {
+        // its own uploads in turn, from the front
+        Deque &own = *m_deques[worker];
+        std::lock_guard lock(own.mutex);
+        if (!own.steps.empty()) {
+            std::shared_ptr<Step> step = std::move(own.steps.front());
+            own.steps.pop_front();
+            return step;
+        }
+    }
+    // from the back of the others, the upload that would wait the longest for its worker
+    for (size_t i = 1; i < m_deques.size(); ++i) {
+        Deque &victim = *m_deques[(worker + i) % m_deques.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.steps.empty()) {
+            std::shared_ptr<Step> step = std::move(victim.steps.back());
+            victim.steps.pop_back();
+            m_stolenSteps.fetch_add(1, std::memory_order_relaxed);
+            return step;
+        }
+    }
+    return nullptr;
+}
+
+void ChunkScheduler::work(size_t worker) {
+    currentScheduler = this;
+    currentWorker = worker;
+    while (true) {
+        std::shared_ptr<Step> step = take(worker);
+        if (step == nullptr) {
+            std::unique_lock lock(m_mutex);
+            // an upload counted as waiting can be taken by another worker at the same time, it is looked for again
+            m_condition.wait(lock, [this] { return m_stopping || m_waiting > 0; });
+            if (m_stopping) {
+                return;
+            }
+            continue;
+        }
+        {
+            std::lock_guard lock(m_mutex);
+            --m_waiting;
+            if (m_stopping) {
+                return;
+            }
+        }
+        bool next = false;
+        try {
+            next = (*step)();
+        } catch (...) {
+            // the step reports the errors of its upload, an exception ends it
+        }
+        if (next) {
+            // behind the other uploads of this worker, the chunks of the uploads are interleaved
+            push(worker, std::move(step));
+            continue;
+        }
+        {
+            std::lock_guard lock(m_mutex);
+            --m_uploads;
+        }
+        m_condition.notify_all();
+    }
+}
+
+void ChunkScheduler::wait() {
+    std::unique_lock lock(m_mutex);
+    m_condition.wait(lock, [this] { return m_uploads == 0 || m_stopping; });
+}
+
+size_t ChunkScheduler::getWorkers() const {
+    return m_workers.size();
+}
+
+size_t ChunkScheduler::getUploads() const {
+    std::lock_guard lock(m_mutex);
+    return m_uploads;
+}
+
+uint64_t ChunkScheduler::getStolenSteps() const {
+    return m_stolenSteps.load(std::memory_order_relaxed);
+}
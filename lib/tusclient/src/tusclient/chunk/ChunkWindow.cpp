@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <climits>
+
+#include "chunk/ChunkWindow.h"
+#include "chunk/utility/ChunkUtility.h"
+
+using TUS::Chunk::ChunkWindow;
+using TUS::Chunk::TUSChunk;
+
+ChunkWindow::ChunkWindow(const IFileChunker<TUSChunk> &chunker, uint64_t fileSize, size_t memoryLimit,
+                         size_t readAhead)
+    : m_chunker(chunker), m_chunkSize(chunker.getChunkSize()),
+      m_capacity(std::clamp<size_t>(m_chunkSize == 0 ? 1 : memoryLimit / m_chunkSize, 1, readAhead + 1)),
+      m_fileSize(fileSize),
+      m_chunkNumber(fileSize == UNKNOWN_SIZE
+                        ? INT_MAX
+                        : Utility::ChunkUtility::getChunkCount(fileSize, static_cast<int64_t>(m_chunkSize))),
+      m_reader(&ChunkWindow::readChunks, this) {
+}
+
+ChunkWindow::~ChunkWindow() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    m_reader.join();
+}
+
+const TUSChunk &ChunkWindow::get(int chunkNumber) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Slot &slot = request(chunkNumber);
+    m_condition.wait(lock, [&slot]() { return slot.ready; });
+    return take(chunkNumber, slot);
+}
+
+const TUSChunk *ChunkWindow::tryGet(int chunkNumber) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Slot &slot = request(chunkNumber);
+    if (!slot.ready) {
+        return nullptr;
+    }
+    return &take(chunkNumber, slot);
+}
+
+void ChunkWindow::release(uint64_t offset) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // a chunk is freed when the offset is past its last byte
+    while (!m_chunks.empty() &&
+           std::min((static_cast<uint64_t>(m_chunks.begin()->first) + 1) * m_chunkSize, m_fileSize) <= offset) {
+        // its buffer goes back to the pool and is read into by the next chunk
+        m_chunks.erase(m_chunks.begin());
+    }
+}
+
+std::optional<uint64_t> ChunkWindow::getFileSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fileSize == UNKNOWN_SIZE) {
+        return std::nullopt;
+    }
+    return m_fileSize;
+}
+
+uint64_t ChunkWindow::getChunkSize() const {
+    return m_chunkSize;
+}
+
+size_t ChunkWindow::getCapacity() const {
+    return m_capacity;
+}
+
+size_t ChunkWindow::getResidentChunks() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_chunks.size();
+}
+
+ChunkWindow::Slot &ChunkWindow::request(int chunkNumber) {
+    if (!m_chunks.contains(chunkNumber)) {
+        // the upload went back, e.g. the server has less bytes than expected: the chunks ahead make room
+        while (m_chunks.size() >= m_capacity) {
+            m_chunks.erase(std::prev(m_chunks.end()));
+        }
+        schedule(chunkNumber, true);
+    }
+    for (int next = chunkNumber + 1; next < m_chunkNumber && m_chunks.size() < m_capacity; ++next) {
+        if (!m_chunks.contains(next)) {
+            schedule(next, false);
+        }
+    }
+    m_condition.notify_all();
+    return m_chunks.at(chunkNumber);
+}
+
+const TUSChunk &ChunkWindow::take(int chunkNumber, Slot &slot) {
+    if (slot.error != nullptr) {
+        // it is read again by the next request
+        const std::exception_ptr error = slot.error;
+        m_chunks.erase(chunkNumber);
+        std::rethrow_exception(error);
+    }
+    return *slot.chunk;
+}
+
+void ChunkWindow::schedule(int chunkNumber, bool first) {
+    m_chunks.try_emplace(chunkNumber);
+    if (first) {
+        m_queue.push_front(chunkNumber);
+    } else {
+        m_queue.push_back(chunkNumber);
+    }
+}
+
+void ChunkWindow::readChunks() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+        if (m_stopping) {
+            return;
+        }
+        const int chunkNumber = m_queue.front();
+        m_queue.pop_front();
+        auto slot = m_chunks.find(chunkNumber);
+        if (slot == m_chunks.end() || slot->second.reading || slot->second.ready) {
+            continue; // released or evicted before it was read, or queued twice
+        }
+        slot->second.reading = true;
+
+        // the file is read without the lock, the uploader keeps sending the chunk it has
+        lock.unlock();
+        Slot read;
+        try {
+            read.chunk.emplace(m_chunker.getChunk(chunkNumber));
+        } catch (...) {
+            read.error = std::current_exception();
+        }
+        lock.lock();
+
+        slot = m_chunks.find(chunkNumber);
+        if (slot == m_chunks.end() || !slot->second.reading) {
+            continue; // evicted while it was read
+        }
+        if (m_fileSize == UNKNOWN_SIZE && read.chunk.has_value() && read.chunk->getChunkSize() < m_chunkSize) {
+            // the end of the stream, the chunks after it are not read ahead
+            m_fileSize = static_cast<uint64_t>(chunkNumber) * m_chunkSize + read.chunk->getChunkSize();
+            m_chunkNumber = chunkNumber + 1;
+        }
+        slot->second.chunk = std::move(read.chunk);
+        slot->second.error = read.error;
+        slot->second.reading = false;
+        slot->second.ready = true;
+        m_condition.notify_all();
+    }
+}
@@ -3,49 +3,40 @@
  * This file is part of libtusclient, licensed under the MIT License.
  * See the LICENSE file in the project root for more information.
  */
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 #include <filesystem>
 
 #include "chunk/FileChunker.h"
 #include "chunk/TUSChunk.h"
+#include "chunk/utility/BufferPool.h"
 #include "chunk/utility/ChunkUtility.h"
 #include "verifiers/Md5Verifier.h"
 #include <fmt/core.h>
 
 using TUS::Chunk::FileChunker;
 using TUS::Chunk::TUSChunk;
+using TUS::Chunk::Utility::BufferPool;
 using TUS::Chunk::Utility::ChunkUtility;
 
 void FileChunker::calculateChunkSize() {
-    m_chunkNumber = 0;
-    auto fileSize = std::filesystem::file_size(m_filePath);
-    if (static_cast<int64_t>(fileSize) >= ChunkUtility::getChunkSizeFromGB(1)) {
-        m_chunkSize = ChunkUtility::getChunkSizeFromMB(10);
-    } else if (static_cast<int64_t>(fileSize) >= ChunkUtility::getChunkSizeFromMB(100)) {
-        m_chunkSize = ChunkUtility::getChunkSizeFromMB(5);
-    } else if (static_cast<int64_t>(fileSize) >= ChunkUtility::getChunkSizeFromMB(50)) {
-        m_chunkSize = ChunkUtility::getChunkSizeFromMB(2);
-    } else if (static_cast<int64_t>(fileSize) >= ChunkUtility::getChunkSizeFromMB(10)) {
-        m_chunkSize = static_cast<int>(ChunkUtility::getChunkSizeFromMB(1));
-    } else {
-        m_chunkSize = std::filesystem::file_size(m_filePath); // no chunking, upload the whole file
-        m_chunkNumber = 1;
-        return;
-    }
-
-    m_chunkNumber = static_cast<int>((fileSize + m_chunkSize - 1) / m_chunkSize);
+    const auto fileSize = std::filesystem::file_size(m_filePath);
+    m_chunkSize = ChunkUtility::getDefaultChunkSize(fileSize);
+    m_chunkNumber = ChunkUtility::getChunkCount(fileSize, m_chunkSize);
 }
 
 FileChunker::FileChunker(std::string appName, std::string uuid, std::filesystem::path filepath, int chunkSize,
                          std::unique_ptr<FileVerifier::IFileVerifier> verifier)
     : CHUNK_FILE_NAME_PREFIX("_chunk_"), CHUNK_FILE_EXTENSION(".bin"), m_appName(std::move(appName)),
       m_uuid(std::move(uuid)), m_tempDir(std::filesystem::temp_directory_path() / "TUS"),
-      m_filePath(std::move(filepath)) {
+      m_filePath(std::move(filepath)), m_buffers(BufferPool::getShared()) {
     if (chunkSize > 0) {
         m_chunkSize = chunkSize;
+        m_chunkNumber = ChunkUtility::getChunkCount(std::filesystem::file_size(m_filePath), m_chunkSize);
     } else {
         calculateChunkSize();
     }
@@ -74,28 +65,33 @@ std::filesystem::path FileChunker::getChunkFilePath(int chunkNumber) const {
     return getTemporaryDir() / getChunkFilename(chunkNumber);
 }
 
-bool FileChunker::loadChunks() {
-    m_chunks.clear(); // Clear any existing chunks
+TUSChunk FileChunker::readChunkFile(int chunkNumber) const {
+    std::filesystem::path chunkFilePath = getTemporaryDir() / getChunkFilename(chunkNumber);
 
-    for (int i = 0; i < m_chunkNumber; i++) {
-        std::filesystem::path chunkFilePath = getTemporaryDir() / getChunkFilename(i);
+    std::ifstream chunkFile(chunkFilePath, std::ios::binary);
+    if (!chunkFile) {
+        throw std::runtime_error("Failed to open chunk file: " + chunkFilePath.string());
+    }
 
-        std::ifstream chunkFile(chunkFilePath, std::ios::binary);
-        if (!chunkFile) {
-            throw std::runtime_error("Failed to open chunk file: " + chunkFilePath.string());
-        }
+    chunkFile.seekg(0, std::ios::end); // Seek to the end of the file to get the size
+    std::streamsize chunkSize = chunkFile.tellg();
+    // Get the current position in the file, which is the size of the file
+    chunkFile.seekg(0, std::ios::beg); // Seek back to the beginning of the file
+
+    // the capacity of a whole chunk, the buffer of the last one is reused too
+    std::shared_ptr<uint8_t> buffer = m_buffers->acquire(static_cast<size_t>(std::max<int64_t>(chunkSize, m_chunkSize)));
+    chunkFile.read(reinterpret_cast<char *>(buffer.get()), chunkSize);
+    chunkFile.close();
 
-        chunkFile.seekg(0, std::ios::end); // Seek to the end of the file to get the size
-        std::streamsize chunkSize = chunkFile.tellg();
-        // Get the current position in the file, which is the size of the file
-        chunkFile.seekg(0, std::ios::beg); // Seek back to the beginning of the file
+    const uint8_t *bytes = buffer.get();
+    return {std::move(buffer), bytes, static_cast<size_t>(chunkSize)};
+}
 
-        std::vector<uint8_t> chunkData(chunkSize);
-        chunkFile.read(reinterpret_cast<char *>(chunkData.data()), chunkSize);
-        chunkFile.close();
+bool FileChunker::loadChunks() {
+    m_chunks.clear(); // Clear any existing chunks
 
-        TUSChunk chunk(chunkData, chunkSize);
-        m_chunks.push_back(chunk);
+    for (int i = 0; i < m_chunkNumber; i++) {
+        m_chunks.push_back(readChunkFile(i));
     }
     return true;
 }
@@ -156,6 +152,18 @@ std::vector<TUSChunk> FileChunker::getChunks() const {
     return m_chunks;
 }
 
+TUSChunk FileChunker::getChunk(int chunkNumber) const {
+    if (m_chunks.empty()) {
+        // the chunks are not in memory, only this one is read
+        if (chunkNumber < 0 || chunkNumber >= m_chunkNumber) {
+            throw std::out_of_range(fmt::format("Chunk {} out of range, the file has {} chunks", chunkNumber,
+                                                m_chunkNumber));
+        }
+        return readChunkFile(chunkNumber);
+    }
+    return m_chunks.at(chunkNumber);
+}
+
 int FileChunker::getChunkNumber() const {
     if (m_chunks.empty()) {
         return 0;
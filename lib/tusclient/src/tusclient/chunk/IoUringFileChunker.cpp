@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fmt/core.h>
+
+#include "chunk/IoUringFileChunker.h"
+#include "chunk/TUSChunk.h"
+#include "chunk/utility/BufferPool.h"
+#include "chunk/utility/ChunkUtility.h"
+#include "chunk/utility/IoUringReader.h"
+#include "chunk/utility/SourceFile.h"
+#include "exceptions/TUSException.h"
+
+using TUS::Chunk::IoUringFileChunker;
+using TUS::Chunk::TUSChunk;
+using TUS::Chunk::Utility::BufferPool;
+using TUS::Chunk::Utility::ChunkUtility;
+using TUS::Chunk::Utility::IoUringReader;
+using TUS::Chunk::Utility::SourceFile;
+
+namespace {
+    constexpr size_t ALIGNMENT = SourceFile::DIRECT_IO_ALIGNMENT;
+    static_assert(BufferPool::ALIGNMENT % ALIGNMENT == 0, "the buffers of the pool are read with direct I/O");
+
+    constexpr std::uint64_t alignUp(std::uint64_t value) {
+        return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+}
+
+IoUringFileChunker::IoUringFileChunker(path filepath, int chunkSize, bool directIo)
+    : m_filePath(std::move(filepath)), m_directIo(directIo), m_buffers(BufferPool::getShared()) {
+    const auto fileSize = std::filesystem::file_size(m_filePath);
+    m_chunkSize = chunkSize > 0 ? chunkSize : ChunkUtility::getDefaultChunkSize(fileSize);
+    if (m_directIo) {
+        // every chunk starts at an aligned offset
+        m_chunkSize = static_cast<int64_t>(alignUp(m_chunkSize));
+    }
+    m_chunkNumber = ChunkUtility::getChunkCount(fileSize, m_chunkSize);
+}
+
+IoUringFileChunker::~IoUringFileChunker() = default;
+
+bool IoUringFileChunker::loadChunks() {
+    if (m_source == nullptr) {
+        chunkFile();
+    }
+    return true;
+}
+
+bool IoUringFileChunker::removeChunkFiles() {
+    return true;
+}
+
+path IoUringFileChunker::getTemporaryDir() const {
+    return {};
+}
+
+string IoUringFileChunker::getChunkFilename([[maybe_unused]] int chunkNumber) const {
+    return m_filePath.filename().string();
+}
+
+path IoUringFileChunker::getChunkFilePath([[maybe_unused]] int chunkNumber) const {
+    return m_filePath;
+}
+
+int IoUringFileChunker::chunkFile() {
+    m_source = std::make_unique<SourceFile>(m_filePath, m_directIo);
+    m_chunkNumber = ChunkUtility::getChunkCount(m_source->getSize(), m_chunkSize);
+#ifdef __linux__
+    m_reader = IoUringReader::getShared();
+#endif
+    return m_chunkNumber;
+}
+
+void IoUringFileChunker::clearChunks() {
+    m_source.reset();
+    m_reader.reset();
+}
+
+std::vector<TUSChunk> IoUringFileChunker::getChunks() const {
+    std::vector<TUSChunk> chunks;
+    chunks.reserve(m_chunkNumber);
+    for (int i = 0; i < m_chunkNumber; i++) {
+        chunks.push_back(getChunk(i));
+    }
+    return chunks;
+}
+
+TUSChunk IoUringFileChunker::getChunk(int chunkNumber) const {
+    if (m_source == nullptr) {
+        throw std::runtime_error("The file is not open. Call chunkFile() or loadChunks() first.");
+    }
+    if (chunkNumber < 0 || chunkNumber >= m_chunkNumber) {
+        throw std::out_of_range(fmt::format("Chunk {} out of range, the file has {} chunks", chunkNumber,
+                                            m_chunkNumber));
+    }
+    const uint64_t offset = static_cast<uint64_t>(chunkNumber) * m_chunkSize;
+    const auto size = static_cast<size_t>(std::min<uint64_t>(m_chunkSize, m_source->getSize() - offset));
+    // a direct read of the last chunk is rounded up too, it stops at the end of the file
+    const auto readSize = static_cast<size_t>(m_source->isDirect() ? alignUp(size) : size);
+
+    std::shared_ptr<uint8_t> buffer = m_buffers->acquire(alignUp(m_chunkSize));
+    std::optional<size_t> bytesRead;
+#ifdef __linux__
+    if (usesIoUring()) {
+        try {
+            bytesRead = m_reader->read(m_source->getNativeHandle(), offset, buffer.get(), readSize);
+        } catch (const std::runtime_error &) {
+            if (!m_reader->isBroken()) {
+                throw;
+            }
+            // the ring failed during the read, the chunk is read with pread like the next ones
+        }
+    }
+#endif
+    if (!bytesRead.has_value()) {
+        bytesRead = m_source->readAt(offset, buffer.get(), readSize);
+    }
+    // checked after the read, a write that raced with it changed the last write time
+    if (*bytesRead < size || m_source->hasChanged()) {
+        throw TUS::Exceptions::TUSException("The file changed during the upload: " + m_filePath.string());
+    }
+    const uint8_t *bytes = buffer.get();
+    return {std::move(buffer), bytes, size};
+}
+
+int IoUringFileChunker::getChunkNumber() const {
+    if (m_source == nullptr) {
+        return 0;
+    }
+    return m_chunkNumber;
+}
+
+size_t IoUringFileChunker::getChunkSize() const {
+    return m_chunkSize;
+}
+
+bool IoUringFileChunker::usesIoUring() const {
+    return m_reader != nullptr && !m_reader->isBroken();
+}
+
+bool IoUringFileChunker::usesDirectIo() const {
+    return m_source != nullptr && m_source->isDirect();
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fmt/core.h>
+
+#include "chunk/MappedFileChunker.h"
+#include "chunk/TUSChunk.h"
+#include "chunk/utility/ChunkUtility.h"
+#include "chunk/utility/MappedFile.h"
+#include "exceptions/TUSException.h"
+
+using TUS::Chunk::MappedFileChunker;
+using TUS::Chunk::TUSChunk;
+using TUS::Chunk::Utility::ChunkUtility;
+using TUS::Chunk::Utility::MappedFile;
+
+MappedFileChunker::MappedFileChunker(path filepath, int chunkSize) : m_filePath(std::move(filepath)) {
+    const auto fileSize = std::filesystem::file_size(m_filePath);
+    m_chunkSize = chunkSize > 0 ? chunkSize : ChunkUtility::getDefaultChunkSize(fileSize);
+    m_chunkNumber = ChunkUtility::getChunkCount(fileSize, m_chunkSize);
+}
+
+MappedFileChunker::~MappedFileChunker() = default;
+
+bool MappedFileChunker::loadChunks() {
+    if (m_mapping == nullptr) {
+        chunkFile();
+    }
+    return true;
+}
+
+bool MappedFileChunker::removeChunkFiles() {
+    return true;
+}
+
+path MappedFileChunker::getTemporaryDir() const {
+    return {};
+}
+
+string MappedFileChunker::getChunkFilename([[maybe_unused]] int chunkNumber) const {
+    return m_filePath.filename().string();
+}
+
+path MappedFileChunker::getChunkFilePath([[maybe_unused]] int chunkNumber) const {
+    return m_filePath;
+}
+
+int MappedFileChunker::chunkFile() {
+    m_mapping = std::make_shared<MappedFile>(m_filePath);
+    m_chunkNumber = ChunkUtility::getChunkCount(m_mapping->getSize(), m_chunkSize);
+    return m_chunkNumber;
+}
+
+void MappedFileChunker::clearChunks() {
+    m_mapping.reset();
+}
+
+std::vector<TUSChunk> MappedFileChunker::getChunks() const {
+    std::vector<TUSChunk> chunks;
+    chunks.reserve(m_chunkNumber);
+    for (int i = 0; i < m_chunkNumber; i++) {
+        chunks.push_back(getChunk(i));
+    }
+    return chunks;
+}
+
+TUSChunk MappedFileChunker::getChunk(int chunkNumber) const {
+    if (m_mapping == nullptr) {
+        throw std::runtime_error("The file is not mapped. Call chunkFile() or loadChunks() first.");
+    }
+    if (chunkNumber < 0 || chunkNumber >= m_chunkNumber) {
+        throw std::out_of_range(fmt::format("Chunk {} out of range, the file has {} chunks", chunkNumber,
+                                            m_chunkNumber));
+    }
+    if (m_mapping->hasChanged()) {
+        throw TUS::Exceptions::TUSException("The file changed during the upload: " + m_filePath.string());
+    }
+    const uint64_t offset = static_cast<uint64_t>(chunkNumber) * m_chunkSize;
+    const auto size = static_cast<size_t>(std::min<uint64_t>(m_chunkSize, m_mapping->getSize() - offset));
+    m_mapping->willNeed(offset, size);
+    // the pages of the chunk are dropped with its last copy, the mapping lives as long as the chunks
+    std::shared_ptr<const void> owner(m_mapping->getData() + offset,
+                                      [mapping = m_mapping, offset, size](const void *) {
+                                          mapping->discard(offset, size);
+                                      });
+    return {std::move(owner), m_mapping->getData() + offset, size};
+}
+
+int MappedFileChunker::getChunkNumber() const {
+    if (m_mapping == nullptr) {
+        return 0;
+    }
+    return m_chunkNumber;
+}
+
+size_t MappedFileChunker::getChunkSize() const {
+    return m_chunkSize;
+}
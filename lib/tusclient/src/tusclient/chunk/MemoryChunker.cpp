@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fmt/core.h>
+
+#include "chunk/MemoryChunker.h"
+#include "chunk/TUSChunk.h"
+#include "chunk/utility/ChunkUtility.h"
+
+using TUS::Chunk::MemoryChunker;
+using TUS::Chunk::TUSChunk;
+using TUS::Chunk::Utility::ChunkUtility;
+
+MemoryChunker::MemoryChunker(string name, std::span<const std::byte> data, int chunkSize,
+                             std::shared_ptr<const void> owner)
+    : m_name(std::move(name)), m_data(data), m_owner(std::move(owner)) {
+    m_chunkSize = chunkSize > 0 ? chunkSize : ChunkUtility::getDefaultChunkSize(m_data.size());
+    m_chunkNumber = ChunkUtility::getChunkCount(m_data.size(), m_chunkSize);
+}
+
+MemoryChunker::~MemoryChunker() = default;
+
+bool MemoryChunker::loadChunks() {
+    return true;
+}
+
+bool MemoryChunker::removeChunkFiles() {
+    return true;
+}
+
+path MemoryChunker::getTemporaryDir() const {
+    return {};
+}
+
+string MemoryChunker::getChunkFilename([[maybe_unused]] int chunkNumber) const {
+    return m_name;
+}
+
+path MemoryChunker::getChunkFilePath([[maybe_unused]] int chunkNumber) const {
+    return {};
+}
+
+int MemoryChunker::chunkFile() {
+    return m_chunkNumber;
+}
+
+void MemoryChunker::clearChunks() {
+}
+
+std::vector<TUSChunk> MemoryChunker::getChunks() const {
+    std::vector<TUSChunk> chunks;
+    chunks.reserve(m_chunkNumber);
+    for (int i = 0; i < m_chunkNumber; i++) {
+        chunks.push_back(getChunk(i));
+    }
+    return chunks;
+}
+
+TUSChunk MemoryChunker::getChunk(int chunkNumber) const {
+    if (chunkNumber < 0 || chunkNumber >= m_chunkNumber) {
+        throw std::out_of_range(fmt::format("Chunk {} out of range, the data has {} chunks", chunkNumber,
+                                            m_chunkNumber));
+    }
+    const uint64_t offset = static_cast<uint64_t>(chunkNumber) * m_chunkSize;
+    const auto size = static_cast<size_t>(std::min<uint64_t>(m_chunkSize, m_data.size() - offset));
+    return {m_owner, reinterpret_cast<const uint8_t *>(m_data.data()) + offset, size};
+}
+
+int MemoryChunker::getChunkNumber() const {
+    return m_chunkNumber;
+}
+
+size_t MemoryChunker::getChunkSize() const {
+    return m_chunkSize;
+}
+
+uint64_t MemoryChunker::getSize() const {
+    return m_data.size();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fmt/core.h>
+
+#include "chunk/SourceFileChunker.h"
+#include "chunk/TUSChunk.h"
+#include "chunk/utility/BufferPool.h"
+#include "chunk/utility/ChunkUtility.h"
+#include "chunk/utility/SourceFile.h"
+#include "exceptions/TUSException.h"
+
+using TUS::Chunk::SourceFileChunker;
+using TUS::Chunk::TUSChunk;
+using TUS::Chunk::Utility::BufferPool;
+using TUS::Chunk::Utility::ChunkUtility;
+using TUS::Chunk::Utility::SourceFile;
+
+SourceFileChunker::SourceFileChunker(path filepath, int chunkSize)
+    : m_filePath(std::move(filepath)), m_buffers(BufferPool::getShared()) {
+    const auto fileSize = std::filesystem::file_size(m_filePath);
+    m_chunkSize = chunkSize > 0 ? chunkSize : ChunkUtility::getDefaultChunkSize(fileSize);
+    m_chunkNumber = ChunkUtility::getChunkCount(fileSize, m_chunkSize);
+}
+
+SourceFileChunker::~SourceFileChunker() = default;
+
+bool SourceFileChunker::loadChunks() {
+    if (m_source == nullptr) {
+        chunkFile();
+    }
+    return true;
+}
+
+bool SourceFileChunker::removeChunkFiles() {
+    return true;
+}
+
+path SourceFileChunker::getTemporaryDir() const {
+    return {};
+}
+
+string SourceFileChunker::getChunkFilename([[maybe_unused]] int chunkNumber) const {
+    return m_filePath.filename().string();
+}
+
+path SourceFileChunker::getChunkFilePath([[maybe_unused]] int chunkNumber) const {
+    return m_filePath;
+}
+
+int SourceFileChunker::chunkFile() {
+    // the size is taken again, the file can have changed since the chunker was created
+    m_source = std::make_unique<SourceFile>(m_filePath);
+    m_chunkNumber = ChunkUtility::getChunkCount(m_source->getSize(), m_chunkSize);
+    return m_chunkNumber;
+}
+
+void SourceFileChunker::clearChunks() {
+    m_source.reset();
+}
+
+std::vector<TUSChunk> SourceFileChunker::getChunks() const {
+    std::vector<TUSChunk> chunks;
+    chunks.reserve(m_chunkNumber);
+    for (int i = 0; i < m_chunkNumber; i++) {
+        chunks.push_back(getChunk(i));
+    }
+    return chunks;
+}
+
+TUSChunk SourceFileChunker::getChunk(int chunkNumber) const {
+    if (m_source == nullptr) {
+        throw std::runtime_error("The file is not open. Call chunkFile() or loadChunks() first.");
+    }
+    if (chunkNumber < 0 || chunkNumber >= m_chunkNumber) {
+        throw std::out_of_range(fmt::format("Chunk {} out of range, the file has {} chunks", chunkNumber,
+                                            m_chunkNumber));
+    }
+    const uint64_t offset = static_cast<uint64_t>(chunkNumber) * m_chunkSize;
+    const auto size = static_cast<size_t>(std::min<uint64_t>(m_chunkSize, m_source->getSize() - offset));
+    // every chunk asks for the same capacity, the buffer of a chunk already sent is reused
+    std::shared_ptr<uint8_t> buffer = m_buffers->acquire(static_cast<size_t>(m_chunkSize));
+    // checked after the read, a write that raced with it changed the last write time
+    if (m_source->readAt(offset, buffer.get(), size) != size || m_source->hasChanged()) {
+        throw TUS::Exceptions::TUSException("The file changed during the upload: " + m_filePath.string());
+    }
+    const uint8_t *bytes = buffer.get();
+    return {std::move(buffer), bytes, size};
+}
+
+int SourceFileChunker::getChunkNumber() const {
+    if (m_source == nullptr) {
+        return 0;
+    }
+    return m_chunkNumber;
+}
+
+size_t SourceFileChunker::getChunkSize() const {
+    return m_chunkSize;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fmt/core.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "chunk/StreamChunker.h"
+#include "chunk/TUSChunk.h"
+#include "chunk/utility/BufferPool.h"
+#include "exceptions/TUSException.h"
+
+using TUS::Chunk::StreamChunker;
+using TUS::Chunk::StreamReader;
+using TUS::Chunk::TUSChunk;
+using TUS::Chunk::Utility::BufferPool;
+
+StreamChunker::StreamChunker(string name, StreamReader reader, int chunkSize)
+    : m_name(std::move(name)), m_chunkSize(chunkSize > 0 ? chunkSize : DEFAULT_CHUNK_SIZE),
+      m_reader(std::move(reader)), m_buffers(BufferPool::getShared()) {
+}
+
+StreamChunker::~StreamChunker() = default;
+
+StreamReader StreamChunker::readFileDescriptor(int fd) {
+    return [fd](uint8_t *buffer, size_t size) -> size_t {
+        while (true) {
+#ifdef _WIN32
+            const int count = _read(fd, buffer, static_cast<unsigned>(std::min<size_t>(size, INT_MAX)));
+#else
+            const ssize_t count = ::read(fd, buffer, size);
+#endif
+            if (count >= 0) {
+                return static_cast<size_t>(count);
+            }
+            if (errno != EINTR) {
+                throw TUS::Exceptions::TUSException(fmt::format("Unable to read the stream: {}",
+                                                                std::strerror(errno)));
+            }
+        }
+    };
+}
+
+StreamReader StreamChunker::readStream(std::istream &stream) {
+    return [&stream](uint8_t *buffer, size_t size) -> size_t {
+        stream.read(reinterpret_cast<char *>(buffer), static_cast<std::streamsize>(size));
+        if (stream.bad()) {
+            throw TUS::Exceptions::TUSException("Unable to read the stream");
+        }
+        return static_cast<size_t>(stream.gcount());
+    };
+}
+
+bool StreamChunker::loadChunks() {
+    return true;
+}
+
+bool StreamChunker::removeChunkFiles() {
+    return true;
+}
+
+path StreamChunker::getTemporaryDir() const {
+    return {};
+}
+
+string StreamChunker::getChunkFilename([[maybe_unused]] int chunkNumber) const {
+    return m_name;
+}
+
+path StreamChunker::getChunkFilePath([[maybe_unused]] int chunkNumber) const {
+    return {};
+}
+
+int StreamChunker::chunkFile() {
+    return getChunkNumber();
+}
+
+void StreamChunker::clearChunks() {
+}
+
+std::vector<TUSChunk> StreamChunker::getChunks() const {
+    std::vector<TUSChunk> chunks;
+    while (!m_ended) {
+        chunks.push_back(getChunk(m_nextChunk));
+    }
+    return chunks;
+}
+
+TUSChunk StreamChunker::getChunk(int chunkNumber) const {
+    std::lock_guard lock(m_mutex);
+    if (m_ended && chunkNumber >= m_nextChunk) {
+        return {std::vector<uint8_t>(), 0}; // after the end of the stream
+    }
+    if (chunkNumber != m_nextChunk) {
+        throw std::out_of_range(fmt::format("Chunk {} of the stream cannot be read, the next one is {}",
+                                            chunkNumber, m_nextChunk.load()));
+    }
+    std::shared_ptr<uint8_t> buffer = m_buffers->acquire(static_cast<size_t>(m_chunkSize));
+    size_t size = 0;
+    // a pipe or a socket returns the bytes available, the chunk is filled by several reads
+    while (size < static_cast<size_t>(m_chunkSize)) {
+        const size_t count = m_reader(buffer.get() + size, static_cast<size_t>(m_chunkSize) - size);
+        if (count == 0) {
+            m_ended = true;
+            break;
+        }
+        size += count;
+    }
+    ++m_nextChunk;
+    const uint8_t *bytes = buffer.get();
+    return {std::move(buffer), bytes, size};
+}
+
+int StreamChunker::getChunkNumber() const {
+    return m_nextChunk;
+}
+
+size_t StreamChunker::getChunkSize() const {
+    return m_chunkSize;
+}
+
+bool StreamChunker::hasEnded() const {
+    return m_ended;
+}
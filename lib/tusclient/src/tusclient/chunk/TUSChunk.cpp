@@ -10,17 +10,24 @@
 
 using TUS::Chunk::TUSChunk;
 
-TUSChunk::TUSChunk(std::vector<uint8_t> data, size_t offset)
-    : m_data(std::move(data)), m_chunkSize(offset) {
+TUSChunk::TUSChunk(std::vector<uint8_t> data, size_t offset) {
+    auto buffer = std::make_shared<const std::vector<uint8_t> >(std::move(data));
+    m_data = std::span<const uint8_t>(buffer->data(), offset);
+    m_owner = std::move(buffer);
 }
 
-std::vector<uint8_t> TUSChunk::getData() const {
-    return m_data;
+TUSChunk::TUSChunk(std::shared_ptr<const void> owner, const uint8_t *data, size_t size)
+    : m_owner(std::move(owner)), m_data(data, size) {
 }
 
-size_t TUSChunk::getChunkSize() const {
-    return m_chunkSize;
+std::span<const uint8_t> TUSChunk::getData() const {
+    return m_data;
 }
 
+const uint8_t *TUSChunk::getBytes() const {
+    return m_data.data();
+}
 
-
+size_t TUSChunk::getChunkSize() const {
+    return m_data.size();
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <algorithm>
+#include <new>
+
+#include "chunk/utility/BufferPool.h"
+
+using TUS::Chunk::Utility::BufferPool;
+
+namespace {
+    void freeBuffer(uint8_t *buffer) {
+        ::operator delete(buffer, std::align_val_t(BufferPool::ALIGNMENT));
+    }
+}
+
+std::shared_ptr<BufferPool> BufferPool::getShared() {
+    // kept for the whole process, the chunks of static objects hold it until they are destroyed
+    static const std::shared_ptr<BufferPool> shared = std::make_shared<BufferPool>();
+    return shared;
+}
+
+BufferPool::BufferPool(size_t idleLimit) : m_idleLimit(idleLimit) {
+}
+
+BufferPool::~BufferPool() {
+    for (const auto &[capacity, buffers]: m_free) {
+        std::for_each(buffers.begin(), buffers.end(), freeBuffer);
+    }
+}
+
+std::shared_ptr<uint8_t> BufferPool::acquire(size_t size) {
+    const size_t capacity = getCapacity(size);
+    uint8_t *buffer = nullptr;
+    {
+        std::lock_guard lock(m_mutex);
+        if (auto it = m_free.find(capacity); it != m_free.end()) {
+            buffer = it->second.back();
+            it->second.pop_back();
+            if (it->second.empty()) {
+                m_free.erase(it);
+            }
+            m_idleBytes -= capacity;
+        }
+    }
+    if (buffer == nullptr) {
+        buffer = static_cast<uint8_t *>(::operator new(capacity, std::align_val_t(ALIGNMENT)));
+    }
+    return {buffer, [pool = shared_from_this(), capacity](uint8_t *released) {
+        pool->release(released, capacity);
+    }};
+}
+
+size_t BufferPool::getCapacity(size_t size) {
+    return (std::max<size_t>(size, 1) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+size_t BufferPool::getIdleBytes() const {
+    std::lock_guard lock(m_mutex);
+    return m_idleBytes;
+}
+
+void BufferPool::setIdleLimit(size_t idleLimit) {
+    std::lock_guard lock(m_mutex);
+    m_idleLimit = idleLimit;
+    trim();
+}
+
+void BufferPool::release(uint8_t *buffer, size_t capacity) {
+    std::lock_guard lock(m_mutex);
+    m_free[capacity].push_back(buffer);
+    m_idleBytes += capacity;
+    trim();
+}
+
+void BufferPool::trim() {
+    // the largest idle buffers are freed first
+    while (m_idleBytes > m_idleLimit) {
+        auto largest = std::prev(m_free.end());
+        freeBuffer(largest->second.back());
+        largest->second.pop_back();
+        m_idleBytes -= largest->first;
+        if (largest->second.empty()) {
+            m_free.erase(largest);
+        }
+    }
+}
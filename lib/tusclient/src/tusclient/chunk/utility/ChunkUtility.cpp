@@ -5,18 +5,54 @@
  */
 
 #include "chunk/utility/ChunkUtility.h"
+
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+#include <fmt/core.h>
+
 constexpr auto KB = 1000;
 
 using TUS::Chunk::Utility::ChunkUtility;
 
 std::int64_t ChunkUtility::getChunkSizeFromGB(int size) {
-      return static_cast<std::int64_t>(size * KB * KB * KB);
+      return static_cast<std::int64_t>(size) * KB * KB * KB;
 }
 
 std::int64_t ChunkUtility::getChunkSizeFromMB(int size) {
-      return static_cast<std::int64_t>(size * KB * KB);
+      return static_cast<std::int64_t>(size) * KB * KB;
 }
 
 std::int64_t ChunkUtility::getChunkSizeFromKB(int size) {
-      return static_cast<std::int64_t>(size * KB);
+      return static_cast<std::int64_t>(size) * KB;
+}
+
+std::int64_t ChunkUtility::getDefaultChunkSize(std::uintmax_t fileSize) {
+      const auto size = static_cast<std::int64_t>(fileSize);
+      if (size >= getChunkSizeFromGB(1)) {
+            return getChunkSizeFromMB(10);
+      }
+      if (size >= getChunkSizeFromMB(100)) {
+            return getChunkSizeFromMB(5);
+      }
+      if (size >= getChunkSizeFromMB(50)) {
+            return getChunkSizeFromMB(2);
+      }
+      if (size >= getChunkSizeFromMB(10)) {
+            return getChunkSizeFromMB(1);
+      }
+      return size; // no chunking, upload the whole file
+}
+
+int ChunkUtility::getChunkCount(std::uintmax_t fileSize, std::int64_t chunkSize) {
+      if (chunkSize <= 0) {
+            return 1;
+      }
+      const auto size = static_cast<std::uintmax_t>(chunkSize);
+      const std::uintmax_t count = std::max<std::uintmax_t>(1, fileSize / size + (fileSize % size != 0));
+      if (count > INT_MAX) {
+            throw std::overflow_error(fmt::format("A file of {} bytes has too many chunks of {} bytes", fileSize,
+                                                  chunkSize));
+      }
+      return static_cast<int>(count);
 }
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include "chunk/utility/IoUringReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using TUS::Chunk::Utility::IoUringReader;
+
+struct IoUringReader::Request {
+    int fd;
+    std::uint64_t offset;
+    uint8_t *buffer;
+    size_t size;
+    size_t done = 0;
+    int error = 0;
+    bool finished = false;
+};
+
+#ifdef __linux__
+struct IoUringReader::Ring {
+    int fd = -1;
+    unsigned entries = 0;
+    unsigned unsubmitted = 0;
+    void *submissionRing = MAP_FAILED;
+    size_t submissionRingSize = 0;
+    void *completionRing = MAP_FAILED;
+    size_t completionRingSize = 0;
+    void *submissionEntries = MAP_FAILED;
+    size_t submissionEntriesSize = 0;
+    unsigned *submissionHead = nullptr;
+    unsigned *submissionTail = nullptr;
+    unsigned *submissionMask = nullptr;
+    unsigned *submissionArray = nullptr;
+    unsigned *completionHead = nullptr;
+    unsigned *completionTail = nullptr;
+    unsigned *completionMask = nullptr;
+    io_uring_cqe *completions = nullptr;
+
+    void open(unsigned queueDepth) {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+        if (fd < 0) {
+            throw std::runtime_error(std::string("io_uring is not available: ") + std::strerror(errno));
+        }
+        entries = params.sq_entries;
+        submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMapping) {
+            submissionRingSize = completionRingSize = std::max(submissionRingSize, completionRingSize);
+        }
+        submissionRing = mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                              IORING_OFF_SQ_RING);
+        completionRing = singleMapping
+                             ? submissionRing
+                             : mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    fd, IORING_OFF_CQ_RING);
+        submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+        submissionEntries = mmap(nullptr, submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 fd, IORING_OFF_SQES);
+        if (submissionRing == MAP_FAILED || completionRing == MAP_FAILED || submissionEntries == MAP_FAILED) {
+            throw std::runtime_error(std::string("Failed to map the io_uring: ") + std::strerror(errno));
+        }
+        auto *submission = static_cast<uint8_t *>(submissionRing);
+        submissionHead = reinterpret_cast<unsigned *>(submission + params.sq_off.head);
+        submissionTail = reinterpret_cast<unsigned *>(submission + params.sq_off.tail);
+        submissionMask = reinterpret_cast<unsigned *>(submission + params.sq_off.ring_mask);
+        submissionArray = reinterpret_cast<unsigned *>(submission + params.sq_off.array);
+        auto *completion = static_cast<uint8_t *>(completionRing);
+        completionHead = reinterpret_cast<unsigned *>(completion + params.cq_off.head);
+        completionTail = reinterpret_cast<unsigned *>(completion + params.cq_off.tail);
+        completionMask = reinterpret_cast<unsigned *>(completion + params.cq_off.ring_mask);
+        completions = reinterpret_cast<io_uring_cqe *>(completion + params.cq_off.cqes);
+
+        // IORING_OP_READ came with Linux 5.6, older kernels are served by pread
+        std::vector<uint8_t> probeStorage(sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op));
+        auto *probe = reinterpret_cast<io_uring_probe *>(probeStorage.data());
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0 ||
+            probe->last_op < IORING_OP_READ || (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) == 0) {
+            throw std::runtime_error("io_uring does not support reads on this kernel");
+        }
+    }
+
+    ~Ring() {
+        if (submissionEntries != MAP_FAILED) {
+            munmap(submissionEntries, submissionEntriesSize);
+        }
+        if (completionRing != MAP_FAILED && completionRing != submissionRing) {
+            munmap(completionRing, completionRingSize);
+        }
+        if (submissionRing != MAP_FAILED) {
+            munmap(submissionRing, submissionRingSize);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    /**
+     * @brief Queue the read of the rest of a request, false if the submission ring is full
+     */
+    bool push(Request &request) {
+        const unsigned tail = *submissionTail; // only written by this side
+        if (tail - std::atomic_ref(*submissionHead).load(std::memory_order_acquire) == entries) {
+            return false;
+        }
+        const unsigned index = tail & *submissionMask;
+        io_uring_sqe &entry = static_cast<io_uring_sqe *>(submissionEntries)[index];
+        std::memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_READ;
+        entry.fd = request.fd;
+        entry.off = request.offset + request.done;
+        entry.addr = reinterpret_cast<std::uint64_t>(request.buffer + request.done);
+        entry.len = static_cast<std::uint32_t>(std::min<size_t>(request.size - request.done, 1u << 30));
+        entry.user_data = reinterpret_cast<std::uint64_t>(&request);
+        submissionArray[index] = index;
+        std::atomic_ref(*submissionTail).store(tail + 1, std::memory_order_release);
+        ++unsubmitted;
+        return true;
+    }
+
+    /**
+     * @brief Submit the queued reads and, if wait is set, wait for a completion
+     * @return 0 or the negated error
+     */
+    int enter(bool wait) {
+        const long submitted = syscall(__NR_io_uring_enter, fd, unsubmitted, wait ? 1 : 0,
+                                       wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (submitted < 0) {
+            return -errno;
+        }
+        unsubmitted -= static_cast<unsigned>(submitted);
+        return 0;
+    }
+
+    template<typename Callback>
+    void reap(Callback &&callback) {
+        unsigned head = *completionHead; // only written by this side
+        const unsigned tail = std::atomic_ref(*completionTail).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe &completion = completions[head & *completionMask];
+            callback(reinterpret_cast<Request *>(completion.user_data), completion.res);
+        }
+        std::atomic_ref(*completionHead).store(head, std::memory_order_release);
+    }
+};
+#else
+struct IoUringReader::Ring {
+    void open(unsigned) {
+        throw std::runtime_error("io_uring is not available on this system");
+    }
+};
+#endif
+
+std::shared_ptr<IoUringReader> IoUringReader::getShared() {
+    static std::mutex mutex;
+    static std::weak_ptr<IoUringReader> shared;
+    static bool unavailable = false;
+    std::lock_guard lock(mutex);
+    if (unavailable) {
+        return nullptr;
+    }
+    auto reader = shared.lock();
+    if (reader != nullptr && reader->isBroken()) {
+        // the ring failed, the next chunkers read with pread
+        unavailable = true;
+        return nullptr;
+    }
+    if (reader == nullptr) {
+        try {
+            reader = std::make_shared<IoUringReader>();
+        } catch (const std::runtime_error &) {
+            unavailable = true;
+            return nullptr;
+        }
+        shared = reader;
+    }
+    return reader;
+}
+
+IoUringReader::IoUringReader(unsigned queueDepth) : m_ring(std::make_unique<Ring>()) {
+    m_ring->open(queueDepth);
+    m_thread = std::thread(&IoUringReader::run, this);
+}
+
+IoUringReader::~IoUringReader() {
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+size_t IoUringReader::read(int fd, std::uint64_t offset, void *buffer, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    Request request{fd, offset, static_cast<uint8_t *>(buffer), size};
+    std::unique_lock lock(m_mutex);
+    if (m_broken.load()) {
+        throw std::runtime_error("Failed to read the input file: the io_uring is broken");
+    }
+    m_pending.push_back(&request);
+    m_condition.notify_one();
+    m_completed.wait(lock, [&request] { return request.finished; });
+    if (request.error != 0) {
+        throw std::runtime_error(std::string("Failed to read the input file: ") + std::strerror(request.error));
+    }
+    return request.done;
+}
+
+bool IoUringReader::isBroken() const {
+    return m_broken.load();
+}
+
+void IoUringReader::run() {
+#ifdef __linux__
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this] { return m_stopping || !m_pending.empty() || !m_inFlight.empty(); });
+        if (m_pending.empty() && m_inFlight.empty()) {
+            return; // stopping, nothing left to read
+        }
+        // everything queued since the last round goes with one system call
+        while (!m_pending.empty() && m_inFlight.size() < m_ring->entries && m_ring->push(*m_pending.front())) {
+            m_inFlight.insert(m_pending.front());
+            m_pending.pop_front();
+        }
+        lock.unlock();
+        const int error = m_ring->enter(!m_inFlight.empty());
+        lock.lock();
+        m_ring->reap([this](Request *request, int result) { complete(request, result); });
+        if (error != 0 && error != -EINTR && error != -EAGAIN && error != -EBUSY) {
+            // the ring itself is broken, no completion is coming for the reads left
+            fail(error);
+            return;
+        }
+        m_completed.notify_all();
+    }
+#endif
+}
+
+void IoUringReader::complete(Request *request, int result) {
+    m_inFlight.erase(request);
+    if (result == -EINTR || result == -EAGAIN) {
+        m_pending.push_front(request);
+    } else if (result < 0) {
+        request->error = -result;
+        request->finished = true;
+    } else {
+        request->done += static_cast<size_t>(result);
+        if (result == 0 || request->done == request->size) {
+            request->finished = true; // complete or at the end of the file
+        } else {
+            m_pending.push_front(request);
+        }
+    }
+}
+
+void IoUringReader::fail(int error) {
+    m_broken.store(true);
+    // the reads still in the submission ring and the ones waiting for it fail alike
+    for (Request *request: m_inFlight) {
+        request->error = -error;
+        request->finished = true;
+    }
+    for (Request *request: m_pending) {
+        request->error = -error;
+        request->finished = true;
+    }
+    m_inFlight.clear();
+    m_pending.clear();
+    m_completed.notify_all();
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include "chunk/utility/MappedFile.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using TUS::Chunk::Utility::MappedFile;
+
+#ifndef _WIN32
+namespace {
+    std::uint64_t pageSize() {
+        static const auto size = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+        return size;
+    }
+}
+#endif
+
+MappedFile::MappedFile(std::filesystem::path filePath) : m_file(std::move(filePath)) {
+    if (m_file.getSize() == 0) {
+        return; // an empty file cannot be mapped, there is nothing to read
+    }
+#ifdef _WIN32
+    m_mapping = CreateFileMappingW(m_file.getNativeHandle(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr) {
+        m_data = static_cast<uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (m_data == nullptr) {
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+        }
+        throw std::runtime_error("Failed to map the input file: " + m_file.getPath().string());
+    }
+#else
+    void *data = mmap(nullptr, m_file.getSize(), PROT_READ, MAP_SHARED, m_file.getNativeHandle(), 0);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Failed to map the input file: " + m_file.getPath().string() + ": " +
+                                 std::strerror(errno));
+    }
+    m_data = static_cast<uint8_t *>(data);
+    madvise(m_data, m_file.getSize(), MADV_SEQUENTIAL);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (m_data == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+    CloseHandle(m_mapping);
+#else
+    munmap(m_data, m_file.getSize());
+#endif
+}
+
+const uint8_t *MappedFile::getData() const {
+    return m_data;
+}
+
+std::uint64_t MappedFile::getSize() const {
+    return m_file.getSize();
+}
+
+bool MappedFile::hasChanged() const {
+    return m_file.hasChanged();
+}
+
+void MappedFile::willNeed(std::uint64_t offset, size_t size) const {
+#ifndef _WIN32
+    if (m_data == nullptr || size == 0) {
+        return;
+    }
+    const std::uint64_t start = offset / pageSize() * pageSize();
+    madvise(m_data + start, offset + size - start, MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::discard(std::uint64_t offset, size_t size) const {
+#ifndef _WIN32
+    if (m_data == nullptr) {
+        return;
+    }
+    // the pages at the edges can hold bytes of the chunks around, only the ones inside are dropped
+    const std::uint64_t page = pageSize();
+    const std::uint64_t start = (offset + page - 1) / page * page;
+    const std::uint64_t end = offset + size == getSize() ? offset + size : (offset + size) / page * page;
+    if (end <= start) {
+        return;
+    }
+    madvise(m_data + start, end - start, MADV_DONTNEED);
+#ifdef POSIX_FADV_DONTNEED
+    posix_fadvise(m_file.getNativeHandle(), static_cast<off_t>(start), static_cast<off_t>(end - start),
+                  POSIX_FADV_DONTNEED);
+#endif
+#endif
+}
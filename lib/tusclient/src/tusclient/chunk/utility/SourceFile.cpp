@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include "chunk/utility/SourceFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using TUS::Chunk::Utility::SourceFile;
+
+SourceFile::SourceFile(std::filesystem::path filePath, bool directIo) : m_filePath(std::move(filePath)) {
+#ifdef _WIN32
+    const DWORD flags = directIo ? FILE_FLAG_NO_BUFFERING : FILE_ATTRIBUTE_NORMAL;
+    HANDLE handle = CreateFileW(m_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, flags, nullptr);
+    if (handle == INVALID_HANDLE_VALUE && directIo) {
+        handle = CreateFileW(m_filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    } else {
+        m_direct = directIo;
+    }
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open input file: " + m_filePath.string());
+    }
+    m_handle = handle;
+#else
+#ifdef O_DIRECT
+    if (directIo) {
+        // file systems without direct I/O, e.g. tmpfs, refuse the flag, the file is read through the page cache
+        m_handle = ::open(m_filePath.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        m_direct = m_handle >= 0;
+    }
+#endif
+    if (m_handle < 0) {
+        m_handle = ::open(m_filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (m_handle < 0) {
+        throw std::runtime_error("Failed to open input file: " + m_filePath.string() + ": " + std::strerror(errno));
+    }
+#endif
+    std::error_code error;
+    m_size = std::filesystem::file_size(m_filePath, error);
+    if (!error) {
+        m_lastWriteTime = std::filesystem::last_write_time(m_filePath, error);
+    }
+    if (error) {
+#ifdef _WIN32
+        CloseHandle(m_handle);
+#else
+        ::close(m_handle);
+#endif
+        throw std::runtime_error("Failed to read the size of the input file: " + m_filePath.string());
+    }
+}
+
+SourceFile::~SourceFile() {
+#ifdef _WIN32
+    CloseHandle(m_handle);
+#else
+    ::close(m_handle);
+#endif
+}
+
+size_t SourceFile::readAt(std::uint64_t offset, void *buffer, size_t size) const {
+    auto *destination = static_cast<char *>(buffer);
+    size_t total = 0;
+    while (total < size) {
+#ifdef _WIN32
+        OVERLAPPED overlapped{};
+        const std::uint64_t position = offset + total;
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        DWORD bytesRead = 0;
+        const auto request = static_cast<DWORD>(std::min<size_t>(size - total, 1u << 30));
+        if (!ReadFile(m_handle, destination + total, request, &bytesRead, &overlapped)) {
+            if (GetLastError() == ERROR_HANDLE_EOF) {
+                break;
+            }
+            throw std::runtime_error("Failed to read the input file: " + m_filePath.string());
+        }
+#else
+        const ssize_t bytesRead = ::pread(m_handle, destination + total, size - total,
+                                          static_cast<off_t>(offset + total));
+        if (bytesRead < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to read the input file: " + m_filePath.string() + ": " +
+                                     std::strerror(errno));
+        }
+#endif
+        if (bytesRead == 0) {
+            break; // end of the file
+        }
+        total += static_cast<size_t>(bytesRead);
+    }
+    return total;
+}
+
+bool SourceFile::hasChanged() const {
+    std::error_code error;
+    const auto size = std::filesystem::file_size(m_filePath, error);
+    if (error || size != m_size) {
+        return true;
+    }
+    const auto lastWriteTime = std::filesystem::last_write_time(m_filePath, error);
+    return error || lastWriteTime != m_lastWriteTime;
+}
+
+std::uint64_t SourceFile::getSize() const {
+    return m_size;
+}
+
+const std::filesystem::path &SourceFile::getPath() const {
+    return m_filePath;
+}
+
+bool SourceFile::isDirect() const {
+    return m_direct;
+}
+
+SourceFile::NativeHandle SourceFile::getNativeHandle() const {
+    return m_handle;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include "http/CurlHandlePool.h"
+
+using TUS::Http::CurlHandlePool;
+
+CurlHandlePool::CurlHandlePool(size_t maxIdleHandles) : m_maxIdleHandles(maxIdleHandles) {
+}
+
+CurlHandlePool::~CurlHandlePool() {
+    clear();
+}
+
+CURL *CurlHandlePool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idleHandles.empty()) {
+            CURL *curl = m_idleHandles.back();
+            m_idleHandles.pop_back();
+            return curl;
+        }
+    }
+    return curl_easy_init();
+}
+
+void CurlHandlePool::release(CURL *curl) {
+    if (curl == nullptr) {
+        return;
+    }
+    // reset the options but keep the live connections, DNS cache and TLS session cache
+    curl_easy_reset(curl);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_idleHandles.size() < m_maxIdleHandles) {
+            m_idleHandles.push_back(curl);
+            return;
+        }
+    }
+    curl_easy_cleanup(curl);
+}
+
+void CurlHandlePool::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (CURL *curl: m_idleHandles) {
+        curl_easy_cleanup(curl);
+    }
+    m_idleHandles.clear();
+}
+
+size_t CurlHandlePool::getIdleHandles() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_idleHandles.size();
+}
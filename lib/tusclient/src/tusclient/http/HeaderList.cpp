@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <algorithm>
+#include "http/HeaderList.h"
+
+using TUS::Http::HeaderList;
+
+namespace {
+    bool equalsIgnoreCase(std::string_view left, std::string_view right) {
+        return std::ranges::equal(left, right, [](char a, char b) {
+            const auto toLower = [](char c) {
+                return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+            };
+            return toLower(a) == toLower(b);
+        });
+    }
+}
+
+HeaderList::HeaderList(std::initializer_list<Header> headers) {
+    m_headers.reserve(std::max(INITIAL_CAPACITY, headers.size()));
+    for (const auto &[name, value]: headers) {
+        set(name, value);
+    }
+}
+
+HeaderList::HeaderList(const std::map<std::string, std::string> &headers) {
+    m_headers.reserve(std::max(INITIAL_CAPACITY, headers.size()));
+    for (const auto &[name, value]: headers) {
+        set(name, value);
+    }
+}
+
+void HeaderList::set(std::string_view name, std::string value) {
+    const auto it = std::ranges::find_if(m_headers, [name](const Header &header) {
+        return equalsIgnoreCase(header.first, name);
+    });
+    if (it != m_headers.end()) {
+        it->second = std::move(value);
+        return;
+    }
+    if (m_headers.capacity() == 0) {
+        m_headers.reserve(INITIAL_CAPACITY);
+    }
+    m_headers.emplace_back(std::string(name), std::move(value));
+}
+
+std::string_view HeaderList::get(std::string_view name) const {
+    const Header *header = find(name);
+    return header != nullptr ? std::string_view(header->second) : std::string_view();
+}
+
+bool HeaderList::contains(std::string_view name) const {
+    return find(name) != nullptr;
+}
+
+size_t HeaderList::size() const {
+    return m_headers.size();
+}
+
+bool HeaderList::empty() const {
+    return m_headers.empty();
+}
+
+HeaderList::const_iterator HeaderList::begin() const {
+    return m_headers.begin();
+}
+
+HeaderList::const_iterator HeaderList::end() const {
+    return m_headers.end();
+}
+
+const HeaderList::Header *HeaderList::find(std::string_view name) const {
+    const auto it = std::ranges::find_if(m_headers, [name](const Header &header) {
+        return equalsIgnoreCase(header.first, name);
+    });
+    return it != m_headers.end() ? &*it : nullptr;
+}
@@ -4,35 +4,131 @@
  * See the LICENSE file in the project root for more information.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include "http/HttpClient.h"
 #include "http/Request.h"
 
 using TUS::Http::HttpClient;
 using TUS::Http::HttpMethod;
+using TUS::Http::HttpVersion;
 using TUS::Http::IHttpClient;
 using TUS::Http::Request;
+using TUS::Http::RequestBody;
+using TUS::Http::RequestTask;
+using TUS::Http::Response;
+using TUS::Http::TransportContext;
 
-HttpClient::HttpClient()
-= default;
+HttpClient::HttpClient() : HttpClient(nullptr) {
+}
+
+HttpClient::HttpClient(std::unique_ptr<TUS::Logging::ILogger> logger) : HttpClient(std::move(logger), nullptr) {
+}
 
-HttpClient::HttpClient(std::unique_ptr<TUS::Logging::ILogger> logger) : m_logger(std::move(logger)) {
+HttpClient::HttpClient(std::unique_ptr<TUS::Logging::ILogger> logger, std::shared_ptr<TransportContext> context)
+    : m_logger(std::move(logger)) {
+    m_context = context != nullptr ? std::move(context) : std::make_shared<TransportContext>(m_logger);
 }
 
-HttpClient::~HttpClient()
-= default;
+HttpClient::~HttpClient() {
+    m_context->detach(this);
+}
 
-size_t HttpClient::writeDataCallback(void *ptr, size_t size, size_t nmemb, std::string *data) {
+size_t HttpClient::writeDataCallback(void *ptr, size_t size, size_t nmemb, Response *data) {
     if (ptr == nullptr || size == 0 || nmemb == 0) {
         // Potrebbe indicare la fine della trasmissione
         return 0;
     }
-    data->append(reinterpret_cast<char *>(ptr), size * nmemb);
+    data->appendBody(static_cast<const char *>(ptr), size * nmemb);
     return size * nmemb;
 }
 
-int HttpClient::progressCallback(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow) {
+size_t HttpClient::headerCallback(char *buffer, size_t size, size_t nitems, Response *response) {
+    response->parseHeaderLine(std::string_view(buffer, size * nitems));
+    return size * nitems;
+}
+
+size_t HttpClient::readBodyCallback(char *buffer, size_t size, size_t nitems, void *userdata) {
+    auto *requestTask = static_cast<RequestTask *>(userdata);
+    const RequestBody &body = requestTask->getBodySource();
+    if (requestTask->aborted.load(std::memory_order_relaxed)) {
+        return CURL_READFUNC_ABORT;
+    }
+    if (requestTask->bodyPosition >= body.length) {
+        return 0;
+    }
+    size_t count = std::min<uint64_t>(size * nitems, body.length - requestTask->bodyPosition);
+    const std::shared_ptr<TUS::Http::RateLimiter> &rateLimiter = requestTask->getRateLimiter();
+    if (rateLimiter != nullptr) {
+        const size_t granted = rateLimiter->acquire(count);
+        if (granted == 0) {
+            // pause the transfer, not the thread driving the other ones
+            requestTask->readPaused = true;
+            requestTask->resumeAt = std::chrono::steady_clock::now() + rateLimiter->getDelay(count);
+            return CURL_READFUNC_PAUSE;
+        }
+        count = granted;
+    }
+    if (body.source == nullptr) {
+        std::memcpy(buffer, body.data + body.offset + requestTask->bodyPosition, count);
+        requestTask->bodyPosition += count;
+        return count;
+    }
+    try {
+        const size_t read = body.source->read(body.offset + requestTask->bodyPosition, buffer, count);
+        if (read == TUS::Http::IBodySource::PENDING) {
+            if (rateLimiter != nullptr) {
+                rateLimiter->release(count);
+            }
+            requestTask->readPaused = true;
+            requestTask->resumeAt = std::chrono::steady_clock::now() + PENDING_BODY_DELAY;
+            return CURL_READFUNC_PAUSE;
+        }
+        if (rateLimiter != nullptr) {
+            rateLimiter->release(count - read); // only the bytes passed to curl are counted
+        }
+        if (read == 0) {
+            // the source is shorter than the declared length
+            return CURL_READFUNC_ABORT;
+        }
+        requestTask->bodyPosition += read;
+        return read;
+    } catch (const std::exception &) {
+        if (rateLimiter != nullptr) {
+            rateLimiter->release(count);
+        }
+        return CURL_READFUNC_ABORT;
+    }
+}
+
+int HttpClient::seekBodyCallback(void *userdata, curl_off_t offset, int origin) {
+    auto *requestTask = static_cast<RequestTask *>(userdata);
+    if (origin != SEEK_SET || offset < 0 || static_cast<uint64_t>(offset) > requestTask->getBodySource().length) {
+        return CURL_SEEKFUNC_FAIL;
+    }
+    requestTask->bodyPosition = static_cast<uint64_t>(offset);
+    return CURL_SEEKFUNC_OK;
+}
+
+int HttpClient::progressCallback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal,
+                                 curl_off_t ulnow) {
+    auto *requestTask = static_cast<RequestTask *>(clientp);
+    if (requestTask->aborted.load(std::memory_order_relaxed)) {
+        // stop the transfer now, the driving thread removes it from the multi handle
+        return 1;
+    }
+    const std::shared_ptr<TUS::Http::Progress> &progress = requestTask->getProgress();
+    if (progress == nullptr) {
+        return 0;
+    }
+    const auto uploaded = static_cast<uint64_t>(ulnow);
+    // ulnow goes back to 0 when curl rewinds the body to send it again
+    progress->addUploadedBytes(uploaded > requestTask->reportedUpload ? uploaded - requestTask->reportedUpload : 0);
+    requestTask->reportedUpload = uploaded;
+    progress->update(uploaded, static_cast<uint64_t>(ultotal), static_cast<uint64_t>(dlnow),
+                     static_cast<uint64_t>(dltotal));
     return 0;
 }
 
@@ -58,20 +154,25 @@ std::string HttpClient::convertHttpMethodToString(HttpMethod method) {
 }
 
 int TUS::Http::HttpClient::getHttpReturnCode(const std::string &header) {
-    size_t pos = header.find("HTTP/1.1 ");
-    if (pos != std::string::npos) {
-        std::istringstream iss(header.substr(pos + 9));
-        int status_code;
-        iss >> status_code;
-        return status_code;
+    int statusCode = -1;
+    std::string_view headers = header;
+    while (!headers.empty()) {
+        // the last status line is the one of the final response
+        if (const int lineStatusCode = Response::parseStatusLine(headers); lineStatusCode >= 0) {
+            statusCode = lineStatusCode;
+        }
+        const size_t lineEnd = headers.find('\n');
+        if (lineEnd == std::string_view::npos) {
+            break;
+        }
+        headers.remove_prefix(lineEnd + 1);
     }
-    return -1;
+    return statusCode;
 }
 
-void HttpClient::setupCURLRequest(CURL *curl, HttpMethod method,
-                                  const Request &request) const {
+curl_slist *HttpClient::setupCURLRequest(CURL *curl, HttpMethod method,
+                                         const Request &request) const {
     string methodStr = convertHttpMethodToString(method);
-    Progress progress{};
     if (request.getUrl().find("https://") == 0) {
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
@@ -85,11 +186,39 @@ void HttpClient::setupCURLRequest(CURL *curl, HttpMethod method,
     }
     curl_easy_setopt(curl, CURLOPT_URL, request.getUrl().c_str());
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, methodStr.c_str());
-    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &progress);
-    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progressCallback);
-    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
     curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
     // timeout in seconds for the connection, if the connection is not established in 10 seconds the request will be aborted
+    // keep the idle connections open between the chunks of an upload
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 60L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 30L);
+    switch (m_httpVersion.load()) {
+        case HttpVersion::_HTTP_1_0:
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_0);
+            break;
+        case HttpVersion::_HTTP_1_1:
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+            break;
+        case HttpVersion::_HTTP_2_PRIOR_KNOWLEDGE:
+            // without TLS there is nothing to fall back from, h2c needs a libcurl built with HTTP/2
+            if (curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE) != CURLE_OK) {
+                throw std::runtime_error("HTTP/2 with prior knowledge requested, but libcurl has no HTTP/2 support");
+            }
+            curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+            break;
+        default:
+            if (curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS) != CURLE_OK) {
+                if (m_logger != nullptr && !m_http2Unsupported.exchange(true)) {
+                    m_logger->warning("libcurl has no HTTP/2 support, the requests are sent with HTTP/1.1");
+                }
+                break;
+            }
+            if (request.getUrl().find("https://") == 0) {
+                // wait for the connection being negotiated instead of opening a new one, it can be multiplexed
+                curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+            }
+            break;
+    }
     struct curl_slist *headers = nullptr;
     for (auto const &header: request.getHeaders()) {
         headers = curl_slist_append(headers, (header.first + ": " +
@@ -102,37 +231,62 @@ void HttpClient::setupCURLRequest(CURL *curl, HttpMethod method,
                                     .c_str());
     }
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    return headers;
 }
 
-IHttpClient *HttpClient::sendRequest(HttpMethod method, const Request &request) {
-    if (CURL *curl = curl_easy_init(); curl != nullptr) {
-        setupCURLRequest(curl, method, request);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeDataCallback);
-        switch (method) {
-            case HttpMethod::_HEAD:
-                curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
-                break;
-            case HttpMethod::_POST:
-            case HttpMethod::_PUT:
-            case HttpMethod::_PATCH: {
-                if (request.getBody().empty()) {
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "");
-                } else {
-                    m_buffer = std::make_shared<std::string>(request.getBody());
-                    // this fix the issue of the data buffer that is deallocated before the request is performed
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, m_buffer->c_str());
-                    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, request.getBody().size()); // set the size of the data
-                }
-                break;
+IHttpClient *HttpClient::sendRequest(HttpMethod method, Request &&request) {
+    CURL *curl = m_context->acquireHandle();
+    if (curl == nullptr) {
+        throw std::runtime_error("CURL initialization failed");
+    }
+    // the task takes the request over, the body and the callbacks are not copied
+    auto requestTask = std::make_unique<RequestTask>(std::move(request), curl);
+    requestTask->client = this;
+    try {
+        requestTask->headers = setupCURLRequest(curl, method, *requestTask);
+    } catch (...) {
+        m_context->releaseHandle(curl);
+        throw;
+    }
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeDataCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &requestTask->response);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &requestTask->response);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, progressCallback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, requestTask.get());
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    switch (method) {
+        case HttpMethod::_HEAD:
+            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+            break;
+        case HttpMethod::_POST:
+        case HttpMethod::_PUT:
+        case HttpMethod::_PATCH: {
+            if (requestTask->hasBodySource()) {
+                // the body is read from the source while it is sent, without copying it first
+                curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+                curl_easy_setopt(curl, CURLOPT_READFUNCTION, readBodyCallback);
+                curl_easy_setopt(curl, CURLOPT_READDATA, requestTask.get());
+                curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, seekBodyCallback);
+                curl_easy_setopt(curl, CURLOPT_SEEKDATA, requestTask.get());
+                curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE,
+                                 static_cast<curl_off_t>(requestTask->getBodySource().length));
+                curl_easy_setopt(curl, CURLOPT_UPLOAD_BUFFERSIZE, UPLOAD_BUFFER_SIZE);
+                // do not wait for "100 Continue" before sending the body
+                requestTask->headers = curl_slist_append(requestTask->headers, "Expect:");
+                curl_easy_setopt(curl, CURLOPT_HTTPHEADER, requestTask->headers);
+            } else {
+                // the body is owned by the task, it lives until the transfer has completed
+                const std::string_view body = requestTask->getBody();
+                curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
+                curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data());
             }
-            default:
-                break;
+            break;
         }
-        RequestTask requestTask(request, curl);
-        m_requestsQueue.push(requestTask);
-    } else {
-        throw std::runtime_error("CURL initialization failed");
+        default:
+            break;
     }
+    m_context->enqueue(std::move(requestTask));
     return (IHttpClient *) this;
 }
 
@@ -140,132 +294,143 @@ IHttpClient *HttpClient::get(Request request) {
     if (request.getMethod() != HttpMethod::_GET) {
         throw std::runtime_error("Method not allowed");
     }
-    return sendRequest(HttpMethod::_GET, request);
+    return sendRequest(HttpMethod::_GET, std::move(request));
 }
 
 IHttpClient *HttpClient::post(Request request) {
     if (request.getMethod() != HttpMethod::_POST) {
         throw std::runtime_error("Method not allowed");
     }
-    return sendRequest(HttpMethod::_POST, request);
+    return sendRequest(HttpMethod::_POST, std::move(request));
 }
 
 IHttpClient *HttpClient::put(Request request) {
     if (request.getMethod() != HttpMethod::_PUT) {
         throw std::runtime_error("Method not allowed");
     }
-    return sendRequest(HttpMethod::_PUT, request);
+    return sendRequest(HttpMethod::_PUT, std::move(request));
 }
 
 IHttpClient *HttpClient::patch(Request request) {
     if (request.getMethod() != HttpMethod::_PATCH) {
         throw std::runtime_error("Method not allowed");
     }
-    return sendRequest(HttpMethod::_PATCH, request);
+    return sendRequest(HttpMethod::_PATCH, std::move(request));
 }
 
 IHttpClient *HttpClient::del(Request request) {
     if (request.getMethod() != HttpMethod::_DELETE) {
         throw std::runtime_error("Method not allowed");
     }
-    return sendRequest(HttpMethod::_DELETE, request);
+    return sendRequest(HttpMethod::_DELETE, std::move(request));
 }
 
 IHttpClient *HttpClient::head(Request request) {
     if (request.getMethod() != HttpMethod::_HEAD) {
         throw std::runtime_error("Method not allowed");
     }
-    return sendRequest(HttpMethod::_HEAD, request);
+    return sendRequest(HttpMethod::_HEAD, std::move(request));
 }
 
 IHttpClient *HttpClient::options(Request request) {
     if (request.getMethod() != HttpMethod::_OPTIONS) {
         throw std::runtime_error("Method not allowed");
     }
-    return sendRequest(HttpMethod::_OPTIONS, request);
+    return sendRequest(HttpMethod::_OPTIONS, std::move(request));
 }
 
-IHttpClient *HttpClient::abortAll() { {
-        // Lock the mutex for queue operations
-        std::lock_guard<std::mutex> lock(m_queueMutex);
+IHttpClient *HttpClient::abortAll() {
+    m_context->abort(this, [](const RequestTask &) {
+        return true;
+    });
+    return (IHttpClient *) this;
+}
 
-        while (!m_requestsQueue.empty()) {
-            curl_easy_cleanup(m_requestsQueue.front().curl);
-            m_requestsQueue.pop();
+IHttpClient *HttpClient::abort(const std::string &tag) {
+    m_context->abort(this, [&tag](const RequestTask &requestTask) {
+        return requestTask.getTag() == tag;
+    });
+    return (IHttpClient *) this;
+}
+
+void HttpClient::dispatch(std::unique_ptr<RequestTask> task) {
+    // release the handle first, a callback is allowed to throw
+    m_context->releaseHandle(task->curl);
+    task->curl = nullptr;
+    if (task->result == CURLE_OK) {
+        m_negotiatedHttpVersion = toHttpVersion(task->httpVersion);
+    }
+
+    if (task->result != CURLE_OK) {
+        // Log the error and invoke the error callback
+        if (m_logger != nullptr) {
+            m_logger->error("CURL error: " + std::string(curl_easy_strerror(task->result)));
         }
+        task->getOnErrorCallback()(task->response);
+    } else if (task->response.getStatusCode() >= 400) {
+        std::cerr << "Http Error: " << task->response.getStatusCode() << std::endl;
+        task->getOnErrorCallback()(task->response);
+    } else {
+        // Success: invoke the success callback
+        task->getOnSuccessCallback()(task->response);
     }
-    m_abort = true;
-    return (IHttpClient *) this;
 }
 
 IHttpClient *HttpClient::execute() {
-    while (true) {
-        CURL *curl = nullptr; {
-            // Lock the mutex for queue operations
-            std::lock_guard<std::mutex> lock(m_queueMutex);
-
-            if (m_abort) {
-                // If abort is requested, clean up all remaining requests
-                while (!m_requestsQueue.empty()) {
-                    curl = m_requestsQueue.front().curl;
-                    curl_easy_cleanup(curl);
-                    m_requestsQueue.pop();
-                }
-                m_abort = false; // Reset the abort flag after cleaning up
-                return this;
-            }
+    // Hand the finished transfers back to the thread that queued them
+    while (std::unique_ptr<RequestTask> requestTask = m_context->nextCompleted(this)) {
+        dispatch(std::move(requestTask));
+    }
+    return this;
+}
 
-            // If the queue is empty, break the loop
-            if (m_requestsQueue.empty()) {
-                break;
-            }
+void HttpClient::setMaxConcurrentTransfers(size_t maxTransfers) {
+    m_context->setMaxConcurrentTransfers(maxTransfers);
+}
 
-            // Get the next request's curl handle from the queue
-            curl = m_requestsQueue.front().curl;
-        }
+size_t HttpClient::getMaxConcurrentTransfers() const {
+    return m_context->getMaxConcurrentTransfers();
+}
 
-        // Buffers for the response and headers
-        std::string responseHeader;
-        std::string buffer;
+TUS::Http::ConnectionStats HttpClient::getConnectionStats() const {
+    return m_context->getConnectionStats();
+}
 
-        // Set CURL options for writing the response and headers
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &responseHeader);
+std::shared_ptr<TransportContext> HttpClient::getTransportContext() const {
+    return m_context;
+}
 
-        // Lock the mutex again before accessing the queue
-        {
-            std::lock_guard<std::mutex> lock(m_queueMutex);
-            if (curl == nullptr) {
-                continue;
-            }
-            // Perform the CURL request
-            CURLcode res = curl_easy_perform(curl);
+void HttpClient::setHttpVersion(HttpVersion version) {
+    m_httpVersion = version == HttpVersion::_NONE ? HttpVersion::_HTTP_2 : version;
+}
 
-            if (res != CURLE_OK) {
-                // Log the error and invoke the error callback
-                if (m_logger != nullptr) {
-                    m_logger->error("CURL error: " + std::string(curl_easy_strerror(res)));
-                }
+HttpVersion HttpClient::getHttpVersion() const {
+    return m_httpVersion;
+}
 
-                m_requestsQueue.front().getOnErrorCallback()(responseHeader, buffer);
-            } else {
-                int returnCode = getHttpReturnCode(responseHeader);
-                if (returnCode >= 400) {
-                    std::cerr << "Http Error: " << returnCode << std::endl;
-                    m_requestsQueue.front().getOnErrorCallback()(responseHeader, buffer);
-                } else {
-                    // Success: invoke the success callback
-                    m_requestsQueue.front().getOnSuccessCallback()(responseHeader, buffer);
-                }
-            }
+HttpVersion HttpClient::getNegotiatedHttpVersion() const {
+    return m_negotiatedHttpVersion;
+}
 
-            // Clean up the CURL handle after completing the request
-            curl_easy_cleanup(curl);
-            m_requestsQueue.pop(); // Safely remove the completed request
-        }
-    }
+void HttpClient::setMaxConcurrentStreams(size_t maxStreams) {
+    m_context->setMaxConcurrentStreams(maxStreams);
+}
 
-    return this;
+size_t HttpClient::getMaxConcurrentStreams() const {
+    return m_context->getMaxConcurrentStreams();
+}
+
+HttpVersion HttpClient::toHttpVersion(long curlVersion) {
+    switch (curlVersion) {
+        case CURL_HTTP_VERSION_1_0:
+            return HttpVersion::_HTTP_1_0;
+        case CURL_HTTP_VERSION_1_1:
+            return HttpVersion::_HTTP_1_1;
+        case CURL_HTTP_VERSION_2_0:
+            return HttpVersion::_HTTP_2;
+        default:
+            return HttpVersion::_NONE;
+    }
 }
 
 void TUS::Http::HttpClient::setAuthorization(const std::string &token) {
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <chrono>
+#include "http/Progress.h"
+
+using TUS::Http::Progress;
+
+namespace {
+    int64_t nowNanoseconds() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+void Progress::update(uint64_t uploadNow, uint64_t uploadTotal, uint64_t downloadNow, uint64_t downloadTotal) {
+    m_uploadNow.store(uploadNow, std::memory_order_relaxed);
+    m_uploadTotal.store(uploadTotal, std::memory_order_relaxed);
+    m_downloadNow.store(downloadNow, std::memory_order_relaxed);
+    m_downloadTotal.store(downloadTotal, std::memory_order_relaxed);
+}
+
+void Progress::addUploadedBytes(uint64_t bytes) {
+    const uint64_t uploaded = m_totalUploaded.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    const int64_t now = nowNanoseconds();
+    int64_t sampleTime = m_sampleTime.load(std::memory_order_relaxed);
+    if (sampleTime == 0) {
+        // first call, the speed is measured from here
+        if (m_sampleTime.compare_exchange_strong(sampleTime, now, std::memory_order_relaxed)) {
+            m_sampleBytes.store(uploaded, std::memory_order_relaxed);
+        }
+        return;
+    }
+    const int64_t elapsed = now - sampleTime;
+    if (elapsed < SPEED_SAMPLE_INTERVAL_MS * 1000000) {
+        return;
+    }
+    // a single caller takes the sample when the callbacks of several transfers race
+    if (!m_sampleTime.compare_exchange_strong(sampleTime, now, std::memory_order_relaxed)) {
+        return;
+    }
+    const uint64_t previous = m_sampleBytes.exchange(uploaded, std::memory_order_relaxed);
+    const uint64_t sent = uploaded > previous ? uploaded - previous : 0;
+    const double rate = static_cast<double>(sent) * 1e9 / static_cast<double>(elapsed);
+    const double speed = m_uploadSpeed.load(std::memory_order_relaxed);
+    m_uploadSpeed.store(speed == 0 ? rate : SPEED_SMOOTHING * rate + (1 - SPEED_SMOOTHING) * speed,
+                        std::memory_order_relaxed);
+}
+
+void Progress::reset() {
+    update(0, 0, 0, 0);
+}
+
+uint64_t Progress::getUploadedBytes() const {
+    return m_uploadNow.load(std::memory_order_relaxed);
+}
+
+uint64_t Progress::getUploadTotal() const {
+    return m_uploadTotal.load(std::memory_order_relaxed);
+}
+
+uint64_t Progress::getDownloadedBytes() const {
+    return m_downloadNow.load(std::memory_order_relaxed);
+}
+
+uint64_t Progress::getDownloadTotal() const {
+    return m_downloadTotal.load(std::memory_order_relaxed);
+}
+
+uint64_t Progress::getTotalUploadedBytes() const {
+    return m_totalUploaded.load(std::memory_order_relaxed);
+}
+
+double Progress::getUploadSpeed() const {
+    return m_uploadSpeed.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include "http/RateLimiter.h"
+
+using TUS::Http::RateLimiter;
+
+namespace {
+    /**
+     * @brief The tokens of a bucket once the given time has passed, they do not exceed its burst
+     */
+    double tokensAfter(double tokens, uint64_t rate, uint64_t burst, std::chrono::steady_clock::duration elapsed) {
+        const double earned = std::chrono::duration<double>(elapsed).count() * static_cast<double>(rate);
+        return std::min(static_cast<double>(burst), tokens + earned);
+    }
+}
+
+RateLimiter::RateLimiter(uint64_t bytesPerSecond, std::shared_ptr<RateLimiter> parent)
+    : m_rate(UNLIMITED), m_lastRefill(std::chrono::steady_clock::now()), m_parent(std::move(parent)) {
+    setRate(bytesPerSecond);
+}
+
+void RateLimiter::setRate(uint64_t bytesPerSecond, uint64_t burst) {
+    std::lock_guard lock(m_mutex);
+    const bool wasLimited = m_rate != UNLIMITED;
+    // the tokens earned until now are counted at the previous rate
+    refill(std::chrono::steady_clock::now());
+    m_rate = bytesPerSecond;
+    m_limited.store(m_rate != UNLIMITED, std::memory_order_release);
+    if (m_rate == UNLIMITED) {
+        m_burst = 0;
+        m_tokens = 0;
+        return;
+    }
+    const auto defaultBurst = static_cast<uint64_t>(static_cast<double>(m_rate) *
+                                                    std::chrono::duration<double>(DEFAULT_BURST_DURATION).count());
+    m_burst = burst != 0 ? burst : std::max<uint64_t>(defaultBurst, MIN_GRANT);
+    // a new limit starts with a full bucket
+    m_tokens = wasLimited ? std::min(m_tokens, static_cast<double>(m_burst)) : static_cast<double>(m_burst);
+}
+
+uint64_t RateLimiter::getRate() const {
+    std::lock_guard lock(m_mutex);
+    return m_rate;
+}
+
+uint64_t RateLimiter::getBurst() const {
+    std::lock_guard lock(m_mutex);
+    return m_burst;
+}
+
+const std::shared_ptr<RateLimiter> &RateLimiter::getParent() const {
+    return m_parent;
+}
+
+size_t RateLimiter::acquire(size_t bytes) {
+    if (bytes == 0) {
+        return 0;
+    }
+    if (!isLimited()) {
+        // nothing to take from the buckets, the bytes are only counted
+        for (RateLimiter *level = this; level != nullptr; level = level->m_parent.get()) {
+            level->m_acquired.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        return bytes;
+    }
+    return acquireLocked(bytes, std::min(bytes, MIN_GRANT), std::chrono::steady_clock::now());
+}
+
+size_t RateLimiter::acquireLocked(size_t granted, size_t minimum, std::chrono::steady_clock::time_point now) {
+    std::lock_guard lock(m_mutex);
+    refill(now);
+    if (m_rate != UNLIMITED) {
+        granted = std::min<size_t>(granted, static_cast<size_t>(std::floor(m_tokens)));
+        minimum = std::min<size_t>(minimum, m_burst);
+    }
+    if (m_parent != nullptr) {
+        // the grant of every level is known at the root, each level takes it as the calls return
+        granted = m_parent->acquireLocked(granted, minimum, now);
+    } else if (granted < minimum) {
+        granted = 0; // the transfer waits for a larger block
+    }
+    if (granted != 0) {
+        if (m_rate != UNLIMITED) {
+            m_tokens -= static_cast<double>(granted);
+        }
+        m_acquired.fetch_add(granted, std::memory_order_relaxed);
+    }
+    return granted;
+}
+
+void RateLimiter::release(size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    for (RateLimiter *level = this; level != nullptr; level = level->m_parent.get()) {
+        if (level->m_limited.load(std::memory_order_acquire)) {
+            std::lock_guard lock(level->m_mutex);
+            if (level->m_rate != UNLIMITED) {
+                level->m_tokens = std::min(static_cast<double>(level->m_burst),
+                                           level->m_tokens + static_cast<double>(bytes));
+            }
+        }
+        level->m_acquired.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+}
+
+std::chrono::nanoseconds RateLimiter::getDelay(size_t bytes) const {
+    const auto now = std::chrono::steady_clock::now();
+    double seconds = 0;
+    for (const RateLimiter *level = this; level != nullptr; level = level->m_parent.get()) {
+        if (!level->m_limited.load(std::memory_order_acquire)) {
+            continue;
+        }
+        std::lock_guard lock(level->m_mutex);
+        if (level->m_rate == UNLIMITED) {
+            continue;
+        }
+        const double needed = static_cast<double>(std::min<uint64_t>({bytes, MIN_GRANT, level->m_burst}));
+        const double tokens = tokensAfter(level->m_tokens, level->m_rate, level->m_burst, now - level->m_lastRefill);
+        if (tokens < needed) {
+            seconds = std::max(seconds, (needed - tokens) / static_cast<double>(level->m_rate));
+        }
+    }
+    return std::chrono::ceil<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+}
+
+uint64_t RateLimiter::getAcquiredBytes() const {
+    return m_acquired.load(std::memory_order_relaxed);
+}
+
+const std::shared_ptr<RateLimiter> &RateLimiter::global() {
+    static const std::shared_ptr<RateLimiter> limiter = std::make_shared<RateLimiter>();
+    return limiter;
+}
+
+std::shared_ptr<RateLimiter> RateLimiter::forHost(const std::string &url) {
+    static std::mutex mutex;
+    // the buckets are owned by the clients and the callers using them, the hosts no longer used are dropped
+    static std::map<std::string, std::weak_ptr<RateLimiter>, std::less<> > hosts;
+    const size_t scheme = url.find("://");
+    const size_t start = scheme == std::string::npos ? 0 : scheme + 3;
+    std::string host = url.substr(start, url.find('/', start) - start);
+    std::lock_guard lock(mutex);
+    std::erase_if(hosts, [](const auto &entry) { return entry.second.expired(); });
+    std::weak_ptr<RateLimiter> &entry = hosts[std::move(host)];
+    std::shared_ptr<RateLimiter> limiter = entry.lock();
+    if (limiter == nullptr) {
+        limiter = std::make_shared<RateLimiter>(UNLIMITED, global());
+        entry = limiter;
+    }
+    return limiter;
+}
+
+void RateLimiter::refill(std::chrono::steady_clock::time_point now) {
+    if (m_rate != UNLIMITED) {
+        m_tokens = tokensAfter(m_tokens, m_rate, m_burst, now - m_lastRefill);
+    }
+    m_lastRefill = now;
+}
+
+bool RateLimiter::isLimited() const {
+    for (const RateLimiter *level = this; level != nullptr; level = level->m_parent.get()) {
+        if (level->m_limited.load(std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
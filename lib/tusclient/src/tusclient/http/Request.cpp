@@ -7,28 +7,26 @@
 #include <iostream>
 
 #include "http/Request.h"
+using TUS::Http::HeaderList;
 using TUS::Http::HttpMethod;
 using TUS::Http::Request;
+using TUS::Http::Response;
 
 
 Request::Request() {
     this->url = "";
     this->body = "";
     this->method = HttpMethod::_GET;
-    this->headers = map<string, string>();
-    this->headers["Content-Type"] = "application/json";
+    setDefaultContentType();
     setOnSuccessCallback(defaultSuccessCallback());
     setOnErrorCallback(defaultErrorCallback());
 }
 
-Request::Request(const Request &request)=default;
-
 Request::Request(string url) {
     this->url = std::move(url);
     this->body = "";
     this->method = HttpMethod::_GET;
-    this->headers = map<string, string>();
-    this->headers["Content-Type"] = "application/json";
+    setDefaultContentType();
     setOnSuccessCallback(defaultSuccessCallback());
     setOnErrorCallback(defaultErrorCallback());
 }
@@ -37,8 +35,7 @@ Request::Request(string url, string body) {
     this->url = std::move(url);
     this->body = std::move(body);
     this->method = HttpMethod::_POST;
-    this->headers = map<string, string>();
-    this->headers["Content-Type"] = "application/json";
+    setDefaultContentType();
     setOnSuccessCallback(defaultSuccessCallback());
     setOnErrorCallback(defaultErrorCallback());
 }
@@ -47,74 +44,62 @@ Request::Request(string url, string body, HttpMethod method) {
     this->url = std::move(url);
     this->body = std::move(body);
     this->method = method;
-    this->headers = map<string, string>();
-    this->headers["Content-Type"] = "application/json";
+    setDefaultContentType();
     setOnSuccessCallback(defaultSuccessCallback());
     setOnErrorCallback(defaultErrorCallback());
 }
 
-Request::Request(string url, string body, HttpMethod method, map<string, string> headers) {
+Request::Request(string url, string body, HttpMethod method, HeaderList headers) {
     this->url = std::move(url);
     this->body = std::move(body);
     this->method = method;
     this->headers = std::move(headers);
-    if (!this->headers.contains("Content-Type")) {
-        this->headers["Content-Type"] = "application/json";
-    }
+    setDefaultContentType();
     setOnSuccessCallback(defaultSuccessCallback());
     setOnErrorCallback(defaultErrorCallback());
 }
 
-Request::Request(string url, string body, HttpMethod method, map<string, string> headers,
+Request::Request(string url, string body, HttpMethod method, HeaderList headers,
                  SuccessCallback onSuccessCallback) {
     this->url = std::move(url);
     this->body = std::move(body);
     this->method = method;
     this->headers = std::move(headers);
-    if (!this->headers.contains("Content-Type")) {
-        this->headers["Content-Type"] = "application/json";
-    }
+    setDefaultContentType();
     setOnSuccessCallback(std::move(onSuccessCallback));
     setOnErrorCallback(defaultErrorCallback());
 }
 
-Request::Request(string url, string body, HttpMethod method, map<string, string> headers,
+Request::Request(string url, string body, HttpMethod method, HeaderList headers,
                  SuccessCallback onSuccessCallback, ErrorCallback onErrorCallback) {
     this->url = std::move(url);
     this->body = std::move(body);
     this->method = method;
     this->headers = std::move(headers);
-    if (!this->headers.contains("Content-Type")) {
-        this->headers["Content-Type"] = "application/json";
-    }
+    setDefaultContentType();
     setOnSuccessCallback(std::move(onSuccessCallback));
     setOnErrorCallback(std::move(onErrorCallback));
 }
 
-
-Request &Request::operator=(const Request &request) {
-    this->url = request.url;
-    this->body = request.body;
-    this->method = request.method;
-    this->headers = request.headers;
-    setOnSuccessCallback(request.getOnSuccessCallback());
-    setOnErrorCallback(request.getOnErrorCallback());
-    return *this;
+void Request::setDefaultContentType() {
+    if (!this->headers.contains("Content-Type")) {
+        this->headers.set("Content-Type", "application/json");
+    }
 }
 
-void Request::addHeader(const string &key, const string &value) {
-    this->headers[key] = value;
+void Request::addHeader(std::string_view key, string value) {
+    this->headers.set(key, std::move(value));
 }
 
 void Request::autorizationHeader(const string &berearToken) {
-    this->headers["Authorization"] = "Bearer " + berearToken;
+    this->headers.set("Authorization", "Bearer " + berearToken);
 }
 
-string Request::getUrl() const {
+const string &Request::getUrl() const {
     return this->url;
 }
 
-string Request::getBody() const {
+std::string_view Request::getBody() const {
     return this->body;
 }
 
@@ -122,7 +107,19 @@ HttpMethod Request::getMethod() const {
     return this->method;
 }
 
-map<string, string> Request::getHeaders() const {
+void Request::setBodySource(TUS::Http::RequestBody body) {
+    this->m_bodySource = std::move(body);
+}
+
+const TUS::Http::RequestBody &Request::getBodySource() const {
+    return this->m_bodySource;
+}
+
+bool Request::hasBodySource() const {
+    return this->m_bodySource.source != nullptr || this->m_bodySource.data != nullptr;
+}
+
+const HeaderList &Request::getHeaders() const {
     return this->headers;
 }
 
@@ -134,24 +131,48 @@ void Request::setOnErrorCallback(ErrorCallback onErrorCallback) {
     this->m_onErrorCallback = std::move(onErrorCallback);
 }
 
-Request::SuccessCallback Request::getOnSuccessCallback() const {
+const Request::SuccessCallback &Request::getOnSuccessCallback() const {
     return this->m_onSuccessCallback;
 }
 
-Request::ErrorCallback Request::getOnErrorCallback() const {
+const Request::ErrorCallback &Request::getOnErrorCallback() const {
     return this->m_onErrorCallback;
 }
 
+void Request::setProgress(std::shared_ptr<Progress> progress) {
+    this->m_progress = std::move(progress);
+}
+
+const std::shared_ptr<TUS::Http::Progress> &Request::getProgress() const {
+    return this->m_progress;
+}
+
+void Request::setRateLimiter(std::shared_ptr<RateLimiter> rateLimiter) {
+    this->m_rateLimiter = std::move(rateLimiter);
+}
+
+const std::shared_ptr<TUS::Http::RateLimiter> &Request::getRateLimiter() const {
+    return this->m_rateLimiter;
+}
+
+void Request::setTag(string tag) {
+    this->m_tag = std::move(tag);
+}
+
+const string &Request::getTag() const {
+    return this->m_tag;
+}
+
 Request::SuccessCallback Request::defaultSuccessCallback() {
-    return [](const string &header, const string &data) {
-        std::cout << header << std::endl;
-        std::cout << data << std::endl;
+    return [](const Response &response) {
+        std::cout << response.getHeaders() << std::endl;
+        std::cout << response.getBody() << std::endl;
         std::cout << "Successful callback not implemented" << std::endl;
     };
 }
 
 Request::ErrorCallback Request::defaultErrorCallback() {
-    return [](const string &, const string &) {
+    return [](const Response &) {
         std::cout << "Failed callback not implemented" << std::endl;
     };
 }
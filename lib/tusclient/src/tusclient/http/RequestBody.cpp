@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "http/RequestBody.h"
+
+using TUS::Http::BufferBodySource;
+using TUS::Http::FileBodySource;
+using TUS::Http::RequestBody;
+
+FileBodySource::FileBodySource(std::filesystem::path filePath)
+    : m_filePath(std::move(filePath)), m_size(std::filesystem::file_size(m_filePath)),
+      m_file(m_filePath, std::ios::binary) {
+    if (!m_file) {
+        throw std::runtime_error("Failed to open body file: " + m_filePath.string());
+    }
+}
+
+size_t FileBodySource::read(uint64_t offset, char *buffer, size_t size) {
+    if (offset >= m_size) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    m_file.read(buffer, static_cast<std::streamsize>(std::min<uint64_t>(size, m_size - offset)));
+    return static_cast<size_t>(m_file.gcount());
+}
+
+uint64_t FileBodySource::size() const {
+    return m_size;
+}
+
+BufferBodySource::BufferBodySource(const void *data, size_t size)
+    : m_data(static_cast<const char *>(data)), m_size(size) {
+}
+
+size_t BufferBodySource::read(uint64_t offset, char *buffer, size_t size) {
+    if (offset >= m_size) {
+        return 0;
+    }
+    const size_t count = std::min<uint64_t>(size, m_size - offset);
+    std::memcpy(buffer, m_data + offset, count);
+    return count;
+}
+
+uint64_t BufferBodySource::size() const {
+    return m_size;
+}
+
+RequestBody RequestBody::view(const void *data, size_t size) {
+    return {nullptr, 0, size, static_cast<const char *>(data)};
+}
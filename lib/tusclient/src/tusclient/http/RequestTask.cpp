@@ -9,8 +9,12 @@
 using TUS::Http::RequestTask;
 
 
-RequestTask::RequestTask(const Request &request, CURL *curl) : Request(request), curl(curl) {
+RequestTask::RequestTask(Request &&request, CURL *curl) : Request(std::move(request)), curl(curl),
+                                                          owner(std::this_thread::get_id()) {
 }
 
-RequestTask::~RequestTask()
-= default;
+RequestTask::~RequestTask() {
+    if (headers != nullptr) {
+        curl_slist_free_all(headers);
+    }
+}
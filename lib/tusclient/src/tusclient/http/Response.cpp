@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <charconv>
+#include <curl/curl.h>
+#include "http/Response.h"
+
+using TUS::Http::Response;
+
+namespace {
+    constexpr std::string_view WHITESPACE = " \t\r\n";
+
+    std::string_view trim(std::string_view text) {
+        const size_t start = text.find_first_not_of(WHITESPACE);
+        if (start == std::string_view::npos) {
+            return {};
+        }
+        const size_t end = text.find_last_not_of(WHITESPACE);
+        return text.substr(start, end - start + 1);
+    }
+
+    bool equalsIgnoreCase(std::string_view left, std::string_view right) {
+        if (left.size() != right.size()) {
+            return false;
+        }
+        // header names are ASCII tokens
+        const auto toLower = [](char c) {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        };
+        for (size_t i = 0; i < left.size(); ++i) {
+            if (toLower(left[i]) != toLower(right[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::optional<int64_t> parseInteger(std::string_view text) {
+        int64_t value = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size() || value < 0) {
+            return std::nullopt;
+        }
+        return value;
+    }
+}
+
+Response::Response(std::string_view headers, std::string body, long statusCode) : m_body(std::move(body)) {
+    size_t position = 0;
+    while (position < headers.size()) {
+        size_t lineEnd = headers.find('\n', position);
+        lineEnd = lineEnd == std::string_view::npos ? headers.size() : lineEnd + 1;
+        parseHeaderLine(headers.substr(position, lineEnd - position));
+        position = lineEnd;
+    }
+    if (statusCode != 0) {
+        m_statusCode = statusCode;
+    }
+}
+
+void Response::reset() {
+    m_headers.clear();
+    m_statusCode = 0;
+    m_uploadOffset.reset();
+    m_uploadLength.reset();
+    m_tusMaxSize.reset();
+    m_uploadLengthDeferred = false;
+    m_location = {};
+    m_tusResumable = {};
+    m_tusVersion = {};
+    m_tusExtension = {};
+}
+
+void Response::parseHeaderLine(std::string_view line) {
+    if (const int statusCode = parseStatusLine(line); statusCode >= 0) {
+        // a new response starts, e.g. the final response after "100 Continue"
+        reset();
+        m_statusCode = statusCode;
+    }
+    if (m_headers.capacity() < HEADERS_CAPACITY) {
+        // the headers of a tus response fit, they are appended without reallocating
+        m_headers.reserve(HEADERS_CAPACITY);
+    }
+    const auto lineOffset = static_cast<uint32_t>(m_headers.size());
+    m_headers.append(line);
+
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) {
+        return;
+    }
+    const std::string_view name = trim(line.substr(0, colon));
+    const std::string_view value = trim(line.substr(colon + 1));
+    const Field field{
+        static_cast<uint32_t>(lineOffset + (value.data() - line.data())), static_cast<uint32_t>(value.size())
+    };
+
+    if (equalsIgnoreCase(name, "Upload-Offset")) {
+        m_uploadOffset = parseInteger(value);
+    } else if (equalsIgnoreCase(name, "Upload-Length")) {
+        m_uploadLength = parseInteger(value);
+    } else if (equalsIgnoreCase(name, "Upload-Defer-Length")) {
+        m_uploadLengthDeferred = value == "1";
+    } else if (equalsIgnoreCase(name, "Location")) {
+        m_location = field;
+    } else if (equalsIgnoreCase(name, "Tus-Resumable")) {
+        m_tusResumable = field;
+    } else if (equalsIgnoreCase(name, "Tus-Version")) {
+        m_tusVersion = field;
+    } else if (equalsIgnoreCase(name, "Tus-Extension")) {
+        m_tusExtension = field;
+    } else if (equalsIgnoreCase(name, "Tus-Max-Size")) {
+        m_tusMaxSize = parseInteger(value);
+    }
+}
+
+void Response::appendBody(const char *data, size_t size) {
+    m_body.append(data, size);
+}
+
+void Response::setStatusCode(long statusCode) {
+    m_statusCode = statusCode;
+}
+
+long Response::getStatusCode() const {
+    return m_statusCode;
+}
+
+void Response::setUploadStats(uint64_t bytes, std::chrono::microseconds duration) {
+    m_uploadedBytes = bytes;
+    m_uploadDuration = duration;
+}
+
+double Response::getUploadSpeed() const {
+    if (m_uploadedBytes == 0 || m_uploadDuration.count() <= 0) {
+        return 0;
+    }
+    return static_cast<double>(m_uploadedBytes) / std::chrono::duration<double>(m_uploadDuration).count();
+}
+
+std::optional<int64_t> Response::getUploadOffset() const {
+    return m_uploadOffset;
+}
+
+std::optional<int64_t> Response::getUploadLength() const {
+    return m_uploadLength;
+}
+
+bool Response::isUploadLengthDeferred() const {
+    return m_uploadLengthDeferred;
+}
+
+std::string_view Response::getLocation() const {
+    return view(m_location);
+}
+
+std::string_view Response::getTusResumable() const {
+    return view(m_tusResumable);
+}
+
+std::string_view Response::getTusVersion() const {
+    return view(m_tusVersion);
+}
+
+std::string_view Response::getTusExtension() const {
+    return view(m_tusExtension);
+}
+
+std::optional<int64_t> Response::getTusMaxSize() const {
+    return m_tusMaxSize;
+}
+
+bool Response::supportsExtension(std::string_view extension) const {
+    std::string_view extensions = getTusExtension();
+    while (!extensions.empty()) {
+        const size_t comma = extensions.find(',');
+        if (trim(extensions.substr(0, comma)) == extension) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        extensions.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+std::optional<std::chrono::system_clock::time_point> Response::getUploadExpires() const {
+    const std::string_view value = getHeader("Upload-Expires");
+    if (value.empty()) {
+        return std::nullopt;
+    }
+    // an RFC 9110 date, e.g. "Wed, 25 Jun 2014 16:00:00 GMT"
+    const time_t expires = curl_getdate(std::string(value).c_str(), nullptr);
+    if (expires == -1) {
+        return std::nullopt;
+    }
+    return std::chrono::system_clock::from_time_t(expires);
+}
+
+std::string_view Response::getHeader(std::string_view name) const {
+    std::string_view headers = m_headers;
+    while (!headers.empty()) {
+        size_t lineEnd = headers.find('\n');
+        const std::string_view line = headers.substr(0, lineEnd);
+        if (const size_t colon = line.find(':');
+            colon != std::string_view::npos && equalsIgnoreCase(trim(line.substr(0, colon)), name)) {
+            return trim(line.substr(colon + 1));
+        }
+        if (lineEnd == std::string_view::npos) {
+            break;
+        }
+        headers.remove_prefix(lineEnd + 1);
+    }
+    return {};
+}
+
+std::string_view Response::getHeaders() const {
+    return m_headers;
+}
+
+std::string_view Response::getBody() const {
+    return m_body;
+}
+
+int Response::parseStatusLine(std::string_view line) {
+    constexpr std::string_view prefix = "HTTP/";
+    if (!line.starts_with(prefix)) {
+        return -1;
+    }
+    const size_t space = line.find(' ', prefix.size());
+    if (space == std::string_view::npos) {
+        return -1;
+    }
+    int statusCode = 0;
+    const char *first = line.data() + space + 1;
+    const char *last = line.data() + line.size();
+    if (const auto [end, error] = std::from_chars(first, last, statusCode);
+        error != std::errc() || end - first != 3) {
+        return -1;
+    }
+    return statusCode;
+}
+
+std::string_view Response::view(Field field) const {
+    return std::string_view(m_headers).substr(field.offset, field.length);
+}
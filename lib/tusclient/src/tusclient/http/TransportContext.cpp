@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+#include "http/TransportContext.h"
+
+using TUS::Http::IHttpClient;
+using TUS::Http::RequestTask;
+using TUS::Http::TransportContext;
+
+TransportContext::TransportContext() : TransportContext(nullptr) {
+}
+
+TransportContext::TransportContext(std::shared_ptr<TUS::Logging::ILogger> logger) : m_logger(std::move(logger)) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    m_multi = curl_multi_init();
+    m_share = curl_share_init();
+    if (m_multi == nullptr || m_share == nullptr) {
+        curl_multi_cleanup(m_multi);
+        curl_share_cleanup(m_share);
+        curl_global_cleanup();
+        throw std::runtime_error("CURL multi initialization failed");
+    }
+    // idle connections stay in the cache of the multi handle and are reused by the next requests
+    curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, MAX_CACHED_CONNECTIONS);
+    // the transfers to an HTTP/2 server are sent as streams of the same connection
+    curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(m_multi, CURLMOPT_MAX_CONCURRENT_STREAMS, static_cast<long>(DEFAULT_MAX_CONCURRENT_STREAMS));
+
+    // the connection cache is the one of the multi handle, the share handle only holds the data
+    // that libcurl allows to be used by several threads
+    curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, lockShare);
+    curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+    curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+TransportContext::~TransportContext() {
+    for (auto &task: m_requestsQueue) {
+        m_handlePool.release(task->curl);
+    }
+    m_requestsQueue.clear();
+    for (auto &task: m_inFlight) {
+        curl_multi_remove_handle(m_multi, task->curl);
+        m_handlePool.release(task->curl);
+    }
+    m_inFlight.clear();
+    for (auto &task: m_completed) {
+        m_handlePool.release(task->curl);
+    }
+    m_completed.clear();
+    curl_multi_cleanup(m_multi);
+    // the pooled handles still reference the share handle, they are cleaned up before it
+    m_handlePool.clear();
+    curl_share_cleanup(m_share);
+    curl_global_cleanup();
+}
+
+void TransportContext::lockShare(CURL *, curl_lock_data data, curl_lock_access, void *userptr) {
+    static_cast<TransportContext *>(userptr)->m_shareMutexes.at(data).lock();
+}
+
+void TransportContext::unlockShare(CURL *, curl_lock_data data, void *userptr) {
+    static_cast<TransportContext *>(userptr)->m_shareMutexes.at(data).unlock();
+}
+
+CURL *TransportContext::acquireHandle() {
+    CURL *curl = m_handlePool.acquire();
+    if (curl != nullptr) {
+        // resolve the hosts and resume the TLS sessions through the cache of the context
+        curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+    }
+    return curl;
+}
+
+void TransportContext::releaseHandle(CURL *curl) {
+    m_handlePool.release(curl);
+}
+
+void TransportContext::enqueue(std::unique_ptr<RequestTask> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_requestsQueue.push_back(std::move(task));
+    }
+    // a thread could be waiting in curl_multi_poll, wake it up to start the new transfer
+    curl_multi_wakeup(m_multi);
+}
+
+void TransportContext::abort(const IHttpClient *client,
+                             const std::function<bool(const RequestTask &)> &predicate) {
+    bool interrupted = false;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        std::erase_if(m_requestsQueue, [this, client, &predicate](const std::unique_ptr<RequestTask> &requestTask) {
+            if (requestTask->client != client || !predicate(*requestTask)) {
+                return false;
+            }
+            m_handlePool.release(requestTask->curl);
+            return true;
+        });
+        std::erase_if(m_completed, [this, client, &predicate](const std::unique_ptr<RequestTask> &requestTask) {
+            if (requestTask->client != client || !predicate(*requestTask)) {
+                return false;
+            }
+            m_handlePool.release(requestTask->curl);
+            return true;
+        });
+        // the multi handle belongs to the driving thread, the transfers are only flagged here
+        for (auto &requestTask: m_inFlight) {
+            if (requestTask->client == client && predicate(*requestTask)) {
+                requestTask->aborted = true;
+                interrupted = true;
+            }
+        }
+    }
+    if (interrupted) {
+        curl_multi_wakeup(m_multi);
+    }
+}
+
+void TransportContext::detach(const IHttpClient *client) {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    const auto release = [this, client](const std::unique_ptr<RequestTask> &requestTask) {
+        if (requestTask->client != client) {
+            return false;
+        }
+        m_handlePool.release(requestTask->curl);
+        return true;
+    };
+    std::erase_if(m_requestsQueue, release);
+    std::erase_if(m_completed, release);
+    // the transfers in flight belong to the driving thread, they are stopped and dropped by it
+    bool interrupted = false;
+    for (auto &requestTask: m_inFlight) {
+        if (requestTask->client == client) {
+            requestTask->client = nullptr;
+            requestTask->aborted = true;
+            interrupted = true;
+        }
+    }
+    if (interrupted) {
+        curl_multi_wakeup(m_multi);
+    }
+}
+
+void TransportContext::removeAbortedTransfers() {
+    std::erase_if(m_inFlight, [this](const std::unique_ptr<RequestTask> &requestTask) {
+        if (!requestTask->aborted) {
+            return false;
+        }
+        curl_multi_remove_handle(m_multi, requestTask->curl);
+        m_handlePool.release(requestTask->curl);
+        return true;
+    });
+}
+
+bool TransportContext::hasPendingWork(const IHttpClient *client, std::thread::id owner) const {
+    const auto isOwned = [client, owner](const std::unique_ptr<RequestTask> &requestTask) {
+        return requestTask->client == client && requestTask->owner == owner;
+    };
+    return std::ranges::any_of(m_requestsQueue, isOwned) || std::ranges::any_of(m_inFlight, isOwned) ||
+           std::ranges::any_of(m_completed, isOwned);
+}
+
+void TransportContext::performTransfers() {
+    {
+        // Lock the mutex again before accessing the queue
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (m_pendingStreamsLimit) {
+            curl_multi_setopt(m_multi, CURLMOPT_MAX_CONCURRENT_STREAMS, static_cast<long>(m_maxConcurrentStreams));
+            m_pendingStreamsLimit = false;
+        }
+        removeAbortedTransfers();
+        while (m_inFlight.size() < m_maxConcurrentTransfers && !m_requestsQueue.empty()) {
+            curl_multi_add_handle(m_multi, m_requestsQueue.front()->curl);
+            m_inFlight.push_back(std::move(m_requestsQueue.front()));
+            m_requestsQueue.pop_front();
+        }
+    }
+
+    int runningTransfers = 0;
+    CURLMcode multiResult = curl_multi_perform(m_multi, &runningTransfers);
+    if (multiResult == CURLM_OK && runningTransfers > 0) {
+        // the transfers paused by their rate limiter or waiting for their body are resumed in time, the ones paused
+        // by the perform above included: the poll ends when the first of them is due
+        const int pollTimeout = resumePausedTransfers();
+        // wait for activity on the sockets, it returns earlier if curl_multi_wakeup() is called
+        multiResult = curl_multi_poll(m_multi, nullptr, 0, pollTimeout, nullptr);
+        if (multiResult == CURLM_OK) {
+            multiResult = curl_multi_perform(m_multi, &runningTransfers);
+        }
+    }
+    if (multiResult != CURLM_OK && m_logger != nullptr) {
+        m_logger->error("CURL multi error: " + std::string(curl_multi_strerror(multiResult)));
+    }
+
+    int messagesLeft = 0;
+    while (const CURLMsg *message = curl_multi_info_read(m_multi, &messagesLeft)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        CURL *curl = message->easy_handle;
+        const CURLcode result = message->data.result;
+        curl_multi_remove_handle(m_multi, curl);
+
+        if (long connects = 0; result == CURLE_OK &&
+                               curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects) == CURLE_OK) {
+            // NUM_CONNECTS is the number of new connections the transfer needed, 0 if it reused one
+            if (connects > 0) {
+                m_newConnections += static_cast<uint64_t>(connects);
+            } else {
+                ++m_reusedConnections;
+            }
+        }
+
+        if (long httpVersion = 0; result == CURLE_OK &&
+                                  curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &httpVersion) == CURLE_OK &&
+                                  httpVersion == CURL_HTTP_VERSION_2_0) {
+            ++m_http2Requests;
+        }
+
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        auto it = std::ranges::find_if(m_inFlight, [curl](const std::unique_ptr<RequestTask> &requestTask) {
+            return requestTask->curl == curl;
+        });
+        if (it == m_inFlight.end()) {
+            continue;
+        }
+        if ((*it)->client == nullptr || (*it)->aborted) {
+            // the request has been aborted or its client destroyed while the transfer was running
+            m_handlePool.release(curl);
+            m_inFlight.erase(it);
+            continue;
+        }
+        (*it)->result = result;
+        if (long responseCode = 0; curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode) == CURLE_OK) {
+            (*it)->response.setStatusCode(responseCode);
+        }
+        // the bandwidth of this request alone, the time before the transfer started (e.g. connecting) is left out
+        if (curl_off_t uploaded = 0, total = 0, pretransfer = 0;
+            curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &uploaded) == CURLE_OK &&
+            curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total) == CURLE_OK &&
+            curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME_T, &pretransfer) == CURLE_OK) {
+            (*it)->response.setUploadStats(static_cast<uint64_t>(uploaded),
+                                           std::chrono::microseconds(total - pretransfer));
+        }
+        curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &(*it)->httpVersion);
+        m_completed.splice(m_completed.end(), m_inFlight, it);
+    }
+
+    // the transfers aborted while curl was running are not reported by curl_multi_info_read
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    removeAbortedTransfers();
+}
+
+int TransportContext::resumePausedTransfers() {
+    std::vector<CURL *> resumed;
+    auto timeout = std::chrono::milliseconds(POLL_TIMEOUT_MS);
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto &requestTask: m_inFlight) {
+            if (!requestTask->readPaused) {
+                continue;
+            }
+            if (requestTask->resumeAt <= now) {
+                requestTask->readPaused = false;
+                resumed.push_back(requestTask->curl);
+            } else {
+                // wake up in time for the first one
+                timeout = std::min(timeout, std::chrono::ceil<std::chrono::milliseconds>(requestTask->resumeAt - now));
+            }
+        }
+    }
+    // the read callback can run again from curl_easy_pause() and pause the transfer again
+    for (CURL *curl: resumed) {
+        curl_easy_pause(curl, CURLPAUSE_CONT);
+    }
+    return resumed.empty() ? static_cast<int>(timeout.count()) : 0;
+}
+
+std::unique_ptr<RequestTask> TransportContext::nextCompleted(const IHttpClient *client) {
+    const std::thread::id owner = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    while (true) {
+        // Hand the finished transfers back to the thread that queued them
+        if (auto it = std::ranges::find_if(m_completed, [client, owner](const std::unique_ptr<RequestTask> &task) {
+            return task->client == client && task->owner == owner;
+        }); it != m_completed.end()) {
+            std::unique_ptr<RequestTask> requestTask = std::move(*it);
+            m_completed.erase(it);
+            return requestTask;
+        }
+
+        // If there is nothing left for this thread, break the loop
+        if (!hasPendingWork(client, owner)) {
+            return nullptr;
+        }
+
+        // Another thread is driving the transfers, wait until it has made some progress
+        if (m_driving) {
+            m_transfersProgressed.wait(lock);
+            continue;
+        }
+
+        m_driving = true;
+        lock.unlock();
+        try {
+            performTransfers();
+        } catch (...) {
+            lock.lock();
+            m_driving = false;
+            m_transfersProgressed.notify_all();
+            throw;
+        }
+        lock.lock();
+        m_driving = false;
+        m_transfersProgressed.notify_all();
+    }
+}
+
+void TransportContext::setMaxConcurrentTransfers(size_t maxTransfers) {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_maxConcurrentTransfers = std::max<size_t>(1, maxTransfers);
+}
+
+size_t TransportContext::getMaxConcurrentTransfers() const {
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return m_maxConcurrentTransfers;
+}
+
+void TransportContext::setMaxConcurrentStreams(size_t maxStreams) {
+    maxStreams = std::clamp<size_t>(maxStreams, 1, MAX_CONCURRENT_STREAMS);
+    m_maxConcurrentStreams = maxStreams;
+    // the multi handle is not thread safe, the driving thread could be using it
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_pendingStreamsLimit = true;
+    curl_multi_wakeup(m_multi);
+}
+
+size_t TransportContext::getMaxConcurrentStreams() const {
+    return m_maxConcurrentStreams;
+}
+
+TUS::Http::ConnectionStats TransportContext::getConnectionStats() const {
+    return ConnectionStats{m_newConnections.load(), m_reusedConnections.load(), m_http2Requests.load()};
+}
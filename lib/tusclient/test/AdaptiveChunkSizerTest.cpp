@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include "chunk/AdaptiveChunkSizer.h"
+
+using TUS::Chunk::AdaptiveChunkSizer;
+using namespace std::chrono_literals;
+
+namespace {
+    constexpr uint64_t MB = 1024 * 1024;
+}
+
+TEST(AdaptiveChunkSizerTest, GrowsOnAFastLink) {
+    AdaptiveChunkSizer sizer(1 * MB, 2s);
+    EXPECT_EQ(sizer.getChunkSize(), 1 * MB);
+    // 10 MB/s, 20 MB last 2 s, the size doubles at most
+    sizer.onSuccess(1 * MB, 100ms);
+    EXPECT_EQ(sizer.getChunkSize(), 2 * MB);
+    sizer.onSuccess(2 * MB, 200ms);
+    EXPECT_EQ(sizer.getChunkSize(), 4 * MB);
+    EXPECT_NEAR(sizer.getBandwidth(), 10.0 * MB, 1);
+}
+
+TEST(AdaptiveChunkSizerTest, ConvergesToTheTargetDuration) {
+    AdaptiveChunkSizer sizer(1 * MB, 1s);
+    for (int i = 0; i < 10; ++i) {
+        const uint64_t size = sizer.getChunkSize();
+        // 8 MB/s and no round trip
+        sizer.onSuccess(size, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::duration<double>(static_cast<double>(size) / (8.0 * MB))), 8.0 * MB);
+    }
+    EXPECT_EQ(sizer.getChunkSize(), 8 * MB);
+}
+
+TEST(AdaptiveChunkSizerTest, ShrinksOnASlowLink) {
+    AdaptiveChunkSizer sizer(8 * MB, 2s);
+    // 100 KB/s, the size halves at most
+    sizer.onSuccess(8 * MB, 80s);
+    EXPECT_EQ(sizer.getChunkSize(), 4 * MB);
+}
+
+TEST(AdaptiveChunkSizerTest, HalvesOnFailure) {
+    AdaptiveChunkSizer sizer(8 * MB, 2s, 1 * MB);
+    sizer.onFailure();
+    EXPECT_EQ(sizer.getChunkSize(), 4 * MB);
+    sizer.onFailure();
+    sizer.onFailure();
+    sizer.onFailure();
+    EXPECT_EQ(sizer.getChunkSize(), 1 * MB);
+}
+
+TEST(AdaptiveChunkSizerTest, RespectsTheMaximumSize) {
+    AdaptiveChunkSizer sizer(1 * MB, 2s, 256 * 1024, 3 * MB);
+    sizer.onSuccess(1 * MB, 10ms);
+    sizer.onSuccess(2 * MB, 20ms);
+    EXPECT_EQ(sizer.getChunkSize(), 3 * MB);
+    // e.g. the Tus-Max-Size of the server
+    sizer.limitMaxSize(2 * MB);
+    EXPECT_EQ(sizer.getChunkSize(), 2 * MB);
+    EXPECT_EQ(sizer.getMaxSize(), 2 * MB);
+    sizer.limitMaxSize(0);
+    EXPECT_EQ(sizer.getMaxSize(), 2 * MB);
+}
+
+TEST(AdaptiveChunkSizerTest, LongRoundTripsNeedLargerRequests) {
+    AdaptiveChunkSizer sizer(1 * MB, 100ms);
+    // the body takes 10 ms at 100 MB/s, the round trip 200 ms
+    sizer.onSuccess(1 * MB, 210ms, 100.0 * MB);
+    EXPECT_NEAR(std::chrono::duration<double>(sizer.getRoundTripTime()).count(), 0.2, 0.001);
+    // a request lasts at least 10 round trips, so it grows even if it already lasts longer than the target
+    EXPECT_EQ(sizer.getChunkSize(), 2 * MB);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "chunk/SourceFileChunker.h"
+#include "chunk/TUSChunk.h"
+#include "chunk/utility/BufferPool.h"
+
+using TUS::Chunk::Utility::BufferPool;
+
+TEST(BufferPoolTest, ReleasedBuffersAreReused) {
+    auto pool = std::make_shared<BufferPool>();
+    uint8_t *first = pool->acquire(100 * 1024).get();
+    EXPECT_EQ(pool->getIdleBytes(), BufferPool::getCapacity(100 * 1024));
+
+    auto buffer = pool->acquire(100 * 1024);
+    EXPECT_EQ(buffer.get(), first);
+    EXPECT_EQ(pool->getIdleBytes(), 0);
+    // another capacity needs another buffer
+    EXPECT_NE(pool->acquire(200 * 1024).get(), first);
+}
+
+TEST(BufferPoolTest, BuffersAreAligned) {
+    auto pool = std::make_shared<BufferPool>();
+    EXPECT_EQ(BufferPool::getCapacity(1), BufferPool::ALIGNMENT);
+    EXPECT_EQ(BufferPool::getCapacity(BufferPool::ALIGNMENT + 1), 2 * BufferPool::ALIGNMENT);
+    for (size_t size: {size_t{1}, size_t{12345}, size_t{1024 * 1024}}) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pool->acquire(size).get()) % BufferPool::ALIGNMENT, 0);
+    }
+}
+
+TEST(BufferPoolTest, IdleBuffersAreBounded) {
+    auto pool = std::make_shared<BufferPool>(2 * BufferPool::ALIGNMENT);
+    {
+        auto first = pool->acquire(BufferPool::ALIGNMENT);
+        auto second = pool->acquire(BufferPool::ALIGNMENT);
+        auto third = pool->acquire(BufferPool::ALIGNMENT);
+    }
+    EXPECT_EQ(pool->getIdleBytes(), 2 * BufferPool::ALIGNMENT);
+    pool->setIdleLimit(0);
+    EXPECT_EQ(pool->getIdleBytes(), 0);
+}
+
+TEST(BufferPoolTest, BuffersOutliveThePool) {
+    auto pool = std::make_shared<BufferPool>();
+    auto buffer = pool->acquire(64);
+    pool.reset();
+    buffer.get()[63] = 1;
+    buffer.reset();
+}
+
+TEST(BufferPoolTest, ChunkersShareThePool) {
+    const auto filePath = std::filesystem::temp_directory_path() / "poolfile.bin";
+    {
+        std::ofstream file(filePath, std::ios::binary);
+        file << std::string(64 * 1024, 'P');
+    }
+    TUS::Chunk::SourceFileChunker first(filePath, 16 * 1024);
+    TUS::Chunk::SourceFileChunker second(filePath, 16 * 1024);
+    first.chunkFile();
+    second.chunkFile();
+
+    const uint8_t *bytes = first.getChunk(0).getBytes();
+    // the buffer of the chunk released by the first upload is read into by the second one
+    const TUS::Chunk::TUSChunk chunk = second.getChunk(3);
+    EXPECT_EQ(chunk.getBytes(), bytes);
+    EXPECT_EQ(chunk.getData()[0], 'P');
+    std::filesystem::remove(filePath);
+}
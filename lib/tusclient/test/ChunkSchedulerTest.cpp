@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "chunk/ChunkScheduler.h"
+
+namespace {
+    /**
+     * @brief An upload of a number of chunks, it checks that they are sent one at a time and in order
+     */
+    struct FakeUpload {
+        explicit FakeUpload(int chunks, std::chrono::microseconds duration = std::chrono::microseconds(0))
+            : chunks(chunks), duration(duration) {
+        }
+
+        bool sendNextChunk() {
+            if (sending.exchange(true)) {
+                overlapped.store(true);
+            }
+            std::this_thread::sleep_for(duration);
+            const int sent = ++offset;
+            sending.store(false);
+            return sent < chunks;
+        }
+
+        const int chunks;
+        const std::chrono::microseconds duration;
+        std::atomic<int> offset{0};
+        std::atomic<bool> sending{false};
+        std::atomic<bool> overlapped{false};
+    };
+}
+
+TEST(ChunkSchedulerTest, ChunksOfAnUploadAreSentInOrder) {
+    TUS::Chunk::ChunkScheduler scheduler(4);
+    std::vector<std::unique_ptr<FakeUpload> > uploads;
+    for (int i = 0; i < 50; ++i) {
+        uploads.push_back(std::make_unique<FakeUpload>(20));
+        scheduler.add([upload = uploads.back().get()] { return upload->sendNextChunk(); });
+    }
+    scheduler.wait();
+
+    EXPECT_EQ(scheduler.getUploads(), 0);
+    for (const auto &upload: uploads) {
+        EXPECT_EQ(upload->offset.load(), 20);
+        EXPECT_FALSE(upload->overlapped.load());
+    }
+}
+
+TEST(ChunkSchedulerTest, IdleWorkersStealUploads) {
+    TUS::Chunk::ChunkScheduler scheduler(2);
+    EXPECT_EQ(scheduler.getWorkers(), 2);
+    // the deques take turns: the first worker gets the long uploads, the second one the short ones
+    std::vector<std::unique_ptr<FakeUpload> > uploads;
+    for (int i = 0; i < 6; ++i) {
+        uploads.push_back(std::make_unique<FakeUpload>(i % 2 == 0 ? 30 : 1, std::chrono::microseconds(500)));
+        scheduler.add([upload = uploads.back().get()] { return upload->sendNextChunk(); });
+    }
+    scheduler.wait();
+
+    EXPECT_GT(scheduler.getStolenSteps(), 0);
+    for (const auto &upload: uploads) {
+        EXPECT_EQ(upload->offset.load(), upload->chunks);
+        EXPECT_FALSE(upload->overlapped.load());
+    }
+}
+
+TEST(ChunkSchedulerTest, ExceptionEndsTheUpload) {
+    TUS::Chunk::ChunkScheduler scheduler(1);
+    std::atomic<int> steps{0};
+    scheduler.add([&steps]() -> bool {
+        ++steps;
+        throw std::runtime_error("failed");
+    });
+    scheduler.wait();
+    EXPECT_EQ(steps.load(), 1);
+    EXPECT_EQ(scheduler.getUploads(), 0);
+}
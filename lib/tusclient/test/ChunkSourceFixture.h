@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#ifndef TEST_CHUNKSOURCEFIXTURE_H_
+#define TEST_CHUNKSOURCEFIXTURE_H_
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "chunk/IFileChunker.h"
+#include "chunk/TUSChunk.h"
+
+/**
+ * @brief A file written for each test of the chunkers reading the source file, with CHUNK_SIZE it has
+ * CHUNK_COUNT chunks and the last one has 123 bytes.
+ */
+class ChunkSourceFixture : public ::testing::Test {
+public:
+    static constexpr size_t FILE_SIZE = 1024 * 1024 + 123;
+    static constexpr int CHUNK_SIZE = 256 * 1024;
+    static constexpr int CHUNK_COUNT = 5;
+
+    void SetUp() override {
+        testFilePath = std::filesystem::temp_directory_path() / "chunksource.bin";
+        content = writeFile(testFilePath, FILE_SIZE, 251);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(testFilePath);
+    }
+
+    static std::vector<uint8_t> writeFile(const std::filesystem::path &filePath, size_t size, int modulo) {
+        std::vector<uint8_t> bytes(size);
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<uint8_t>(i % modulo); // every chunk has different bytes
+        }
+        std::ofstream file(filePath, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    }
+
+    static std::vector<uint8_t> readAll(const TUS::Chunk::IFileChunker<TUS::Chunk::TUSChunk> &chunker) {
+        std::vector<uint8_t> uploaded;
+        for (int i = 0; i < chunker.getChunkNumber(); ++i) {
+            auto chunk = chunker.getChunk(i);
+            uploaded.insert(uploaded.end(), chunk.getBytes(), chunk.getBytes() + chunk.getChunkSize());
+        }
+        return uploaded;
+    }
+
+    std::filesystem::path testFilePath;
+    std::vector<uint8_t> content;
+};
+
+
+#endif // TEST_CHUNKSOURCEFIXTURE_H_
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include "ChunkSourceFixture.h"
+#include "chunk/IoUringFileChunker.h"
+#include "chunk/MappedFileChunker.h"
+#include "chunk/SourceFileChunker.h"
+#include "exceptions/TUSException.h"
+
+/**
+ * @brief The behaviour shared by the chunkers reading the source file in place, whatever the way they read it.
+ */
+template<typename Chunker>
+class ChunkSourceTest : public ChunkSourceFixture {
+};
+
+using ChunkSources = ::testing::Types<TUS::Chunk::SourceFileChunker, TUS::Chunk::MappedFileChunker,
+    TUS::Chunk::IoUringFileChunker>;
+TYPED_TEST_SUITE(ChunkSourceTest, ChunkSources);
+
+TYPED_TEST(ChunkSourceTest, ChunksAreReadFromTheFile) {
+    TypeParam chunker(this->testFilePath, this->CHUNK_SIZE);
+    EXPECT_EQ(chunker.chunkFile(), this->CHUNK_COUNT);
+    EXPECT_EQ(chunker.getChunkNumber(), this->CHUNK_COUNT);
+    for (int i = 0; i < this->CHUNK_COUNT; ++i) {
+        auto chunk = chunker.getChunk(i);
+        EXPECT_EQ(chunk.getData().size(), chunk.getChunkSize());
+    }
+    EXPECT_EQ(chunker.getChunk(this->CHUNK_COUNT - 1).getChunkSize(), 123);
+    EXPECT_EQ(this->readAll(chunker), this->content);
+}
+
+TYPED_TEST(ChunkSourceTest, GetChunksMatchesGetChunk) {
+    TypeParam chunker(this->testFilePath, 300 * 1024);
+    EXPECT_TRUE(chunker.loadChunks());
+    auto chunks = chunker.getChunks();
+    ASSERT_EQ(chunks.size(), chunker.getChunkNumber());
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        EXPECT_TRUE(std::ranges::equal(chunks[i].getData(), chunker.getChunk(static_cast<int>(i)).getData()));
+    }
+}
+
+TYPED_TEST(ChunkSourceTest, NothingIsCopied) {
+    TypeParam chunker(this->testFilePath, this->CHUNK_SIZE);
+    chunker.chunkFile();
+    EXPECT_TRUE(chunker.getTemporaryDir().empty());
+    EXPECT_EQ(chunker.getChunkFilePath(2), this->testFilePath);
+    EXPECT_TRUE(chunker.removeChunkFiles());
+    EXPECT_TRUE(std::filesystem::exists(this->testFilePath));
+}
+
+TYPED_TEST(ChunkSourceTest, ClearChunksClosesTheFile) {
+    TypeParam chunker(this->testFilePath, this->CHUNK_SIZE);
+    chunker.chunkFile();
+    chunker.clearChunks();
+    EXPECT_EQ(chunker.getChunkNumber(), 0);
+    EXPECT_THROW((void) chunker.getChunk(0), std::runtime_error);
+    EXPECT_TRUE(std::filesystem::exists(this->testFilePath));
+}
+
+TYPED_TEST(ChunkSourceTest, ChunkOutOfRange) {
+    TypeParam chunker(this->testFilePath, this->CHUNK_SIZE);
+    chunker.chunkFile();
+    EXPECT_THROW((void) chunker.getChunk(this->CHUNK_COUNT), std::out_of_range);
+    EXPECT_THROW((void) chunker.getChunk(-1), std::out_of_range);
+}
+
+TYPED_TEST(ChunkSourceTest, ChangedFileIsDetected) {
+    TypeParam chunker(this->testFilePath, this->CHUNK_SIZE);
+    chunker.chunkFile();
+    EXPECT_NO_THROW((void) chunker.getChunk(0));
+
+    std::ofstream testFile(this->testFilePath, std::ios::binary | std::ios::app);
+    testFile << "appended";
+    testFile.close();
+
+    EXPECT_THROW((void) chunker.getChunk(1), TUS::Exceptions::TUSException);
+}
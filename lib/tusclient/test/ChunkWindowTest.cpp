@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "chunk/ChunkBodySource.h"
+#include "chunk/ChunkWindow.h"
+#include "chunk/SourceFileChunker.h"
+#include "chunk/StreamChunker.h"
+#include "chunk/TUSChunk.h"
+#include "exceptions/TUSException.h"
+
+class ChunkWindowTest : public ::testing::Test {
+public:
+    static constexpr int CHUNK_SIZE = 64 * 1024;
+    static constexpr int CHUNK_COUNT = 10;
+
+    void SetUp() override {
+        testFilePath = std::filesystem::temp_directory_path() / "windowfile.bin";
+        content.resize(CHUNK_SIZE * CHUNK_COUNT - 100);
+        for (size_t i = 0; i < content.size(); ++i) {
+            content[i] = static_cast<uint8_t>(i % 253);
+        }
+        std::ofstream testFile(testFilePath, std::ios::binary);
+        testFile.write(reinterpret_cast<const char *>(content.data()), static_cast<std::streamsize>(content.size()));
+        testFile.close();
+        chunker = std::make_unique<TUS::Chunk::SourceFileChunker>(testFilePath, CHUNK_SIZE);
+        chunker->chunkFile();
+    }
+
+    void TearDown() override {
+        chunker.reset();
+        std::filesystem::remove(testFilePath);
+    }
+
+    std::filesystem::path testFilePath;
+    std::vector<uint8_t> content;
+    std::unique_ptr<TUS::Chunk::SourceFileChunker> chunker;
+};
+
+TEST_F(ChunkWindowTest, CapacityFollowsTheMemoryLimit) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 3 * CHUNK_SIZE);
+    EXPECT_EQ(window.getCapacity(), 3);
+
+    TUS::Chunk::ChunkWindow smallWindow(*chunker, content.size(), CHUNK_SIZE / 2);
+    EXPECT_EQ(smallWindow.getCapacity(), 1);
+}
+
+TEST_F(ChunkWindowTest, ReadAheadIsBounded) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 100 * CHUNK_SIZE);
+    EXPECT_EQ(window.getCapacity(), TUS::Chunk::ChunkWindow::DEFAULT_READ_AHEAD + 1);
+
+    TUS::Chunk::ChunkWindow doubleBuffered(*chunker, content.size(), 100 * CHUNK_SIZE, 1);
+    (void) doubleBuffered.get(0);
+    EXPECT_EQ(doubleBuffered.getResidentChunks(), 2);
+}
+
+TEST_F(ChunkWindowTest, BuffersAreReused) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 3 * CHUNK_SIZE);
+    const uint8_t *firstBuffer = window.get(0).getData().data();
+    (void) window.get(2); // the window is full, the chunks read ahead are in memory
+    window.release(CHUNK_SIZE);
+    // the next chunk read ahead goes in the buffer of the confirmed one
+    (void) window.get(1);
+    const auto &chunk = window.get(3);
+    EXPECT_EQ(chunk.getData().data(), firstBuffer);
+    EXPECT_TRUE(std::equal(chunk.getData().begin(), chunk.getData().end(), content.begin() + 3 * CHUNK_SIZE));
+}
+
+TEST_F(ChunkWindowTest, ChunksAreReadAheadWithinTheLimit) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 3 * CHUNK_SIZE);
+    std::vector<uint8_t> uploaded;
+    for (int i = 0; i < CHUNK_COUNT; ++i) {
+        const auto &chunk = window.get(i);
+        EXPECT_LE(window.getResidentChunks(), window.getCapacity());
+        uploaded.insert(uploaded.end(), chunk.getData().begin(), chunk.getData().end());
+        window.release(uploaded.size());
+    }
+    EXPECT_EQ(uploaded, content);
+    EXPECT_EQ(window.getResidentChunks(), 0);
+}
+
+TEST_F(ChunkWindowTest, ChunksAreKeptUntilConfirmed) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 3 * CHUNK_SIZE);
+    (void) window.get(0);
+    EXPECT_EQ(window.getResidentChunks(), 3);
+
+    // the server stored a part of the first chunk, it is still needed
+    window.release(CHUNK_SIZE / 2);
+    EXPECT_EQ(window.getResidentChunks(), 3);
+
+    window.release(2 * CHUNK_SIZE);
+    EXPECT_EQ(window.getResidentChunks(), 1);
+}
+
+TEST_F(ChunkWindowTest, ReleasedChunkIsReadAgain) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 2 * CHUNK_SIZE);
+    (void) window.get(0);
+    window.release(3 * CHUNK_SIZE);
+    const auto &chunk = window.get(1);
+    EXPECT_EQ(window.getResidentChunks(), 2);
+    EXPECT_TRUE(std::equal(chunk.getData().begin(), chunk.getData().end(), content.begin() + CHUNK_SIZE));
+}
+
+TEST_F(ChunkWindowTest, ReadErrorsAreThrownByGet) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 2 * CHUNK_SIZE);
+    EXPECT_THROW((void) window.get(CHUNK_COUNT), std::out_of_range);
+
+    std::ofstream testFile(testFilePath, std::ios::binary | std::ios::app);
+    testFile << "appended";
+    testFile.close();
+    EXPECT_THROW((void) window.get(0), TUS::Exceptions::TUSException);
+}
+
+TEST_F(ChunkWindowTest, StreamSizeIsFoundAtItsEnd) {
+    TUS::Chunk::StreamChunker stream("stream.bin", [this, position = size_t{0}](uint8_t *buffer, size_t size) mutable {
+        const size_t read = std::min(size, content.size() - position);
+        std::copy_n(content.begin() + static_cast<std::ptrdiff_t>(position), read, buffer);
+        position += read;
+        return read;
+    }, CHUNK_SIZE);
+    TUS::Chunk::ChunkWindow window(stream, TUS::Chunk::ChunkWindow::UNKNOWN_SIZE, 2 * CHUNK_SIZE);
+    EXPECT_FALSE(window.getFileSize().has_value());
+    for (int i = 0; i < CHUNK_COUNT - 1; ++i) {
+        (void) window.get(i);
+        window.release(static_cast<uint64_t>(i + 1) * CHUNK_SIZE);
+    }
+    const auto &last = window.get(CHUNK_COUNT - 1);
+    EXPECT_EQ(last.getChunkSize(), CHUNK_SIZE - 100);
+    EXPECT_EQ(window.getFileSize(), content.size());
+}
+
+TEST_F(ChunkWindowTest, TryGetDoesNotWait) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 2 * CHUNK_SIZE);
+    const TUS::Chunk::TUSChunk *chunk = window.tryGet(1);
+    while (chunk == nullptr) {
+        // the reader is still reading it
+        std::this_thread::yield();
+        chunk = window.tryGet(1);
+    }
+    EXPECT_TRUE(std::equal(chunk->getData().begin(), chunk->getData().end(), content.begin() + CHUNK_SIZE));
+}
+
+TEST_F(ChunkWindowTest, BodySourceSpansChunks) {
+    TUS::Chunk::ChunkWindow window(*chunker, content.size(), 3 * CHUNK_SIZE);
+    // the chunks of the whole window, starting and ending inside a chunk
+    const uint64_t offset = CHUNK_SIZE / 2;
+    const uint64_t length = 2 * CHUNK_SIZE;
+    TUS::Chunk::ChunkBodySource body(window, offset, length);
+    EXPECT_EQ(body.size(), length);
+    std::vector<uint8_t> sent(length);
+    uint64_t position = 0;
+    while (position < length) {
+        const size_t read = body.read(position, reinterpret_cast<char *>(sent.data() + position), 16 * 1024);
+        if (read == TUS::Http::IBodySource::PENDING) {
+            // the http client pauses the transfer until the chunk is read
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_GT(read, 0);
+        position += read;
+    }
+    EXPECT_EQ(body.read(length, reinterpret_cast<char *>(sent.data()), 1), 0);
+    EXPECT_TRUE(std::equal(sent.begin(), sent.end(), content.begin() + static_cast<std::ptrdiff_t>(offset)));
+    // the chunks sent are kept until the server confirms them
+    EXPECT_EQ(window.getResidentChunks(), 3);
+
+    // sent again from the start, e.g. after a redirect
+    std::vector<uint8_t> first(100);
+    EXPECT_EQ(body.read(0, reinterpret_cast<char *>(first.data()), first.size()), first.size());
+    EXPECT_TRUE(std::equal(first.begin(), first.end(), content.begin() + static_cast<std::ptrdiff_t>(offset)));
+
+    window.release(offset + length);
+    EXPECT_EQ(window.getResidentChunks(), 1);
+}
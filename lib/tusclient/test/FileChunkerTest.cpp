@@ -107,6 +107,23 @@ TEST_F(FileChunkerTest, GetChunks) {
     chunker->removeChunkFiles();
 }
 
+TEST_F(FileChunkerTest, ChunksShareTheirBytes) {
+    std::unique_ptr<TUS::Chunk::IFileChunker<TUS::Chunk::TUSChunk> > chunker = std::make_unique<
+        TUS::Chunk::FileChunker>("TestApp", "c52cb3d0-2ac4-4eb4-8d3a-2b9919389a2e", testFilePath, 256 * 1024);
+    chunker->chunkFile();
+    chunker->loadChunks();
+    // the loaded chunks are handles, getting them again does not copy the file
+    auto chunks = chunker->getChunks();
+    ASSERT_EQ(chunks.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(chunks[i].getBytes(), chunker->getChunk(i).getBytes());
+        EXPECT_EQ(chunks[i].getData().size(), 256 * 1024);
+        EXPECT_EQ(chunks[i].getData()[0], 'A');
+    }
+
+    chunker->removeChunkFiles();
+}
+
 TEST_F(FileChunkerTest, GetChunkFilePath) {
     std::unique_ptr<TUS::Chunk::IFileChunker<TUS::Chunk::TUSChunk> > chunker = std::make_unique<
         TUS::Chunk::FileChunker>("TestApp", "c52cb3d0-2ac4-4eb4-8d3a-2b9919389a2e", testFilePath);
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ChunkSourceFixture.h"
+#include "chunk/IoUringFileChunker.h"
+#include "chunk/utility/IoUringReader.h"
+
+/* the cases shared with the other chunkers of the source file are in ChunkSourceTest */
+class IoUringFileChunkerTest : public ChunkSourceFixture {
+};
+
+TEST_F(IoUringFileChunkerTest, DirectChunksAreAligned) {
+    // the chunk size is rounded up to the alignment of direct reads
+    TUS::Chunk::IoUringFileChunker chunker(testFilePath, 300 * 1000, true);
+    EXPECT_EQ(chunker.getChunkSize() % 4096, 0);
+    EXPECT_GE(chunker.getChunkSize(), 300 * 1000);
+    chunker.chunkFile();
+    EXPECT_EQ(readAll(chunker), content);
+}
+
+TEST_F(IoUringFileChunkerTest, BuffersAreReused) {
+    TUS::Chunk::IoUringFileChunker chunker(testFilePath, CHUNK_SIZE);
+    chunker.chunkFile();
+    const uint8_t *first = nullptr;
+    {
+        auto chunk = chunker.getChunk(0);
+        first = chunk.getBytes();
+    }
+    auto chunk = chunker.getChunk(1);
+    EXPECT_EQ(chunk.getBytes(), first);
+    EXPECT_TRUE(std::equal(chunk.getBytes(), chunk.getBytes() + chunk.getChunkSize(), content.begin() + CHUNK_SIZE));
+}
+
+TEST_F(IoUringFileChunkerTest, ConcurrentUploadsShareTheReader) {
+    if (TUS::Chunk::Utility::IoUringReader::getShared() == nullptr) {
+        GTEST_SKIP() << "io_uring is not available, the chunks are read with pread";
+    }
+    constexpr int uploads = 8;
+    std::vector<std::filesystem::path> paths;
+    std::vector<std::vector<uint8_t> > contents;
+    for (int i = 0; i < uploads; ++i) {
+        paths.push_back(std::filesystem::temp_directory_path() / ("iouringfile" + std::to_string(i) + ".bin"));
+        contents.push_back(writeFile(paths.back(), 512 * 1024 + i, 241 + i));
+    }
+    std::vector<std::vector<uint8_t> > uploaded(uploads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < uploads; ++i) {
+        threads.emplace_back([&, i] {
+            TUS::Chunk::IoUringFileChunker chunker(paths[i], 64 * 1024, i % 2 == 0);
+            chunker.chunkFile();
+            EXPECT_TRUE(chunker.usesIoUring());
+            uploaded[i] = readAll(chunker);
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    for (int i = 0; i < uploads; ++i) {
+        EXPECT_EQ(uploaded[i], contents[i]);
+        std::filesystem::remove(paths[i]);
+    }
+}
+
+TEST_F(IoUringFileChunkerTest, ChunksOutliveTheChunker) {
+    TUS::Chunk::IoUringFileChunker chunker(testFilePath, CHUNK_SIZE);
+    chunker.chunkFile();
+    auto chunk = chunker.getChunk(2);
+    chunker.clearChunks();
+    // the buffer of a chunk outlives the chunker
+    EXPECT_TRUE(std::equal(chunk.getBytes(), chunk.getBytes() + chunk.getChunkSize(),
+                           content.begin() + 2 * CHUNK_SIZE));
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#ifndef _WIN32
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <fmt/core.h>
+#include "TusClient.h"
+
+namespace TUS::Test {
+    /**
+     * @brief A tus server on the loopback that stores nothing: it checks the offsets of the requests and keeps
+     * the last bytes received, so uploads larger than the disk of the host can be tested. The upload it creates
+     * already holds the bytes before the resume offset.
+     */
+    class TusStandIn {
+    public:
+        explicit TusStandIn(uint64_t resumeOffset) : m_offset(resumeOffset) {
+            m_socket = socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socklen_t length = sizeof(address);
+            if (bind(m_socket, reinterpret_cast<sockaddr *>(&address), length) != 0 || listen(m_socket, 8) != 0 ||
+                getsockname(m_socket, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+                throw std::runtime_error("Unable to listen on the loopback");
+            }
+            m_port = ntohs(address.sin_port);
+            m_acceptor = std::thread([this] { accept(); });
+        }
+
+        ~TusStandIn() {
+            shutdown(m_socket, SHUT_RDWR);
+            m_acceptor.join();
+            {
+                std::lock_guard lock(m_mutex);
+                for (const int connection: m_connections) {
+                    shutdown(connection, SHUT_RDWR);
+                }
+            }
+            for (auto &thread: m_threads) {
+                thread.join();
+            }
+            close(m_socket);
+        }
+
+        [[nodiscard]] std::string getUrl() const {
+            return fmt::format("http://127.0.0.1:{}/files/", m_port);
+        }
+
+        [[nodiscard]] uint64_t getOffset() const { return m_offset; }
+
+        [[nodiscard]] uint64_t getLength() const { return m_length; }
+
+        [[nodiscard]] std::vector<uint64_t> getPatchOffsets() const {
+            std::lock_guard lock(m_mutex);
+            return m_patchOffsets;
+        }
+
+        /**
+         * @brief Get the last bytes of the last PATCH.
+         */
+        [[nodiscard]] std::string getLastBytes() const {
+            std::lock_guard lock(m_mutex);
+            return m_lastBytes;
+        }
+
+    private:
+        void accept() {
+            while (true) {
+                const int connection = ::accept(m_socket, nullptr, nullptr);
+                if (connection < 0) {
+                    return;
+                }
+                std::lock_guard lock(m_mutex);
+                m_connections.push_back(connection);
+                m_threads.emplace_back([this, connection] {
+                    while (serve(connection)) {
+                    }
+                    close(connection);
+                });
+            }
+        }
+
+        static std::string getHeader(std::string_view head, std::string_view name) {
+            for (size_t line = head.find("\r\n"); line != std::string_view::npos; line = head.find("\r\n", line + 2)) {
+                const std::string_view field = head.substr(line + 2, head.find("\r\n", line + 2) - line - 2);
+                if (field.size() > name.size() && field[name.size()] == ':' &&
+                    std::equal(name.begin(), name.end(), field.begin(), [](char a, char b) {
+                        return std::tolower(a) == std::tolower(b);
+                    })) {
+                    const size_t value = field.find_first_not_of(' ', name.size() + 1);
+                    return std::string(field.substr(value));
+                }
+            }
+            return {};
+        }
+
+        /**
+         * @brief Answer a request of the connection, false once it is closed.
+         */
+        bool serve(int connection) {
+            std::string head;
+            char byte;
+            while (head.find("\r\n\r\n") == std::string::npos) {
+                if (recv(connection, &byte, 1, 0) != 1) {
+                    return false;
+                }
+                head.push_back(byte);
+            }
+            const std::string method = head.substr(0, head.find(' '));
+            const std::string contentLength = getHeader(head, "Content-Length");
+            uint64_t remaining = contentLength.empty() ? 0 : std::stoull(contentLength);
+            const uint64_t received = remaining;
+            std::string last;
+            std::vector<char> buffer(64 * 1024);
+            while (remaining > 0) {
+                const ssize_t count = recv(connection, buffer.data(), std::min<uint64_t>(buffer.size(), remaining), 0);
+                if (count <= 0) {
+                    return false;
+                }
+                last.append(buffer.data(), count);
+                last.erase(0, last.size() > 16 ? last.size() - 16 : 0);
+                remaining -= count;
+            }
+
+            std::string response;
+            if (method == "OPTIONS") {
+                response = "HTTP/1.1 204 No Content\r\nTus-Resumable: 1.0.0\r\nTus-Version: 1.0.0\r\n"
+                        "Tus-Extension: creation\r\n\r\n";
+            } else if (method == "POST") {
+                m_length = std::stoull(getHeader(head, "Upload-Length"));
+                response = fmt::format("HTTP/1.1 201 Created\r\nTus-Resumable: 1.0.0\r\nLocation: {}large\r\n"
+                                       "Content-Length: 0\r\n\r\n", getUrl());
+            } else if (method == "HEAD") {
+                response = fmt::format("HTTP/1.1 200 OK\r\nTus-Resumable: 1.0.0\r\nUpload-Offset: {}\r\n"
+                                       "Upload-Length: {}\r\nCache-Control: no-store\r\n\r\n", m_offset.load(),
+                                       m_length.load());
+            } else if (method == "PATCH" && std::stoull(getHeader(head, "Upload-Offset")) == m_offset) {
+                {
+                    std::lock_guard lock(m_mutex);
+                    m_patchOffsets.push_back(m_offset);
+                    m_lastBytes = last;
+                }
+                m_offset += received;
+                response = fmt::format("HTTP/1.1 204 No Content\r\nTus-Resumable: 1.0.0\r\nUpload-Offset: {}\r\n\r\n",
+                                       m_offset.load());
+            } else if (method == "PATCH") {
+                response = "HTTP/1.1 409 Conflict\r\nContent-Length: 0\r\n\r\n";
+            } else {
+                response = "HTTP/1.1 204 No Content\r\nTus-Resumable: 1.0.0\r\n\r\n";
+            }
+            return send(connection, response.data(), response.size(), MSG_NOSIGNAL) ==
+                   static_cast<ssize_t>(response.size());
+        }
+
+        int m_socket;
+        uint16_t m_port;
+        std::atomic<uint64_t> m_offset;
+        std::atomic<uint64_t> m_length{0};
+        mutable std::mutex m_mutex;
+        std::vector<uint64_t> m_patchOffsets;
+        std::string m_lastBytes;
+        std::vector<int> m_connections;
+        std::vector<std::thread> m_threads;
+        std::thread m_acceptor;
+    };
+
+    class LargeUploadTest : public ::testing::Test {
+    public:
+        static constexpr uint64_t FILE_SIZE = 5'000'000'000'000; // 5 TB
+        static constexpr std::string_view END_MARKER = "end of 5 TB";
+
+        void SetUp() override {
+            testFilePath = std::filesystem::temp_directory_path() / "large.bin";
+            try {
+                // sparse, only the marker at its end takes space
+                std::ofstream(testFilePath, std::ios::binary).close();
+                std::filesystem::resize_file(testFilePath, FILE_SIZE);
+            } catch (const std::filesystem::filesystem_error &) {
+                std::filesystem::remove(testFilePath);
+                GTEST_SKIP() << "The file system does not support sparse files of 5 TB";
+            }
+            std::fstream file(testFilePath, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(static_cast<std::streamoff>(FILE_SIZE - END_MARKER.size()));
+            file.write(END_MARKER.data(), static_cast<std::streamsize>(END_MARKER.size()));
+        }
+
+        void TearDown() override {
+            std::filesystem::remove(testFilePath);
+        }
+
+        std::filesystem::path testFilePath;
+    };
+
+    TEST_F(LargeUploadTest, uploadResumesPastTheEndOfA32BitOffset) {
+        // the server already holds the file but its last chunks, the client resumes inside a chunk
+        const int64_t chunkSize = 10'000'000;
+        const uint64_t resumeOffset = FILE_SIZE - 2 * chunkSize - 12345;
+        TusStandIn server(resumeOffset);
+        TUS::TusClient client("testapp", server.getUrl(), testFilePath, Logging::LogLevel::_NONE_);
+        client.upload();
+
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+        EXPECT_EQ(server.getLength(), FILE_SIZE);
+        EXPECT_EQ(server.getOffset(), FILE_SIZE);
+        const std::vector<uint64_t> expectedOffsets = {resumeOffset, FILE_SIZE - 2 * chunkSize, FILE_SIZE - chunkSize};
+        EXPECT_EQ(server.getPatchOffsets(), expectedOffsets);
+        const std::string lastBytes = server.getLastBytes();
+        EXPECT_TRUE(lastBytes.ends_with(END_MARKER));
+    }
+} // namespace TUS::Test
+#endif
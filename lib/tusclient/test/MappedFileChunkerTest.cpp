@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include "ChunkSourceFixture.h"
+#include "chunk/MappedFileChunker.h"
+
+/* the cases shared with the other chunkers of the source file are in ChunkSourceTest */
+class MappedFileChunkerTest : public ChunkSourceFixture {
+};
+
+TEST_F(MappedFileChunkerTest, ChunksAreViewsOfTheFile) {
+    TUS::Chunk::MappedFileChunker chunker(testFilePath, CHUNK_SIZE);
+    chunker.chunkFile();
+    for (int i = 0; i < CHUNK_COUNT; ++i) {
+        EXPECT_EQ(chunker.getChunk(i).getBytes(), chunker.getChunk(i).getBytes()); // the bytes are not copied
+    }
+}
+
+TEST_F(MappedFileChunkerTest, ChunksOutliveTheChunker) {
+    auto chunker = std::make_unique<TUS::Chunk::MappedFileChunker>(testFilePath, CHUNK_SIZE);
+    chunker->chunkFile();
+    auto chunk = chunker->getChunk(1);
+    chunker->clearChunks();
+    chunker.reset();
+    EXPECT_TRUE(std::equal(chunk.getBytes(), chunk.getBytes() + chunk.getChunkSize(), content.begin() + CHUNK_SIZE));
+}
+
+TEST_F(MappedFileChunkerTest, EmptyFileHasOneEmptyChunk) {
+    std::ofstream(testFilePath, std::ios::binary | std::ios::trunc).close();
+    TUS::Chunk::MappedFileChunker chunker(testFilePath, CHUNK_SIZE);
+    EXPECT_EQ(chunker.chunkFile(), 1);
+    EXPECT_EQ(chunker.getChunk(0).getChunkSize(), 0);
+}
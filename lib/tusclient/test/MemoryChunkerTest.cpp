@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "chunk/MemoryChunker.h"
+#include "chunk/TUSChunk.h"
+
+class MemoryChunkerTest : public ::testing::Test {
+public:
+    static constexpr size_t DATA_SIZE = 1024 * 1024 + 123;
+
+    void SetUp() override {
+        data.resize(DATA_SIZE);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<std::byte>(i % 251);
+        }
+    }
+
+    std::vector<std::byte> data;
+};
+
+TEST_F(MemoryChunkerTest, ChunksAreViewsOfTheData) {
+    TUS::Chunk::MemoryChunker chunker("payload.bin", data, 256 * 1024);
+    EXPECT_EQ(chunker.chunkFile(), 5);
+    EXPECT_EQ(chunker.getSize(), DATA_SIZE);
+    EXPECT_EQ(chunker.getChunkFilename(0), "payload.bin");
+
+    for (int i = 0; i < 5; ++i) {
+        const auto chunk = chunker.getChunk(i);
+        // nothing is copied, the chunk points in the data of the caller
+        EXPECT_EQ(static_cast<const void *>(chunk.getData().data()), data.data() + i * 256 * 1024);
+    }
+    EXPECT_EQ(chunker.getChunk(4).getChunkSize(), 123);
+    EXPECT_THROW((void) chunker.getChunk(5), std::out_of_range);
+    EXPECT_THROW((void) chunker.getChunk(-1), std::out_of_range);
+}
+
+TEST_F(MemoryChunkerTest, SmallDataIsASingleChunk) {
+    TUS::Chunk::MemoryChunker chunker("payload.bin", std::span(data).first(1000));
+    EXPECT_EQ(chunker.chunkFile(), 1);
+    EXPECT_EQ(chunker.getChunk(0).getChunkSize(), 1000);
+}
+
+TEST_F(MemoryChunkerTest, OwnerIsHeldByTheChunks) {
+    auto owned = std::make_shared<const std::vector<std::byte> >(data);
+    std::weak_ptr<const std::vector<std::byte> > observer = owned;
+    auto chunker = std::make_unique<TUS::Chunk::MemoryChunker>("payload.bin", *owned, 256 * 1024, owned);
+    owned.reset();
+    const auto chunk = chunker->getChunk(1);
+    chunker.reset();
+    EXPECT_FALSE(observer.expired());
+    EXPECT_EQ(chunk.getData()[0], static_cast<uint8_t>(256 * 1024 % 251));
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "PartialUpload.h"
+#include "chunk/ChunkWindow.h"
+#include "chunk/MemoryChunker.h"
+#include "http/HttpClient.h"
+
+/**
+ * @brief Integration tests of the partial uploads, they need a tus server with the Concatenation extension
+ */
+class PartialUploadTest : public ::testing::Test {
+public:
+    const std::string URL = "http://localhost:8080/files/";
+    static constexpr int CHUNK_SIZE = 256 * 1024;
+
+    void SetUp() override {
+        data.resize(4 * CHUNK_SIZE + 123);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<std::byte>(i % 251);
+        }
+        chunker = std::make_unique<TUS::Chunk::MemoryChunker>("partial.bin", data, CHUNK_SIZE);
+        httpClient = std::make_shared<TUS::Http::HttpClient>();
+    }
+
+    std::vector<std::byte> data;
+    std::unique_ptr<TUS::Chunk::MemoryChunker> chunker;
+    std::shared_ptr<TUS::Http::HttpClient> httpClient;
+};
+
+TEST_F(PartialUploadTest, RangeIsUploadedFromItsStart) {
+    // the last range of the data, the offsets of the requests start at 0
+    const uint64_t start = 2 * CHUNK_SIZE;
+    TUS::PartialUpload partial(httpClient, URL, "partial", *chunker, start, data.size() - start,
+                               TUS::Chunk::ChunkWindow::DEFAULT_MEMORY_LIMIT);
+    partial.create();
+    ASSERT_FALSE(partial.getLocation().empty());
+    EXPECT_EQ(partial.getOffset(), 0);
+
+    const std::atomic status(TUS::TusStatus::UPLOADING);
+    EXPECT_TRUE(partial.upload(status));
+    EXPECT_EQ(partial.getOffset(), data.size() - start);
+    EXPECT_EQ(partial.getBytesInFlight(), 0);
+
+    // the offset of the server is found again
+    TUS::PartialUpload resumed(httpClient, URL, "partial", *chunker, start, data.size() - start,
+                               TUS::Chunk::ChunkWindow::DEFAULT_MEMORY_LIMIT);
+    EXPECT_TRUE(resumed.resume(partial.getLocation()));
+    EXPECT_EQ(resumed.getOffset(), data.size() - start);
+}
+
+TEST_F(PartialUploadTest, EachStepSendsOneChunk) {
+    TUS::PartialUpload partial(httpClient, URL, "partial", *chunker, 0, 2 * CHUNK_SIZE,
+                               TUS::Chunk::ChunkWindow::DEFAULT_MEMORY_LIMIT);
+    partial.create();
+    const std::atomic status(TUS::TusStatus::UPLOADING);
+    EXPECT_TRUE(partial.uploadNextChunk(status));
+    EXPECT_EQ(partial.getOffset(), CHUNK_SIZE);
+    EXPECT_FALSE(partial.uploadNextChunk(status));
+    EXPECT_EQ(partial.getOffset(), 2 * CHUNK_SIZE);
+    // a stored range sends nothing
+    EXPECT_FALSE(partial.uploadNextChunk(status));
+}
+
+TEST_F(PartialUploadTest, RangeIsNotSentWhileNotUploading) {
+    TUS::PartialUpload partial(httpClient, URL, "partial", *chunker, 0, 2 * CHUNK_SIZE,
+                               TUS::Chunk::ChunkWindow::DEFAULT_MEMORY_LIMIT);
+    partial.create();
+    const std::atomic status(TUS::TusStatus::PAUSED);
+    EXPECT_FALSE(partial.upload(status));
+    EXPECT_EQ(partial.getOffset(), 0);
+}
+
+TEST_F(PartialUploadTest, UnknownUploadIsNotResumed) {
+    TUS::PartialUpload partial(httpClient, URL, "partial", *chunker, 0, CHUNK_SIZE,
+                               TUS::Chunk::ChunkWindow::DEFAULT_MEMORY_LIMIT);
+    EXPECT_FALSE(partial.resume(URL + "unknown"));
+    EXPECT_TRUE(partial.getLocation().empty());
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include "ChunkSourceFixture.h"
+#include "chunk/SourceFileChunker.h"
+#include "exceptions/TUSException.h"
+
+/* the cases shared with the other chunkers of the source file are in ChunkSourceTest */
+class SourceFileChunkerTest : public ChunkSourceFixture {
+};
+
+TEST_F(SourceFileChunkerTest, DefaultChunkSizeUploadsSmallFilesWhole) {
+    TUS::Chunk::SourceFileChunker chunker(testFilePath);
+    EXPECT_EQ(chunker.chunkFile(), 1);
+    EXPECT_EQ(chunker.getChunkSize(), FILE_SIZE);
+    EXPECT_TRUE(std::ranges::equal(chunker.getChunk(0).getData(), content));
+}
+
+TEST_F(SourceFileChunkerTest, RewrittenFileIsDetected) {
+    TUS::Chunk::SourceFileChunker chunker(testFilePath, CHUNK_SIZE);
+    chunker.chunkFile();
+
+    // same size, only the last write time tells that the content changed
+    std::fstream testFile(testFilePath, std::ios::binary | std::ios::in | std::ios::out);
+    testFile.seekp(10);
+    testFile.put('X');
+    testFile.close();
+    std::filesystem::last_write_time(testFilePath,
+                                     std::filesystem::last_write_time(testFilePath) + std::chrono::seconds(1));
+
+    EXPECT_THROW((void) chunker.getChunk(0), TUS::Exceptions::TUSException);
+}
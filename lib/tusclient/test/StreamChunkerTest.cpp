@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "chunk/StreamChunker.h"
+#include "chunk/TUSChunk.h"
+#include "exceptions/TUSException.h"
+
+class StreamChunkerTest : public ::testing::Test {
+public:
+    static constexpr int CHUNK_SIZE = 64 * 1024;
+
+    void SetUp() override {
+        content.resize(3 * CHUNK_SIZE + 123);
+        for (size_t i = 0; i < content.size(); ++i) {
+            content[i] = static_cast<uint8_t>(i % 251);
+        }
+    }
+
+    /**
+     * @brief A reader that returns the content in small and irregular parts, like a pipe.
+     */
+    TUS::Chunk::StreamReader readContent(size_t length) {
+        return [this, length, position = size_t{0}, call = size_t{0}](uint8_t *buffer, size_t size) mutable {
+            const size_t read = std::min({size, length - position, 1000 + (call++ % 7) * 300});
+            std::copy_n(content.begin() + static_cast<std::ptrdiff_t>(position), read, buffer);
+            position += read;
+            return read;
+        };
+    }
+
+    static std::vector<uint8_t> readAll(const TUS::Chunk::StreamChunker &chunker) {
+        std::vector<uint8_t> uploaded;
+        for (int i = 0; !chunker.hasEnded(); ++i) {
+            const auto chunk = chunker.getChunk(i);
+            uploaded.insert(uploaded.end(), chunk.getData().begin(), chunk.getData().end());
+        }
+        return uploaded;
+    }
+
+    std::vector<uint8_t> content;
+};
+
+TEST_F(StreamChunkerTest, ChunksAreReadInOrder) {
+    TUS::Chunk::StreamChunker chunker("stream.bin", readContent(content.size()), CHUNK_SIZE);
+    EXPECT_EQ(chunker.chunkFile(), 0);
+    EXPECT_EQ(chunker.getChunkSize(), CHUNK_SIZE);
+
+    // the chunks are filled across the short reads of the stream
+    EXPECT_EQ(chunker.getChunk(0).getChunkSize(), CHUNK_SIZE);
+    EXPECT_THROW((void) chunker.getChunk(0), std::out_of_range);
+    EXPECT_THROW((void) chunker.getChunk(2), std::out_of_range);
+    EXPECT_EQ(chunker.getChunk(1).getChunkSize(), CHUNK_SIZE);
+    EXPECT_EQ(chunker.getChunk(2).getChunkSize(), CHUNK_SIZE);
+    EXPECT_FALSE(chunker.hasEnded());
+
+    const auto last = chunker.getChunk(3);
+    EXPECT_EQ(last.getChunkSize(), 123);
+    EXPECT_TRUE(std::equal(last.getData().begin(), last.getData().end(), content.begin() + 3 * CHUNK_SIZE));
+    EXPECT_TRUE(chunker.hasEnded());
+    EXPECT_EQ(chunker.getChunkNumber(), 4);
+    EXPECT_EQ(chunker.getChunk(4).getChunkSize(), 0);
+}
+
+TEST_F(StreamChunkerTest, StreamEndingOnAChunkBoundary) {
+    TUS::Chunk::StreamChunker chunker("stream.bin", readContent(2 * CHUNK_SIZE), CHUNK_SIZE);
+    const auto uploaded = readAll(chunker);
+    EXPECT_EQ(chunker.getChunkNumber(), 3);
+    EXPECT_EQ(uploaded.size(), 2 * CHUNK_SIZE);
+    EXPECT_TRUE(std::equal(uploaded.begin(), uploaded.end(), content.begin()));
+}
+
+TEST_F(StreamChunkerTest, StandardStreamIsRead) {
+    std::istringstream stream(std::string(content.begin(), content.end()));
+    TUS::Chunk::StreamChunker chunker("stream.bin", TUS::Chunk::StreamChunker::readStream(stream), CHUNK_SIZE);
+    EXPECT_EQ(readAll(chunker), content);
+}
+
+TEST_F(StreamChunkerTest, ReadErrorsAreThrown) {
+    TUS::Chunk::StreamChunker chunker("stream.bin", [](uint8_t *, size_t) -> size_t {
+        throw TUS::Exceptions::TUSException("broken stream");
+    }, CHUNK_SIZE);
+    EXPECT_THROW((void) chunker.getChunk(0), TUS::Exceptions::TUSException);
+}
+
+#ifndef _WIN32
+TEST_F(StreamChunkerTest, PipeIsRead) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::thread producer([this, fd = fds[1]]() {
+        for (size_t written = 0; written < content.size();) {
+            const ssize_t result = write(fd, content.data() + written, std::min<size_t>(4096, content.size() - written));
+            ASSERT_GT(result, 0);
+            written += static_cast<size_t>(result);
+        }
+        close(fd);
+    });
+    TUS::Chunk::StreamChunker chunker("stream.bin", TUS::Chunk::StreamChunker::readFileDescriptor(fds[0]),
+                                      CHUNK_SIZE);
+    EXPECT_EQ(readAll(chunker), content);
+    producer.join();
+    close(fds[0]);
+}
+#endif
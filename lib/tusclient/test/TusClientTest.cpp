@@ -4,15 +4,22 @@
  * See the LICENSE file in the project root for more information.
  */
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <random>
+#include <sstream>
 #include <libzippp/libzippp.h>
 #include <filesystem>
 #include <thread>
 #include <chrono>
+#include <vector>
 #include <fmt/core.h>
 #include "TusClient.h"
+#include "chunk/IFileChunker.h"
+#include "chunk/StreamChunker.h"
+#include "http/HttpClient.h"
+#include "http/RateLimiter.h"
 
 /**
  * @brief Integration tests for the TusClient class
@@ -121,6 +128,31 @@ namespace TUS::Test {
         EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
     }
 
+    TEST_F(TusClientTest, bytesInFlightTest) {
+        auto path = generateTestFile(10);
+        TUS::TusClient client("testapp", URL, path, logLevel);
+        EXPECT_EQ(client.getBytesInFlight(), 0);
+        std::atomic<bool> done{false};
+        float lastProgress = 0;
+        bool monotonic = true;
+        std::thread watcher([&]() {
+            while (!done.load()) {
+                const float progress = client.progress();
+                monotonic = monotonic && progress >= lastProgress;
+                lastProgress = progress;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        client.upload();
+        done.store(true);
+        watcher.join();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_TRUE(monotonic);
+        EXPECT_EQ(client.getBytesInFlight(), 0);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+        EXPECT_GE(client.getUploadSpeed(), 0);
+    }
+
     TEST_F(TusClientTest, pauseTest) {
         auto path = generateTestFile(10);
         TUS::TusClient client("testapp", URL, path, logLevel);
@@ -163,6 +195,144 @@ namespace TUS::Test {
                   "creation,creation-with-upload,termination,concatenation,creation-defer-length");
     }
 
+    TEST_F(TusClientTest, creationWithUploadSingleRequestTest) {
+        auto path = generateSimpleFile();
+        {
+            // the first upload asks the server for its extensions
+            TUS::TusClient client("testapp", URL, path, logLevel);
+            client.upload();
+            EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        }
+        auto httpClient = std::make_shared<TUS::Http::HttpClient>();
+        TUS::TusClient client("testapp", URL, path, httpClient, 0, logLevel);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+        // the file is smaller than a chunk, it is sent by the POST that creates the upload
+        const auto stats = httpClient->getConnectionStats();
+        EXPECT_EQ(stats.newConnections + stats.reusedConnections, 1);
+    }
+
+    TEST_F(TusClientTest, creationWithUploadManyChunksTest) {
+        auto path = generateTestFile(3);
+        const auto fileSize = std::filesystem::file_size(path);
+        auto httpClient = std::make_shared<TUS::Http::HttpClient>();
+        TUS::TusClient client("testapp", URL, path, httpClient, 1024 * 1024, logLevel);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        // OPTIONS at most once, then the POST carries the first chunk and a PATCH sends each other chunk
+        const auto stats = httpClient->getConnectionStats();
+        const uint64_t chunkCount = (fileSize + 1024 * 1024 - 1) / (1024 * 1024);
+        EXPECT_LE(stats.newConnections + stats.reusedConnections, chunkCount + 1);
+    }
+
+    TEST_F(TusClientTest, streamUploadTest) {
+        // a producer of unknown length, its chunks are sent before it ends
+        const size_t length = 3 * 1024 * 1024 + 4567;
+        size_t produced = 0;
+        auto reader = [&produced, length](uint8_t *buffer, size_t size) {
+            const size_t read = std::min({size, length - produced, size_t{100 * 1024}});
+            for (size_t i = 0; i < read; ++i) {
+                buffer[i] = static_cast<uint8_t>((produced + i) % 251);
+            }
+            produced += read;
+            return read;
+        };
+        TUS::TusClient client("testapp", URL, "stream.bin", reader, 1024 * 1024, logLevel);
+        EXPECT_EQ(client.getFilePath(), "stream.bin");
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+        EXPECT_EQ(produced, length);
+        EXPECT_FALSE(client.retry());
+    }
+
+    TEST_F(TusClientTest, streamEndingOnAChunkBoundaryTest) {
+        std::istringstream stream(std::string(2 * 1024 * 1024, 'x'));
+        TUS::TusClient client("testapp", URL, "stream.bin", TUS::Chunk::StreamChunker::readStream(stream),
+                              1024 * 1024, logLevel);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
+    TEST_F(TusClientTest, shortStreamUploadTest) {
+        // the stream fits in the first chunk, its length is known when the upload is created
+        std::istringstream stream("a short stream");
+        TUS::TusClient client("testapp", URL, "stream.txt", TUS::Chunk::StreamChunker::readStream(stream), 0,
+                              logLevel);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
+    TEST_F(TusClientTest, memoryUploadTest) {
+        // a payload produced in memory is uploaded without a file
+        std::vector<std::byte> payload(3 * 1024 * 1024 + 4567);
+        for (size_t i = 0; i < payload.size(); ++i) {
+            payload[i] = static_cast<std::byte>(i % 251);
+        }
+        TUS::TusClient client("testapp", URL, "payload.bin", payload, 1024 * 1024, logLevel);
+        EXPECT_EQ(client.getChunkSourceType(), TUS::Chunk::ChunkSourceType::_MEMORY);
+        client.setChunkSourceType(TUS::Chunk::ChunkSourceType::_MEMORY_MAPPED);
+        EXPECT_EQ(client.getChunkSourceType(), TUS::Chunk::ChunkSourceType::_MEMORY);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+        EXPECT_FALSE(std::filesystem::exists("payload.bin"));
+    }
+
+    TEST_F(TusClientTest, temporaryFilesChunkSourceTest) {
+        auto path = generateTestFile(3);
+        TUS::TusClient client("testapp", URL, path, 1024 * 1024, logLevel);
+        EXPECT_EQ(client.getChunkSourceType(), TUS::Chunk::ChunkSourceType::_SOURCE_FILE);
+        client.setChunkSourceType(TUS::Chunk::ChunkSourceType::_TEMPORARY_FILES);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+    }
+
+    TEST_F(TusClientTest, memoryMappedChunkSourceTest) {
+        auto path = generateTestFile(3);
+        TUS::TusClient client("testapp", URL, path, 1024 * 1024, logLevel);
+        client.setChunkSourceType(TUS::Chunk::ChunkSourceType::_MEMORY_MAPPED);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
+    TEST_F(TusClientTest, ioUringChunkSourceTest) {
+        auto path = generateTestFile(3);
+        TUS::TusClient client("testapp", URL, path, 1024 * 1024, logLevel);
+        client.setChunkSourceType(TUS::Chunk::ChunkSourceType::_IO_URING_DIRECT);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
+    TEST_F(TusClientTest, adaptiveChunkSizeTest) {
+        auto path = generateTestFile(10);
+        TUS::TusClient client("testapp", URL, path, 256 * 1024, logLevel);
+        EXPECT_EQ(client.getNextRequestSize(), 256 * 1024);
+        client.setAdaptiveChunkSize(std::chrono::milliseconds(500), 3 * 1024 * 1024);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+        // a local server is fast, the requests grow up to the limit
+        EXPECT_GT(client.getNextRequestSize(), 256 * 1024);
+        EXPECT_LE(client.getNextRequestSize(), 3 * 1024 * 1024);
+    }
+
+    TEST_F(TusClientTest, chunkMemoryLimitTest) {
+        auto path = generateTestFile(3);
+        TUS::TusClient client("testapp", URL, path, 256 * 1024, logLevel);
+        // a single chunk in memory, the file is larger than the limit
+        client.setChunkMemoryLimit(256 * 1024);
+        EXPECT_EQ(client.getChunkMemoryLimit(), 256 * 1024);
+        client.upload();
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
     TEST_F(TusClientTest, cancelUpload) {
         auto path = generateTestFile(10);
         TUS::TusClient client("testapp", URL, path, logLevel);
@@ -191,6 +361,147 @@ namespace TUS::Test {
         EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
     }
 
+    TEST_F(TusClientTest, maxUploadSpeedTest) {
+        auto path = generateTestFile(1);
+        TUS::TusClient client("testapp", URL, path, 256 * 1024, logLevel);
+        client.setMaxUploadSpeed(256 * 1024);
+        EXPECT_EQ(client.getMaxUploadSpeed(), 256 * 1024);
+
+        const auto start = std::chrono::steady_clock::now();
+        std::thread upload([&client] { client.upload(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        // about half a second of the limit has been sent
+        EXPECT_LT(client.progress(), 50);
+        EXPECT_GT(client.getRateLimiter()->getAcquiredBytes(), 0);
+
+        // the limit is removed while the upload runs
+        client.setMaxUploadSpeed(0);
+        upload.join();
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(3));
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_EQ(client.getRateLimiter()->getAcquiredBytes(), 1024 * 1024);
+    }
+
+    TEST_F(TusClientTest, uploadNextChunkTest) {
+        auto path = generateTestFile(3);
+        TUS::TusClient client("testapp", URL, path, 1024 * 1024, logLevel);
+        EXPECT_TRUE(client.start());
+        EXPECT_EQ(client.status(), TUS::TusStatus::READY);
+
+        // each call sends one chunk, they can be sent from different threads
+        int requests = 0;
+        bool next = true;
+        while (next) {
+            std::thread([&client, &next] { next = client.uploadNextChunk(); }).join();
+            ++requests;
+        }
+        EXPECT_GT(requests, 1);
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
+    TEST_F(TusClientTest, parallelUploadTest) {
+        auto path = generateTestFile(10);
+        TUS::TusClient client("testapp", URL, path, logLevel);
+        client.setParallelUploads(4);
+        EXPECT_EQ(client.getParallelUploads(), 4);
+
+        EXPECT_TRUE(client.upload());
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+        EXPECT_EQ(client.getBytesInFlight(), 0);
+    }
+
+    TEST_F(TusClientTest, uploadNextPartialChunkTest) {
+        auto path = generateTestFile(10);
+        TUS::TusClient client("testapp", URL, path, logLevel);
+        client.setParallelUploads(3);
+        EXPECT_TRUE(client.start());
+        ASSERT_EQ(client.getPartialUploads(), 3);
+
+        // the ranges take turns, each call sends one request of its range
+        std::vector<bool> sending(client.getPartialUploads(), true);
+        while (std::ranges::find(sending, true) != sending.end()) {
+            for (size_t i = 0; i < sending.size(); ++i) {
+                if (sending[i]) {
+                    std::thread([&client, &sending, i] { sending[i] = client.uploadNextPartialChunk(i); }).join();
+                }
+            }
+        }
+        EXPECT_EQ(client.status(), TUS::TusStatus::UPLOADING);
+        EXPECT_TRUE(client.finishPartials());
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_EQ(client.getPartialUploads(), 0);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
+    TEST_F(TusClientTest, parallelPauseResumeTest) {
+        auto path = generateTestFile(10);
+        TUS::TusClient client("testapp", URL, path, logLevel);
+        client.setParallelUploads(3);
+
+        std::thread uploadThread([&client]() { client.upload(); });
+        waitUpload(client, 10);
+        client.pause();
+        uploadThread.join();
+
+        EXPECT_EQ(client.status(), TUS::TusStatus::PAUSED);
+        float progress = client.progress();
+        EXPECT_LT(progress, 100);
+        EXPECT_TRUE(client.resume());
+
+        EXPECT_EQ(client.status(), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(client.progress(), 100);
+    }
+
+    TEST_F(TusClientTest, parallelCancelTest) {
+        auto path = generateTestFile(10);
+        TUS::TusClient client("testapp", URL, path, logLevel);
+        client.setParallelUploads(2);
+
+        std::thread uploadThread([&client]() { client.upload(); });
+        waitUpload(client, 10);
+        client.cancel();
+        uploadThread.join();
+
+        EXPECT_EQ(client.status(), TUS::TusStatus::CANCELED);
+    }
+
+    TEST_F(TusClientTest, sharedHttpClientUploadTest) {
+        auto path = generateTestFile(10);
+        std::filesystem::copy_file(path, "test_shared.zip", std::filesystem::copy_options::overwrite_existing);
+        auto httpClient = std::make_shared<TUS::Http::HttpClient>();
+        TUS::TusClient first("testapp", URL, path, httpClient, 0, logLevel);
+        TUS::TusClient second("testapp", URL, "test_shared.zip", httpClient, 0, logLevel);
+
+        std::thread firstThread([&first]() { first.upload(); });
+        std::thread secondThread([&second]() { second.upload(); });
+        firstThread.join();
+        secondThread.join();
+        std::filesystem::remove("test_shared.zip");
+
+        EXPECT_EQ(first.status(), TUS::TusStatus::FINISHED);
+        EXPECT_EQ(second.status(), TUS::TusStatus::FINISHED);
+    }
+
+    TEST_F(TusClientTest, sharedTransportContextUploadTest) {
+        auto path = generateTestFile(10);
+        std::filesystem::copy_file(path, "test_context.zip", std::filesystem::copy_options::overwrite_existing);
+        auto context = std::make_shared<TUS::Http::TransportContext>();
+        TUS::TusClient first("testapp", URL, path, context, 0, logLevel);
+        TUS::TusClient second("testapp", URL, "test_context.zip", context, 0, logLevel);
+
+        std::thread firstThread([&first]() { first.upload(); });
+        std::thread secondThread([&second]() { second.upload(); });
+        firstThread.join();
+        secondThread.join();
+        std::filesystem::remove("test_context.zip");
+
+        EXPECT_EQ(first.status(), TUS::TusStatus::FINISHED);
+        EXPECT_EQ(second.status(), TUS::TusStatus::FINISHED);
+        EXPECT_GT(context->getConnectionStats().reusedConnections, 0);
+    }
+
     TEST_F(TusClientTest, sanitizeUrl) {
         TUS::TusClient client("testapp", "http://test.com", generateSimpleFile());
         EXPECT_EQ(client.getUrl(), "http://test.com/");
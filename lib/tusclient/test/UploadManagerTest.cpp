@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fmt/core.h>
+#include "UploadManager.h"
+#include "exceptions/TUSException.h"
+
+/**
+ * @brief Integration tests of the upload manager, they need a tus server
+ */
+class UploadManagerTest : public ::testing::Test {
+public:
+    const std::string URL = "http://localhost:8080/files/";
+    static constexpr int FILE_COUNT = 6;
+
+    void SetUp() override {
+        std::mt19937 gen(42);
+        for (int i = 0; i < FILE_COUNT; ++i) {
+            std::vector<char> data(1024 * 1024 + i * 4096);
+            std::ranges::generate(data, [&gen] { return static_cast<char>(gen()); });
+            files.push_back(std::filesystem::temp_directory_path() / fmt::format("manager{}.bin", i));
+            std::ofstream(files.back(), std::ios::binary).write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+    }
+
+    void TearDown() override {
+        for (const auto &file: files) {
+            std::filesystem::remove(file);
+        }
+    }
+
+    /**
+     * @brief Wait for the uploads while sampling the number running at once
+     */
+    static size_t waitSampling(TUS::UploadManager &manager) {
+        std::atomic<bool> done{false};
+        size_t maxRunning = 0;
+        std::thread sampler([&] {
+            while (!done.load()) {
+                maxRunning = std::max(maxRunning, manager.getRunningUploads());
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        });
+        manager.wait();
+        done.store(true);
+        sampler.join();
+        return maxRunning;
+    }
+
+    /**
+     * @brief Add an upload of small chunks holding the only slot of a manager until it is canceled, the next
+     * uploads stay queued
+     */
+    TUS::UploadManager::JobId addBlocker(TUS::UploadManager &manager) const {
+        return manager.add(URL, files[FILE_COUNT - 1], 4 * 1024, TUS::UploadPriority::INTERACTIVE);
+    }
+
+    std::vector<std::filesystem::path> files;
+};
+
+TEST_F(UploadManagerTest, UploadsRunOnABoundedPool) {
+    TUS::UploadManager manager("testapp", 2);
+    std::vector<TUS::UploadManager::JobId> ids;
+    for (const auto &file: files) {
+        ids.push_back(manager.add(URL, file, 256 * 1024));
+    }
+
+    EXPECT_LE(waitSampling(manager), 2);
+    for (const auto id: ids) {
+        EXPECT_EQ(manager.status(id), TUS::TusStatus::FINISHED);
+        EXPECT_FLOAT_EQ(manager.progress(id), 100);
+    }
+    EXPECT_FLOAT_EQ(manager.progress(), 100);
+    EXPECT_EQ(manager.getQueuedUploads(), 0);
+}
+
+TEST_F(UploadManagerTest, UploadsTakeTurnsOnTheWorkers) {
+    // more uploads running than workers, their chunks are interleaved
+    TUS::UploadManager manager("testapp", 2);
+    manager.setMaxConcurrentUploads(FILE_COUNT);
+    std::vector<TUS::UploadManager::JobId> ids;
+    for (const auto &file: files) {
+        ids.push_back(manager.add(URL, file, 256 * 1024));
+    }
+    EXPECT_GT(manager.getRunningUploads(), 2);
+    manager.wait();
+
+    for (const auto id: ids) {
+        EXPECT_EQ(manager.status(id), TUS::TusStatus::FINISHED);
+    }
+    EXPECT_FLOAT_EQ(manager.progress(), 100);
+}
+
+TEST_F(UploadManagerTest, RangesOfParallelUploadsRunOnTheWorkers) {
+    // the ranges are steps of the scheduler, the pool does not grow with them
+    TUS::UploadManager manager("testapp", 2);
+    manager.setParallelUploads(4);
+    EXPECT_EQ(manager.getParallelUploads(), 4);
+    std::vector<TUS::UploadManager::JobId> ids;
+    for (int i = 0; i < 3; ++i) {
+        ids.push_back(manager.add(URL, files[i], 128 * 1024));
+    }
+
+    EXPECT_LE(waitSampling(manager), 2);
+    for (const auto id: ids) {
+        EXPECT_EQ(manager.status(id), TUS::TusStatus::FINISHED);
+    }
+    EXPECT_FLOAT_EQ(manager.progress(), 100);
+}
+
+TEST_F(UploadManagerTest, UploadsToAHostAreLimited) {
+    TUS::UploadManager manager("testapp", 4);
+    manager.setMaxUploadsPerHost(1);
+    for (const auto &file: files) {
+        manager.add(URL, file, 256 * 1024);
+    }
+
+    EXPECT_EQ(waitSampling(manager), 1);
+    EXPECT_FLOAT_EQ(manager.progress(), 100);
+}
+
+TEST_F(UploadManagerTest, InteractiveUploadsPreemptBulkOnes) {
+    TUS::UploadManager manager("testapp", 1);
+    const auto bulk = manager.add(URL, files[0], 64 * 1024, TUS::UploadPriority::BULK);
+    const auto interactive = manager.add(URL, files[1], 256 * 1024, TUS::UploadPriority::INTERACTIVE);
+    manager.wait();
+
+    // the bulk upload is paused after its current chunk, it starts again once the interactive one finished
+    EXPECT_EQ(manager.getPreemptions(), 1);
+    EXPECT_EQ(manager.getQueueingDelay(TUS::UploadPriority::BULK).uploads, 2);
+    EXPECT_EQ(manager.getQueueingDelay(TUS::UploadPriority::INTERACTIVE).uploads, 1);
+    EXPECT_EQ(manager.status(interactive), TUS::TusStatus::FINISHED);
+    EXPECT_EQ(manager.status(bulk), TUS::TusStatus::FINISHED);
+    EXPECT_FLOAT_EQ(manager.progress(), 100);
+}
+
+TEST_F(UploadManagerTest, UploadsStartByPriorityThenDeadline) {
+    TUS::UploadManager manager("testapp", 1);
+    const auto blocker = addBlocker(manager);
+    const auto now = std::chrono::system_clock::now();
+    const auto bulk = manager.add(URL, files[0], 256 * 1024, TUS::UploadPriority::BULK, now + std::chrono::minutes(1));
+    const auto late = manager.add(URL, files[1], 256 * 1024, TUS::UploadPriority::NORMAL, now + std::chrono::hours(3));
+    const auto none = manager.add(URL, files[2], 256 * 1024, TUS::UploadPriority::NORMAL);
+    const auto soon = manager.add(URL, files[3], 256 * 1024, TUS::UploadPriority::NORMAL, now + std::chrono::hours(1));
+    const auto interactive = manager.add(URL, files[4], 256 * 1024, TUS::UploadPriority::INTERACTIVE);
+
+    // one upload at a time, they finish in the order they start
+    std::vector<TUS::UploadManager::JobId> order;
+    const auto sample = [&] {
+        for (const auto id: {bulk, late, none, soon, interactive}) {
+            if (manager.status(id) == TUS::TusStatus::FINISHED && std::ranges::find(order, id) == order.end()) {
+                order.push_back(id);
+            }
+        }
+    };
+    std::atomic<bool> done{false};
+    std::thread sampler([&] {
+        while (!done.load()) {
+            sample();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+    EXPECT_TRUE(manager.cancel(blocker));
+    manager.wait();
+    done.store(true);
+    sampler.join();
+    sample();
+
+    EXPECT_EQ(order, (std::vector{interactive, soon, late, none, bulk}));
+    EXPECT_EQ(manager.getPreemptions(), 0);
+    EXPECT_EQ(manager.getQueueingDelay(TUS::UploadPriority::NORMAL).uploads, 3);
+    EXPECT_GT(manager.getQueueingDelay(TUS::UploadPriority::BULK).max,
+              manager.getQueueingDelay(TUS::UploadPriority::INTERACTIVE).max);
+}
+
+TEST_F(UploadManagerTest, QueueIsBounded) {
+    TUS::UploadManager manager("testapp", 1);
+    const auto blocker = addBlocker(manager);
+    manager.setMaxQueuedUploads(2);
+    const auto first = manager.add(URL, files[0]);
+    const auto second = manager.add(URL, files[1]);
+    EXPECT_THROW(manager.add(URL, files[2]), TUS::Exceptions::TUSException);
+    EXPECT_EQ(manager.status(first), TUS::TusStatus::READY);
+    EXPECT_EQ(manager.getQueuedUploads(), 2);
+
+    EXPECT_TRUE(manager.cancel(first));
+    EXPECT_EQ(manager.status(first), TUS::TusStatus::CANCELED);
+    EXPECT_TRUE(manager.cancel(blocker));
+    manager.wait();
+
+    EXPECT_EQ(manager.status(second), TUS::TusStatus::FINISHED);
+    EXPECT_FALSE(manager.cancel(second));
+    // the canceled upload is not counted
+    EXPECT_FLOAT_EQ(manager.progress(), 100);
+}
+
+TEST_F(UploadManagerTest, UnknownUploadsAreRejected) {
+    TUS::UploadManager manager("testapp");
+    EXPECT_THROW(manager.add(URL, "missing.bin"), TUS::Exceptions::TUSException);
+    EXPECT_THROW((void) manager.status(42), std::out_of_range);
+}
+
+TEST_F(UploadManagerTest, NoConcurrentUploadIsRejected) {
+    EXPECT_THROW(TUS::UploadManager("testapp", 0), std::invalid_argument);
+    TUS::UploadManager manager("testapp", 1);
+    EXPECT_THROW(manager.setMaxConcurrentUploads(0), std::invalid_argument);
+    EXPECT_EQ(manager.getMaxConcurrentUploads(), 1);
+}
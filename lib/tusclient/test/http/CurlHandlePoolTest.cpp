@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <gtest/gtest.h>
+#include "http/CurlHandlePool.h"
+
+namespace TUS::Test::Http {
+    using TUS::Http::CurlHandlePool;
+
+    TEST(CurlHandlePoolTest, ReleasedHandleIsReused) {
+        CurlHandlePool pool;
+        CURL *first = pool.acquire();
+        ASSERT_NE(first, nullptr);
+        pool.release(first);
+        EXPECT_EQ(pool.getIdleHandles(), 1);
+
+        CURL *second = pool.acquire();
+        EXPECT_EQ(second, first);
+        EXPECT_EQ(pool.getIdleHandles(), 0);
+        pool.release(second);
+    }
+
+    TEST(CurlHandlePoolTest, IdleHandlesAreBounded) {
+        CurlHandlePool pool(2);
+        CURL *first = pool.acquire();
+        CURL *second = pool.acquire();
+        CURL *third = pool.acquire();
+        EXPECT_NE(first, second);
+        EXPECT_NE(second, third);
+        pool.release(first);
+        pool.release(second);
+        pool.release(third);
+        EXPECT_EQ(pool.getIdleHandles(), 2);
+    }
+} // namespace TUS::Test::Http
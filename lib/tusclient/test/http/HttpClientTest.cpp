@@ -4,16 +4,40 @@
  * See the LICENSE file in the project root for more information.
  */
 #include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <functional>
+#include <vector>
+#include <curl/curl.h>
 #include <gtest/gtest.h>
 #include <iostream>
 #include "http/HttpClient.h"
+#include "http/RateLimiter.h"
 #include "http/Request.h"
 
 namespace TUS::Test::Http {
     using TUS::Http::HttpClient;
     using TUS::Http::HttpMethod;
     using TUS::Http::Request;
+    using TUS::Http::Response;
+
+    /**
+     * @brief Tells why prior-knowledge h2c cannot be tested against the nginx container, or an empty string.
+     *
+     * Before libcurl 8.1.0, reusing an h2c connection fails with
+     * "Error in the HTTP2 framing layer", so the multiplexing tests cannot pass.
+     */
+    static std::string h2cSkipReason() {
+        const curl_version_info_data *info = curl_version_info(CURLVERSION_NOW);
+        if (!(info->features & CURL_VERSION_HTTP2)) {
+            return "libcurl is built without HTTP/2 support";
+        }
+        if (info->version_num < 0x080100) {
+            return std::string("libcurl ") + info->version + " cannot reuse a prior-knowledge h2c connection";
+        }
+        return {};
+    }
 
     TEST(HttpClientTest, ConvertHttpMethodToString) {
         HttpClient httpClient;
@@ -42,17 +66,17 @@ namespace TUS::Test::Http {
 
         std::unique_ptr<HttpClient> m_httpClient= nullptr;
         const int m_timeout = 2; //seconds
+        const std::string H2C_URL = "http://localhost:8081/files"; // HTTP/2 without TLS
     };
 
     TEST_P(HttpClientParameterizedTest, HttpRequest) {
         const TestParams &testCase = GetParam();
         std::string finalResult;
 
-        std::function<void(std::string, std::string)> onDataReceivedCallback = [&finalResult
-                ](const std::string &header, const std::string &data) {
-            std::cout << data << std::endl;
-            std::cout << header << std::endl;
-            finalResult = data;
+        std::function<void(const Response &)> onDataReceivedCallback = [&finalResult](const Response &response) {
+            std::cout << response.getBody() << std::endl;
+            std::cout << response.getHeaders() << std::endl;
+            finalResult = response.getBody();
         };
 
 
@@ -61,25 +85,25 @@ namespace TUS::Test::Http {
 
         switch (testCase.method) {
             case HttpMethod::_GET:
-                m_httpClient->get(request);
+                m_httpClient->get(std::move(request));
                 break;
             case HttpMethod::_POST:
-                m_httpClient->post(request);
+                m_httpClient->post(std::move(request));
                 break;
             case HttpMethod::_PUT:
-                m_httpClient->put(request);
+                m_httpClient->put(std::move(request));
                 break;
             case HttpMethod::_PATCH:
-                m_httpClient->patch(request);
+                m_httpClient->patch(std::move(request));
                 break;
             case HttpMethod::_DELETE:
-                m_httpClient->del(request);
+                m_httpClient->del(std::move(request));
                 break;
             case HttpMethod::_HEAD:
-                m_httpClient->head(request);
+                m_httpClient->head(std::move(request));
                 break;
             case HttpMethod::_OPTIONS:
-                m_httpClient->options(request);
+                m_httpClient->options(std::move(request));
                 break;
         }
         m_httpClient->execute();
@@ -103,64 +127,317 @@ namespace TUS::Test::Http {
                              });
 
     TEST_F(HttpClientParameterizedTest, CheckWrongMethod) {
-        const Request request("http://localhost:3000/files", "", HttpMethod::_GET);
-        EXPECT_THROW(m_httpClient->put(request), std::runtime_error);
+        Request request("http://localhost:3000/files", "", HttpMethod::_GET);
+        EXPECT_THROW(m_httpClient->put(std::move(request)), std::runtime_error);
     }
 
     TEST_F(HttpClientParameterizedTest, AbortAll) {
         Request request("http://localhost:3000/files", "", HttpMethod::_GET);
         Request request2("http://localhost:3000/files", "", HttpMethod::_GET);
-        m_httpClient->get(request);
-        m_httpClient->get(request2);
+        m_httpClient->get(std::move(request));
+        m_httpClient->get(std::move(request2));
         m_httpClient->abortAll();
         m_httpClient->execute();
     }
 
     TEST_F(HttpClientParameterizedTest, HttpsRequest) {
         Request request("https://www.google.com", "", HttpMethod::_GET);
-        request.setOnSuccessCallback([](const std::string &header,
-                                            const std::string &data) {
-            std::cout << data << std::endl;
-            std::cout << header << std::endl;
+        request.setOnSuccessCallback([](const Response &response) {
+            std::cout << response.getBody() << std::endl;
+            std::cout << response.getHeaders() << std::endl;
 
-            ASSERT_TRUE(!data.empty());
+            ASSERT_TRUE(!response.getBody().empty());
         });
-        request.setOnErrorCallback([](const std::string &,
-                                          const std::string &) {
+        request.setOnErrorCallback([](const Response &) {
             ASSERT_TRUE(false);
         });
-        m_httpClient->get(request);
+        m_httpClient->get(std::move(request));
         m_httpClient->execute();
     }
 
     TEST_F(HttpClientParameterizedTest, AuthorizedRequestSuccess) {
         Request request("http://localhost:3000/auth/files", "", HttpMethod::_POST);
-        request.setOnSuccessCallback([](const std::string &header,
-                                            const std::string &) {
-            ASSERT_EQ(HttpClient::getHttpReturnCode(header), 200);
+        request.setOnSuccessCallback([](const Response &response) {
+            ASSERT_EQ(response.getStatusCode(), 200);
         });
-        request.setOnErrorCallback([](const std::string &,
-                                          const std::string &) {
+        request.setOnErrorCallback([](const Response &) {
             FAIL();
         });
         m_httpClient->setAuthorization(
             "WAmjPKLlw6287Ky9L8mVSvI0cwEu5gvd1Y0cj9uPioLlR0E6CJqmExeJOgaO6YV5YECMctqSYQPRR6eC9p3hag5rkBdMjA7Z6Y6zQfDofepIuOwdZ820qDpfljB");
-        m_httpClient->post(request);
+        m_httpClient->post(std::move(request));
         m_httpClient->execute();
     }
 
     TEST_F(HttpClientParameterizedTest, AuthorizedRequestFail) {
         Request request("http://localhost:3000/auth/files", "", HttpMethod::_POST);
-        request.setOnSuccessCallback([](const std::string &,
-                                            const std::string &) {
+        request.setOnSuccessCallback([](const Response &) {
             FAIL();
         });
-        request.setOnErrorCallback([](const std::string &header,
-                                          const std::string &) {
-            ASSERT_EQ(HttpClient::getHttpReturnCode(header), 401);
+        request.setOnErrorCallback([](const Response &response) {
+            ASSERT_EQ(response.getStatusCode(), 401);
         });
         m_httpClient->setAuthorization("wrongToken");
-        m_httpClient->post(request);
+        m_httpClient->post(std::move(request));
+        m_httpClient->execute();
+    }
+
+    TEST_F(HttpClientParameterizedTest, MaxConcurrentTransfers) {
+        EXPECT_EQ(m_httpClient->getMaxConcurrentTransfers(), HttpClient::DEFAULT_MAX_CONCURRENT_TRANSFERS);
+        m_httpClient->setMaxConcurrentTransfers(4);
+        EXPECT_EQ(m_httpClient->getMaxConcurrentTransfers(), 4);
+        m_httpClient->setMaxConcurrentTransfers(0);
+        EXPECT_EQ(m_httpClient->getMaxConcurrentTransfers(), 1);
+    }
+
+    TEST_F(HttpClientParameterizedTest, ConcurrentRequestsFromManyThreads) {
+        static constexpr int threadCount = 8;
+        static constexpr int requestsPerThread = 4;
+        std::atomic<int> completed{0};
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back([this, &completed]() {
+                std::atomic<int> ownCompleted{0};
+                for (int j = 0; j < requestsPerThread; ++j) {
+                    Request request("http://localhost:3000/files", "", HttpMethod::_GET);
+                    request.setOnSuccessCallback([&ownCompleted](const Response &response) {
+                        EXPECT_EQ(response.getBody(), "{\"test\":\"get passed\"}");
+                        ++ownCompleted;
+                    });
+                    m_httpClient->get(std::move(request));
+                }
+                m_httpClient->execute();
+                // execute() returns only when the requests of the calling thread are done
+                EXPECT_EQ(ownCompleted.load(), requestsPerThread);
+                completed += ownCompleted.load();
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        EXPECT_EQ(completed.load(), threadCount * requestsPerThread);
+    }
+
+    TEST_F(HttpClientParameterizedTest, AbortByTag) {
+        bool abortedCalled = false;
+        bool keptCalled = false;
+        Request aborted("http://localhost:3000/files", "", HttpMethod::_GET);
+        aborted.setTag("aborted");
+        aborted.setOnSuccessCallback([&abortedCalled](const Response &) {
+            abortedCalled = true;
+        });
+        Request kept("http://localhost:3000/files", "", HttpMethod::_GET);
+        kept.setTag("kept");
+        kept.setOnSuccessCallback([&keptCalled](const Response &) {
+            keptCalled = true;
+        });
+        m_httpClient->get(std::move(aborted));
+        m_httpClient->get(std::move(kept));
+        m_httpClient->abort("aborted");
         m_httpClient->execute();
+        EXPECT_FALSE(abortedCalled);
+        EXPECT_TRUE(keptCalled);
+    }
+
+    /**
+     * @brief Body source that produces its bytes slowly, a transfer takes minutes unless it is aborted
+     */
+    class SlowBodySource : public TUS::Http::IBodySource {
+    public:
+        size_t read(uint64_t, char *buffer, size_t size) override {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            const size_t count = std::min<size_t>(size, 1024);
+            std::memset(buffer, 'x', count);
+            return count;
+        }
+
+        [[nodiscard]] uint64_t size() const override {
+            return 1024 * 1024 * 1024;
+        }
+    };
+
+    TEST_F(HttpClientParameterizedTest, AbortInterruptsTransferInFlight) {
+        bool callbackCalled = false;
+        auto source = std::make_shared<SlowBodySource>();
+        auto progress = std::make_shared<TUS::Http::Progress>();
+        Request request("http://localhost:3000/files", "", HttpMethod::_PATCH);
+        request.setBodySource({source, 0, source->size()});
+        request.setProgress(progress);
+        request.setTag("slow");
+        request.setOnSuccessCallback([&callbackCalled](const Response &) {
+            callbackCalled = true;
+        });
+        request.setOnErrorCallback([&callbackCalled](const Response &) {
+            callbackCalled = true;
+        });
+        m_httpClient->patch(std::move(request));
+
+        std::chrono::steady_clock::time_point abortTime;
+        std::thread aborter([this, &progress, &abortTime]() {
+            // wait until the body is being sent
+            while (progress->getUploadedBytes() == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            abortTime = std::chrono::steady_clock::now();
+            m_httpClient->abort("slow");
+        });
+        m_httpClient->execute();
+        const auto returnTime = std::chrono::steady_clock::now();
+        aborter.join();
+
+        EXPECT_FALSE(callbackCalled);
+        EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(returnTime - abortTime).count(), 100);
+    }
+
+    TEST_F(HttpClientParameterizedTest, ConsecutiveRequestsReuseConnection) {
+        constexpr int requestCount = 5;
+        for (int i = 0; i < requestCount; ++i) {
+            Request request("http://localhost:3000/files", "", HttpMethod::_GET);
+            request.setOnSuccessCallback([](const Response &) {
+            });
+            m_httpClient->get(std::move(request));
+            m_httpClient->execute();
+        }
+        const auto stats = m_httpClient->getConnectionStats();
+        EXPECT_EQ(stats.newConnections, 1);
+        EXPECT_EQ(stats.reusedConnections, requestCount - 1);
+    }
+
+    TEST_F(HttpClientParameterizedTest, StreamedBodyRequest) {
+        const std::string payload = "streamed body sent from a window of a buffer";
+        std::string finalResult;
+        Request request("http://localhost:3000/files", "", HttpMethod::_PATCH);
+        request.setBodySource({std::make_shared<TUS::Http::BufferBodySource>(payload.data(), payload.size()), 9, 4});
+        request.setOnSuccessCallback([&finalResult](const Response &response) {
+            finalResult = response.getBody();
+        });
+        m_httpClient->patch(std::move(request));
+        m_httpClient->execute();
+        EXPECT_EQ(finalResult, "{\"test\":\"patch passed\"}");
+    }
+
+    TEST_F(HttpClientParameterizedTest, UploadProgressIsReported) {
+        const std::string payload(4 * 1024 * 1024, 'x');
+        auto progress = std::make_shared<TUS::Http::Progress>();
+        Request request("http://localhost:3000/files", "", HttpMethod::_PATCH);
+        request.setBodySource(TUS::Http::RequestBody::view(payload.data(), payload.size()));
+        request.setProgress(progress);
+        request.setOnSuccessCallback([](const Response &) {
+        });
+        m_httpClient->patch(std::move(request));
+        m_httpClient->execute();
+        EXPECT_EQ(progress->getUploadedBytes(), payload.size());
+        EXPECT_EQ(progress->getUploadTotal(), payload.size());
+        EXPECT_EQ(progress->getTotalUploadedBytes(), payload.size());
+    }
+
+    TEST_F(HttpClientParameterizedTest, RateLimitedTransferKeepsItsRate) {
+        // blocks of 16 KB at 1 MB/s, the transfer is paused for about 16 ms after each one
+        constexpr uint64_t RATE = 1024 * 1024;
+        const std::string payload(256 * 1024, 'x');
+        auto rateLimiter = std::make_shared<TUS::Http::RateLimiter>();
+        rateLimiter->setRate(RATE, TUS::Http::RateLimiter::MIN_GRANT);
+        Request request("http://localhost:3000/files", "", HttpMethod::_PATCH);
+        request.setBodySource(TUS::Http::RequestBody::view(payload.data(), payload.size()));
+        request.setRateLimiter(rateLimiter);
+        request.setOnSuccessCallback([](const Response &) {
+        });
+        const auto start = std::chrono::steady_clock::now();
+        m_httpClient->patch(std::move(request));
+        m_httpClient->execute();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        EXPECT_EQ(rateLimiter->getAcquiredBytes(), payload.size());
+        const double expected = static_cast<double>(payload.size() - TUS::Http::RateLimiter::MIN_GRANT) / RATE;
+        EXPECT_GE(elapsed.count(), expected * 0.9);
+        // a block waits until its bucket refilled, not for the poll timeout
+        EXPECT_LE(elapsed.count(), expected * 1.5);
+    }
+
+    TEST_F(HttpClientParameterizedTest, UploadSpeedIsMeasuredPerRequest) {
+        constexpr uint64_t RATE = 1024 * 1024;
+        const std::string payload(256 * 1024, 'x');
+        auto rateLimiter = std::make_shared<TUS::Http::RateLimiter>();
+        rateLimiter->setRate(RATE, TUS::Http::RateLimiter::MIN_GRANT);
+        auto progress = std::make_shared<TUS::Http::Progress>();
+        std::vector<double> speeds;
+        for (int i = 0; i < 2; ++i) {
+            if (i > 0) {
+                // the idle time between two requests is not part of the speed of the next one
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+            Request request("http://localhost:3000/files", "", HttpMethod::_PATCH);
+            request.setBodySource(TUS::Http::RequestBody::view(payload.data(), payload.size()));
+            request.setRateLimiter(rateLimiter);
+            request.setProgress(progress);
+            request.setOnSuccessCallback([&speeds](const Response &response) {
+                speeds.push_back(response.getUploadSpeed());
+            });
+            m_httpClient->patch(std::move(request));
+            m_httpClient->execute();
+        }
+
+        ASSERT_EQ(speeds.size(), 2);
+        for (const double speed: speeds) {
+            EXPECT_GE(speed, RATE * 0.5);
+            EXPECT_LE(speed, RATE * 1.5);
+        }
+    }
+
+    TEST_F(HttpClientParameterizedTest, Http1RequestIsNotMultiplexed) {
+        Request request("http://localhost:3000/files", "", HttpMethod::_GET);
+        request.setOnSuccessCallback([](const Response &) {
+        });
+        EXPECT_EQ(m_httpClient->getNegotiatedHttpVersion(), TUS::Http::HttpVersion::_NONE);
+        m_httpClient->get(std::move(request));
+        m_httpClient->execute();
+        EXPECT_EQ(m_httpClient->getNegotiatedHttpVersion(), TUS::Http::HttpVersion::_HTTP_1_1);
+        EXPECT_EQ(m_httpClient->getConnectionStats().http2Requests, 0);
+    }
+
+    TEST_F(HttpClientParameterizedTest, Http2RequestsAreMultiplexed) {
+        if (const std::string reason = h2cSkipReason(); !reason.empty()) {
+            GTEST_SKIP() << reason;
+        }
+        static constexpr int requestCount = 8;
+        int completed = 0;
+        m_httpClient->setHttpVersion(TUS::Http::HttpVersion::_HTTP_2_PRIOR_KNOWLEDGE);
+        for (int i = 0; i < requestCount; ++i) {
+            Request request(H2C_URL, "", HttpMethod::_PATCH);
+            request.setOnSuccessCallback([&completed](const Response &response) {
+                EXPECT_EQ(response.getBody(), "{\"test\":\"patch passed\"}");
+                ++completed;
+            });
+            m_httpClient->patch(std::move(request));
+        }
+        m_httpClient->execute();
+
+        EXPECT_EQ(completed, requestCount);
+        EXPECT_EQ(m_httpClient->getNegotiatedHttpVersion(), TUS::Http::HttpVersion::_HTTP_2);
+        const auto stats = m_httpClient->getConnectionStats();
+        EXPECT_EQ(stats.http2Requests, requestCount);
+        EXPECT_EQ(stats.newConnections, 1);
+    }
+
+    TEST_F(HttpClientParameterizedTest, Http2StreamLimitOpensNewConnections) {
+        if (const std::string reason = h2cSkipReason(); !reason.empty()) {
+            GTEST_SKIP() << reason;
+        }
+        static constexpr int requestCount = 4;
+        m_httpClient->setHttpVersion(TUS::Http::HttpVersion::_HTTP_2_PRIOR_KNOWLEDGE);
+        m_httpClient->setMaxConcurrentStreams(1);
+        EXPECT_EQ(m_httpClient->getMaxConcurrentStreams(), 1);
+        for (int i = 0; i < requestCount; ++i) {
+            Request request(H2C_URL, "", HttpMethod::_GET);
+            request.setOnSuccessCallback([](const Response &) {
+            });
+            m_httpClient->get(std::move(request));
+        }
+        m_httpClient->execute();
+
+        const auto stats = m_httpClient->getConnectionStats();
+        EXPECT_EQ(stats.http2Requests, requestCount);
+        EXPECT_GT(stats.newConnections, 1);
     }
 } // namespace TUS::Test::Http
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "http/Progress.h"
+
+namespace TUS::Test::Http {
+    using TUS::Http::Progress;
+
+    TEST(ProgressTest, UpdateAndReset) {
+        Progress progress;
+        progress.update(10, 100, 2, 20);
+        EXPECT_EQ(progress.getUploadedBytes(), 10);
+        EXPECT_EQ(progress.getUploadTotal(), 100);
+        EXPECT_EQ(progress.getDownloadedBytes(), 2);
+        EXPECT_EQ(progress.getDownloadTotal(), 20);
+
+        progress.addUploadedBytes(10);
+        progress.reset();
+        EXPECT_EQ(progress.getUploadedBytes(), 0);
+        EXPECT_EQ(progress.getUploadTotal(), 0);
+        // the total survives the end of the request
+        EXPECT_EQ(progress.getTotalUploadedBytes(), 10);
+    }
+
+    TEST(ProgressTest, SpeedIsSampled) {
+        Progress progress;
+        progress.addUploadedBytes(0);
+        EXPECT_EQ(progress.getUploadSpeed(), 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(Progress::SPEED_SAMPLE_INTERVAL_MS + 50));
+        progress.addUploadedBytes(1024 * 1024);
+        const double speed = progress.getUploadSpeed();
+        EXPECT_GT(speed, 0);
+        // 1 MB in a bit more than the sample interval
+        EXPECT_LT(speed, 1024.0 * 1024 * 1000 / Progress::SPEED_SAMPLE_INTERVAL_MS);
+
+        // a stalled transfer reports no bytes, the speed decays
+        std::this_thread::sleep_for(std::chrono::milliseconds(Progress::SPEED_SAMPLE_INTERVAL_MS + 50));
+        progress.addUploadedBytes(0);
+        EXPECT_LT(progress.getUploadSpeed(), speed);
+    }
+
+    TEST(ProgressTest, ConcurrentUpdatesAreCounted) {
+        static constexpr int threadCount = 8;
+        static constexpr int updates = 10000;
+        Progress progress;
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&progress]() {
+                for (int j = 0; j < updates; ++j) {
+                    progress.addUploadedBytes(1);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        EXPECT_EQ(progress.getTotalUploadedBytes(), threadCount * updates);
+    }
+} // namespace TUS::Test::Http
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "http/RateLimiter.h"
+
+namespace TUS::Test::Http {
+    using TUS::Http::RateLimiter;
+
+    TEST(RateLimiterTest, UnlimitedBucketGrantsEverything) {
+        RateLimiter limiter;
+        EXPECT_EQ(limiter.getRate(), RateLimiter::UNLIMITED);
+        EXPECT_EQ(limiter.acquire(1024 * 1024), 1024 * 1024);
+        EXPECT_EQ(limiter.getDelay(1024 * 1024), std::chrono::nanoseconds(0));
+        EXPECT_EQ(limiter.getAcquiredBytes(), 1024 * 1024);
+    }
+
+    TEST(RateLimiterTest, BucketRefillsAtItsRate) {
+        RateLimiter limiter(1024 * 1024);
+        limiter.setRate(1024 * 1024, 64 * 1024);
+        // a full bucket grants its burst at once
+        EXPECT_EQ(limiter.acquire(1024 * 1024), 64 * 1024);
+        const auto delay = limiter.getDelay(1024 * 1024);
+        EXPECT_GT(delay, std::chrono::milliseconds(10));
+        EXPECT_LE(delay, std::chrono::milliseconds(16));
+
+        std::this_thread::sleep_for(delay);
+        EXPECT_GE(limiter.acquire(1024 * 1024), RateLimiter::MIN_GRANT);
+        limiter.release(1024);
+        EXPECT_LT(limiter.getAcquiredBytes(), 64 * 1024 + 1024 * 1024);
+    }
+
+    TEST(RateLimiterTest, ConcurrentTransfersShareTheRate) {
+        constexpr uint64_t RATE = 2 * 1024 * 1024;
+        constexpr uint64_t BURST = 64 * 1024;
+        constexpr uint64_t TOTAL = 1024 * 1024;
+        RateLimiter limiter;
+        limiter.setRate(RATE, BURST);
+        std::atomic<uint64_t> sent{0};
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> transfers;
+        for (int i = 0; i < 4; ++i) {
+            transfers.emplace_back([&limiter, &sent] {
+                while (sent.load() < TOTAL) {
+                    const size_t granted = limiter.acquire(8 * 1024);
+                    if (granted == 0) {
+                        std::this_thread::sleep_for(limiter.getDelay(8 * 1024));
+                        continue;
+                    }
+                    sent += granted;
+                }
+            });
+        }
+        for (auto &transfer: transfers) {
+            transfer.join();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        EXPECT_EQ(limiter.getAcquiredBytes(), sent.load());
+        // the burst is sent at once, the rest at the rate of the bucket
+        const double expected = static_cast<double>(sent.load() - BURST) / RATE;
+        EXPECT_GE(elapsed.count(), expected * 0.9);
+        EXPECT_LE(elapsed.count(), expected * 3);
+    }
+
+    TEST(RateLimiterTest, ChildIsLimitedByItsParent) {
+        const auto parent = std::make_shared<RateLimiter>();
+        parent->setRate(1024 * 1024, 32 * 1024);
+        RateLimiter first(RateLimiter::UNLIMITED, parent);
+        RateLimiter second(10 * 1024 * 1024, parent);
+        EXPECT_EQ(first.getParent(), parent);
+
+        EXPECT_EQ(first.acquire(1024 * 1024), 32 * 1024);
+        // the bucket of the parent is shared, it is empty for the other child too
+        EXPECT_EQ(second.acquire(RateLimiter::MIN_GRANT), 0);
+        EXPECT_GT(second.getDelay(RateLimiter::MIN_GRANT), std::chrono::milliseconds(10));
+        EXPECT_EQ(parent->getAcquiredBytes(), 32 * 1024);
+        EXPECT_EQ(second.getAcquiredBytes(), 0);
+    }
+
+    TEST(RateLimiterTest, RateCanChangeAtRuntime) {
+        RateLimiter limiter(64 * 1024);
+        EXPECT_EQ(limiter.getBurst(), RateLimiter::MIN_GRANT);
+        EXPECT_EQ(limiter.acquire(1024 * 1024), RateLimiter::MIN_GRANT);
+        EXPECT_EQ(limiter.acquire(RateLimiter::MIN_GRANT), 0);
+
+        limiter.setRate(RateLimiter::UNLIMITED);
+        EXPECT_EQ(limiter.acquire(1024 * 1024), 1024 * 1024);
+
+        limiter.setRate(10 * 1024 * 1024);
+        EXPECT_EQ(limiter.getRate(), 10 * 1024 * 1024);
+        EXPECT_EQ(limiter.getBurst(), 1024 * 1024);
+    }
+
+    TEST(RateLimiterTest, HostsShareTheGlobalBucket) {
+        const auto host = RateLimiter::forHost("http://localhost:8080/files/");
+        EXPECT_EQ(host, RateLimiter::forHost("http://localhost:8080/other/"));
+        EXPECT_NE(host, RateLimiter::forHost("http://localhost:8081/files/"));
+        EXPECT_EQ(host->getParent(), RateLimiter::global());
+        EXPECT_EQ(RateLimiter::global()->getParent(), nullptr);
+    }
+
+    TEST(RateLimiterTest, HostBucketLivesWhileItIsHeld) {
+        const std::string url = "http://localhost:9090/files/";
+        std::weak_ptr<RateLimiter> dropped;
+        {
+            auto host = RateLimiter::forHost(url);
+            host->setRate(64 * 1024);
+            // a client uploading to the host holds its bucket as parent
+            const RateLimiter client(RateLimiter::UNLIMITED, RateLimiter::forHost(url));
+            host.reset();
+            EXPECT_EQ(RateLimiter::forHost(url)->getRate(), 64 * 1024);
+            dropped = client.getParent();
+        }
+        // once nothing holds it, the host starts again without limit
+        EXPECT_TRUE(dropped.expired());
+        EXPECT_EQ(RateLimiter::forHost(url)->getRate(), RateLimiter::UNLIMITED);
+    }
+
+    TEST(RateLimiterTest, UnlimitedChainCountsTheBytes) {
+        const auto parent = std::make_shared<RateLimiter>();
+        RateLimiter child(RateLimiter::UNLIMITED, parent);
+        EXPECT_EQ(child.acquire(1024 * 1024), 1024 * 1024);
+        child.release(1024);
+        EXPECT_EQ(child.getAcquiredBytes(), 1024 * 1024 - 1024);
+        EXPECT_EQ(parent->getAcquiredBytes(), 1024 * 1024 - 1024);
+
+        // a limit set on the parent applies to the next bytes of the child
+        parent->setRate(1024 * 1024, 32 * 1024);
+        EXPECT_EQ(child.acquire(1024 * 1024), 32 * 1024);
+        EXPECT_GT(child.getDelay(RateLimiter::MIN_GRANT), std::chrono::nanoseconds(0));
+    }
+} // namespace TUS::Test::Http
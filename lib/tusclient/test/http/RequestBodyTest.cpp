@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "http/RequestBody.h"
+
+namespace TUS::Test::Http {
+    using TUS::Http::BufferBodySource;
+    using TUS::Http::FileBodySource;
+
+    TEST(RequestBodyTest, BufferSourceReadsFromOffset) {
+        const std::string data = "0123456789";
+        BufferBodySource source(data.data(), data.size());
+        EXPECT_EQ(source.size(), data.size());
+
+        char buffer[4] = {};
+        EXPECT_EQ(source.read(3, buffer, sizeof(buffer)), 4);
+        EXPECT_EQ(std::string(buffer, 4), "3456");
+        EXPECT_EQ(source.read(8, buffer, sizeof(buffer)), 2);
+        EXPECT_EQ(std::string(buffer, 2), "89");
+        EXPECT_EQ(source.read(10, buffer, sizeof(buffer)), 0);
+    }
+
+    TEST(RequestBodyTest, FileSourceReadsFromOffset) {
+        const auto filePath = std::filesystem::temp_directory_path() / "request_body.bin";
+        {
+            std::ofstream file(filePath, std::ios::binary);
+            file << "abcdefghijklmnopqrstuvwxyz";
+        }
+        {
+            FileBodySource source(filePath);
+            EXPECT_EQ(source.size(), 26);
+
+            char buffer[5] = {};
+            EXPECT_EQ(source.read(20, buffer, sizeof(buffer)), 5);
+            EXPECT_EQ(std::string(buffer, 5), "uvwxy");
+            EXPECT_EQ(source.read(0, buffer, 3), 3);
+            EXPECT_EQ(std::string(buffer, 3), "abc");
+            EXPECT_EQ(source.read(24, buffer, sizeof(buffer)), 2);
+            EXPECT_EQ(std::string(buffer, 2), "yz");
+        }
+        std::filesystem::remove(filePath);
+    }
+} // namespace TUS::Test::Http
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+#include "http/HeaderList.h"
+#include "http/Request.h"
+
+namespace TUS::Test::Http {
+    using TUS::Http::HeaderList;
+    using TUS::Http::HttpMethod;
+    using TUS::Http::Request;
+    using TUS::Http::RequestBody;
+    using TUS::Http::Response;
+
+    TEST(RequestTest, HeaderListReplacesCaseInsensitively) {
+        HeaderList headers{{"Tus-Resumable", "1.0.0"}, {"Upload-Offset", "0"}};
+        headers.set("upload-offset", "42");
+        EXPECT_EQ(headers.size(), 2);
+        EXPECT_EQ(headers.get("Upload-Offset"), "42");
+        EXPECT_EQ(headers.get("TUS-RESUMABLE"), "1.0.0");
+        EXPECT_TRUE(headers.get("Location").empty());
+        EXPECT_FALSE(headers.contains("Location"));
+        // the order of insertion is kept
+        EXPECT_EQ(headers.begin()->first, "Tus-Resumable");
+    }
+
+    TEST(RequestTest, DefaultContentTypeIsNotDuplicated) {
+        const Request json("http://localhost:3000/files", "", HttpMethod::_GET);
+        EXPECT_EQ(json.getHeaders().get("Content-Type"), "application/json");
+
+        const Request patch("http://localhost:3000/files", "", HttpMethod::_PATCH,
+                            {{"content-type", "application/offset+octet-stream"}});
+        EXPECT_EQ(patch.getHeaders().size(), 1);
+        EXPECT_EQ(patch.getHeaders().get("Content-Type"), "application/offset+octet-stream");
+    }
+
+    TEST(RequestTest, RequestIsMoveOnly) {
+        static_assert(!std::is_copy_constructible_v<Request>);
+        static_assert(std::is_nothrow_move_constructible_v<Request>);
+
+        bool called = false;
+        Request request("http://localhost:3000/files", "{\"data\":[1,2,3,4,5]}", HttpMethod::_POST);
+        request.setTag("upload");
+        request.setOnSuccessCallback([&called](const Response &) {
+            called = true;
+        });
+        const char *body = request.getBody().data();
+
+        const Request moved(std::move(request));
+        EXPECT_EQ(moved.getUrl(), "http://localhost:3000/files");
+        EXPECT_EQ(moved.getBody(), "{\"data\":[1,2,3,4,5]}");
+        EXPECT_EQ(moved.getTag(), "upload");
+        // the body buffer is handed over, not copied
+        EXPECT_EQ(moved.getBody().data(), body);
+        moved.getOnSuccessCallback()(Response());
+        EXPECT_TRUE(called);
+    }
+
+    TEST(RequestTest, BodyViewBorrowsTheMemory) {
+        const std::string payload = "0123456789";
+        Request request("http://localhost:3000/files", "", HttpMethod::_PATCH);
+        EXPECT_FALSE(request.hasBodySource());
+        request.setBodySource(RequestBody::view(payload.data(), payload.size()));
+        EXPECT_TRUE(request.hasBodySource());
+        EXPECT_EQ(request.getBodySource().source, nullptr);
+        EXPECT_EQ(request.getBodySource().data, payload.data());
+        EXPECT_EQ(request.getBodySource().length, payload.size());
+    }
+} // namespace TUS::Test::Http
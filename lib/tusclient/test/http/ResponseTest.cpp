@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <gtest/gtest.h>
+#include "http/HttpClient.h"
+#include "http/Response.h"
+
+namespace TUS::Test::Http {
+    using TUS::Http::HttpClient;
+    using TUS::Http::Response;
+
+    static constexpr auto PATCH_HEADERS =
+            "HTTP/1.1 204 No Content\r\n"
+            "Tus-Resumable: 1.0.0\r\n"
+            "upload-offset:  5368709120 \r\n"
+            "Content-Length: 0\r\n"
+            "\r\n";
+
+    TEST(ResponseTest, ParseUploadHeaders) {
+        const Response response(PATCH_HEADERS);
+        EXPECT_EQ(response.getStatusCode(), 204);
+        EXPECT_EQ(response.getUploadOffset(), 5368709120);
+        EXPECT_FALSE(response.getUploadLength().has_value());
+        EXPECT_EQ(response.getTusResumable(), "1.0.0");
+        EXPECT_EQ(response.getHeader("content-length"), "0");
+        EXPECT_EQ(response.getHeader("Location"), "");
+    }
+
+    TEST(ResponseTest, ParseHeaderLinesAsReceived) {
+        Response response;
+        response.parseHeaderLine("HTTP/2 201\r\n");
+        response.parseHeaderLine("location: http://localhost:8080/files/abc\r\n");
+        response.parseHeaderLine("upload-length: 42\r\n");
+        response.parseHeaderLine("Upload-Defer-Length: 1\r\n");
+        response.parseHeaderLine("\r\n");
+        response.appendBody("{}", 2);
+
+        EXPECT_EQ(response.getStatusCode(), 201);
+        EXPECT_EQ(response.getLocation(), "http://localhost:8080/files/abc");
+        EXPECT_EQ(response.getUploadLength(), 42);
+        EXPECT_TRUE(response.isUploadLengthDeferred());
+        EXPECT_EQ(response.getBody(), "{}");
+    }
+
+    TEST(ResponseTest, ParseServerCapabilities) {
+        const Response response("HTTP/1.1 204 No Content\r\n"
+                                "Tus-Version: 1.0.0,0.2.2\r\n"
+                                "Tus-Extension: creation, creation-with-upload,termination\r\n"
+                                "Tus-Max-Size: 1073741824\r\n\r\n");
+        EXPECT_EQ(response.getTusVersion(), "1.0.0,0.2.2");
+        EXPECT_EQ(response.getTusMaxSize(), 1073741824);
+        EXPECT_TRUE(response.supportsExtension("creation"));
+        EXPECT_TRUE(response.supportsExtension("creation-with-upload"));
+        EXPECT_TRUE(response.supportsExtension("termination"));
+        EXPECT_FALSE(response.supportsExtension("concatenation"));
+        EXPECT_FALSE(response.supportsExtension("creation-with"));
+    }
+
+    TEST(ResponseTest, ParseUploadExpires) {
+        const Response response("HTTP/1.1 204 No Content\r\n"
+                                "Upload-Expires: Wed, 25 Jun 2014 16:00:00 GMT\r\n\r\n");
+        ASSERT_TRUE(response.getUploadExpires().has_value());
+        EXPECT_EQ(std::chrono::system_clock::to_time_t(*response.getUploadExpires()), 1403712000);
+        EXPECT_FALSE(Response(PATCH_HEADERS).getUploadExpires().has_value());
+        EXPECT_FALSE(Response("HTTP/1.1 204 No Content\r\n"
+                              "Upload-Expires: tomorrow\r\n\r\n").getUploadExpires().has_value());
+    }
+
+    TEST(ResponseTest, InformationalResponseIsDiscarded) {
+        const Response response("HTTP/1.1 100 Continue\r\n\r\n"
+                                "HTTP/1.1 409 Conflict\r\n"
+                                "Upload-Offset: 10\r\n\r\n");
+        EXPECT_EQ(response.getStatusCode(), 409);
+        EXPECT_EQ(response.getUploadOffset(), 10);
+        EXPECT_EQ(response.getHeaders().find("100 Continue"), std::string_view::npos);
+    }
+
+    TEST(ResponseTest, InvalidNumbersAreMissing) {
+        const Response response("HTTP/1.1 200 OK\r\n"
+                                "Upload-Offset: 12abc\r\n"
+                                "Upload-Length: -1\r\n\r\n");
+        EXPECT_FALSE(response.getUploadOffset().has_value());
+        EXPECT_FALSE(response.getUploadLength().has_value());
+    }
+
+    TEST(ResponseTest, StatusCodeFromCurlWins) {
+        const Response response(PATCH_HEADERS, "", 409);
+        EXPECT_EQ(response.getStatusCode(), 409);
+    }
+
+    TEST(ResponseTest, UploadSpeedOfTheRequest) {
+        Response response(PATCH_HEADERS);
+        EXPECT_EQ(response.getUploadSpeed(), 0);
+        response.setUploadStats(512 * 1024, std::chrono::milliseconds(500));
+        EXPECT_DOUBLE_EQ(response.getUploadSpeed(), 1024 * 1024);
+        response.setUploadStats(512 * 1024, std::chrono::microseconds(0));
+        EXPECT_EQ(response.getUploadSpeed(), 0);
+    }
+
+    TEST(ResponseTest, ParseStatusLine) {
+        EXPECT_EQ(Response::parseStatusLine("HTTP/1.0 200 OK\r\n"), 200);
+        EXPECT_EQ(Response::parseStatusLine("HTTP/2 404\r\n"), 404);
+        EXPECT_EQ(Response::parseStatusLine("HTTP/3 201 \r\n"), 201);
+        EXPECT_EQ(Response::parseStatusLine("Upload-Offset: 10\r\n"), -1);
+        EXPECT_EQ(Response::parseStatusLine("HTTP/1.1 20\r\n"), -1);
+        EXPECT_EQ(HttpClient::getHttpReturnCode(PATCH_HEADERS), 204);
+        EXPECT_EQ(HttpClient::getHttpReturnCode("HTTP/1.1 100 Continue\r\n\r\nHTTP/2 500\r\n"), 500);
+        EXPECT_EQ(HttpClient::getHttpReturnCode(""), -1);
+    }
+} // namespace TUS::Test::Http
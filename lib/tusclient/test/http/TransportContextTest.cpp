@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2024 Matteo Cadoni
+ * This file is part of libtusclient, licensed under the MIT License.
+ * See the LICENSE file in the project root for more information.
+ */
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "http/HttpClient.h"
+#include "http/Request.h"
+#include "http/TransportContext.h"
+
+namespace TUS::Test::Http {
+    using TUS::Http::HttpClient;
+    using TUS::Http::HttpMethod;
+    using TUS::Http::Request;
+    using TUS::Http::Response;
+    using TUS::Http::TransportContext;
+
+    static Request createGetRequest(Request::SuccessCallback onSuccess) {
+        Request request("http://localhost:3000/files", "", HttpMethod::_GET);
+        request.setOnSuccessCallback(std::move(onSuccess));
+        return request;
+    }
+
+    TEST(TransportContextTest, ClientsShareTheConnections) {
+        auto context = std::make_shared<TransportContext>();
+        HttpClient first(nullptr, context);
+        HttpClient second(nullptr, context);
+        EXPECT_EQ(first.getTransportContext(), context);
+
+        first.get(createGetRequest([](const Response &) {
+        }));
+        first.execute();
+        second.get(createGetRequest([](const Response &) {
+        }));
+        second.execute();
+
+        const auto stats = context->getConnectionStats();
+        EXPECT_EQ(stats.newConnections, 1);
+        EXPECT_EQ(stats.reusedConnections, 1);
+    }
+
+    TEST(TransportContextTest, ClientsWithoutContextDoNotShare) {
+        HttpClient first;
+        HttpClient second;
+        EXPECT_NE(first.getTransportContext(), second.getTransportContext());
+
+        first.get(createGetRequest([](const Response &) {
+        }));
+        first.execute();
+        second.get(createGetRequest([](const Response &) {
+        }));
+        second.execute();
+
+        EXPECT_EQ(first.getConnectionStats().newConnections, 1);
+        EXPECT_EQ(second.getConnectionStats().newConnections, 1);
+    }
+
+    TEST(TransportContextTest, AbortOnlyAffectsTheClient) {
+        auto context = std::make_shared<TransportContext>();
+        HttpClient first(nullptr, context);
+        HttpClient second(nullptr, context);
+        bool firstCalled = false;
+        bool secondCalled = false;
+
+        first.get(createGetRequest([&firstCalled](const Response &) {
+            firstCalled = true;
+        }));
+        second.get(createGetRequest([&secondCalled](const Response &) {
+            secondCalled = true;
+        }));
+        first.abortAll();
+        first.execute();
+        EXPECT_FALSE(secondCalled);
+        second.execute();
+
+        EXPECT_FALSE(firstCalled);
+        EXPECT_TRUE(secondCalled);
+    }
+
+    TEST(TransportContextTest, DestroyedClientIsDetached) {
+        auto context = std::make_shared<TransportContext>();
+        auto first = std::make_unique<HttpClient>(nullptr, context);
+        HttpClient second(nullptr, context);
+        bool secondCalled = false;
+
+        first->get(createGetRequest([](const Response &) {
+            FAIL() << "the request of a destroyed client must not complete";
+        }));
+        first.reset();
+        second.get(createGetRequest([&secondCalled](const Response &) {
+            secondCalled = true;
+        }));
+        second.execute();
+
+        EXPECT_TRUE(secondCalled);
+    }
+
+    TEST(TransportContextTest, ConcurrentClientsOnManyThreads) {
+        static constexpr int threadCount = 4;
+        static constexpr int requestsPerThread = 5;
+        auto context = std::make_shared<TransportContext>();
+        std::atomic<int> completed = 0;
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&context, &completed]() {
+                HttpClient client(nullptr, context);
+                for (int j = 0; j < requestsPerThread; ++j) {
+                    client.get(createGetRequest([&completed](const Response &) {
+                        ++completed;
+                    }));
+                }
+                client.execute();
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+
+        EXPECT_EQ(completed, threadCount * requestsPerThread);
+        const auto stats = context->getConnectionStats();
+        EXPECT_EQ(stats.newConnections + stats.reusedConnections, threadCount * requestsPerThread);
+    }
+} // namespace TUS::Test::Http
@@ -6,6 +6,9 @@
 
 #include <gtest/gtest.h>
 #include <fstream>
+#include <thread>
+#include <vector>
+#include <fmt/core.h>
 #include <boost/uuid/uuid_io.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -91,3 +94,74 @@ TEST_F(CacheRepositoryTest, saveAndOpen) {
     EXPECT_EQ(result.size(), 1);
     EXPECT_EQ(result[0]->getIdentificationHash(), file->getIdentificationHash());
 }
+
+TEST_F(CacheRepositoryTest, largeOffsetsAreSaved) {
+    auto file = std::make_shared<TUSFile>(m_filePath, "http://localhost:1080/upload", "test-app",
+                                          m_uuid, "1234567890e39484");
+    // past 4 GiB, e.g. a resumed upload of several terabytes
+    const int64_t offset = 5'000'000'000'000 - 12345;
+    file->setUploadOffset(offset);
+    file->setResumeFrom(offset);
+    cacheRepository->add(file);
+    cacheRepository->save();
+    cacheRepository->open();
+
+    auto result = cacheRepository->findByHash(file->getIdentificationHash());
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(result->getUploadOffset(), offset);
+    EXPECT_EQ(result->getResumeFrom(), offset);
+}
+
+TEST_F(CacheRepositoryTest, partialsAreSaved) {
+    auto file = std::make_shared<TUSFile>(m_filePath, "http://localhost:1080/upload", "test-app",
+                                          m_uuid, "1234567890e39484");
+    file->setPartials({
+        {0, 5'000'000'000, 5'000'000'000, "http://localhost:1080/upload/a"},
+        {5'000'000'000, 2'000'000, 12345, "http://localhost:1080/upload/b"}
+    });
+    cacheRepository->add(file);
+    cacheRepository->save();
+    cacheRepository->open();
+
+    auto result = cacheRepository->findByHash(file->getIdentificationHash());
+    ASSERT_NE(result, nullptr);
+    const auto partials = result->getPartials();
+    ASSERT_EQ(partials.size(), 2);
+    EXPECT_EQ(partials[0].length, 5'000'000'000);
+    EXPECT_EQ(partials[0].uploadOffset, 5'000'000'000);
+    EXPECT_EQ(partials[1].start, 5'000'000'000);
+    EXPECT_EQ(partials[1].uploadOffset, 12345);
+    EXPECT_EQ(partials[1].tusIdentifier, "http://localhost:1080/upload/b");
+}
+
+TEST_F(CacheRepositoryTest, addReplacesTheRecordOfTheFile) {
+    auto file = std::make_shared<TUSFile>(m_filePath, "http://localhost:1080/upload", "test-app",
+                                          m_uuid, "1234567890e39484");
+    cacheRepository->add(file);
+    file->setUploadOffset(1024);
+    cacheRepository->add(file);
+
+    auto result = cacheRepository->findAll();
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0]->getUploadOffset(), 1024);
+}
+
+TEST_F(CacheRepositoryTest, concurrentAdds) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([this, i] {
+            for (int j = 0; j < 50; ++j) {
+                auto file = std::make_shared<TUSFile>(m_filePath, fmt::format("http://localhost:1080/{}/{}", i, j),
+                                                      "test-app", boost::uuids::random_generator()());
+                cacheRepository->add(file);
+                cacheRepository->save();
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(cacheRepository->findAll().size(), 400);
+    cacheRepository->open();
+    EXPECT_EQ(cacheRepository->findAll().size(), 400);
+}